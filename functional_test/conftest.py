@@ -67,6 +67,28 @@ def screen_text(screen: pyte.Screen) -> str:
     return "\n".join(screen_rows(screen))
 
 
+def screen_dump(child: pexpect.spawn, path, colors: bool = False):
+    """Read the screen through ``newt ScreenDump`` instead of a pty render.
+
+    Writes the rows to *path* (and the colour runs to *path*.colors), then
+    waits for a completion marker — no drain timeout is involved.  Returns
+    the list of rows, or ``(rows, colors)`` with *colors*.
+    """
+    child.sendline(
+        f"newt ScreenDump __dump __colors; "
+        f"printf '%s\\n' \"${{__dump[@]}}\" > '{path}'; "
+        f"printf '%s\\n' \"${{__colors[@]}}\" > '{path}.colors'; "
+        f"printf 'DUMP%s\\n' -DONE".encode()
+    )
+    child.expect(b"DUMP-DONE", timeout=5)
+
+    def lines(p):
+        return pathlib.Path(p).read_text(encoding="utf-8").split("\n")[:-1]
+
+    rows = lines(path)
+    return (rows, lines(f"{path}.colors")) if colors else rows
+
+
 # ---------------------------------------------------------------------------
 # Fixtures
 # ---------------------------------------------------------------------------
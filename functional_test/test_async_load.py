@@ -0,0 +1,99 @@
+"""Functional tests for background loads (``newt AsyncLoad``, ``AsyncLoadWait``)."""
+
+import time
+
+from conftest import render, screen_rows, screen_text
+
+
+def test_async_load_fills_running_form(bash_newt):
+    """Rows and text appear while the form is already running."""
+    bash_newt.sendline(
+        b"seq 1 200000 | sed 's/^/line /' > /tmp/_async_rows.txt; "
+        b"printf 'async text\\n' > /tmp/_async_text.txt; "
+        b"newt Init && newt Cls && "
+        b'newt OpenWindow 5 3 50 15 "Async" && '
+        b'newt -v lb Listbox 1 1 6 0 && '
+        b'newt -v tb Textbox 1 8 30 2 0 && '
+        b'newt AsyncLoad "$lb" /tmp/_async_rows.txt && '
+        b'newt AsyncLoad "$tb" /tmp/_async_text.txt && '
+        b'newt -v f Form "" "" 0 && '
+        b'newt FormAddComponents "$f" "$lb" "$tb" && '
+        b'newt RunForm "$f" && '
+        b'newt -v n ListboxItemCount "$lb" && '
+        b'newt FormDestroy "$f" && '
+        b"newt Finished; "
+        b'echo "n=[$n]"'
+    )
+    time.sleep(1.0)
+    screen = render(bash_newt, initial_timeout=2.0)
+    rows = screen_rows(screen)
+    full = screen_text(screen)
+    assert any("line 1" in r for r in rows), f"Listbox rows not loaded.\n{full}"
+    assert any("async text" in r for r in rows), f"Textbox text not loaded.\n{full}"
+
+    bash_newt.send(b"\n")
+    time.sleep(0.5)
+    screen = render(bash_newt, initial_timeout=1.5, drain_timeout=0.3)
+    assert any("n=[200000]" in r for r in screen_rows(screen)), screen_text(screen)
+
+
+def test_async_load_wait_directory_and_errors(bash_newt):
+    """AsyncLoadWait installs a directory listing; unreadable paths fail."""
+    bash_newt.sendline(
+        b"rm -rf /tmp/_async_dir && mkdir -p /tmp/_async_dir/sub && "
+        b"touch /tmp/_async_dir/b /tmp/_async_dir/a; "
+        b"newt Init && "
+        b'newt -v lb Listbox 1 1 6 0 && '
+        b'newt AsyncLoad "$lb" /tmp/_async_dir && newt AsyncLoadWait "$lb" && '
+        b'newt -v n ListboxItemCount "$lb" && '
+        b'newt ListboxGetEntry "$lb" 2 text data && '
+        b'newt AsyncLoad "$lb" /tmp/_async_missing; newt AsyncLoadWait "$lb"; rc=$?; '
+        b'newt -v m ListboxItemCount "$lb"; '
+        b"newt Finished; "
+        b'echo "n=[$n] text=[$text] data=[$data] rc=[$rc] m=[$m]"'
+    )
+    time.sleep(0.5)
+    screen = render(bash_newt, initial_timeout=1.5, drain_timeout=0.3)
+    assert any("n=[3] text=[sub/] data=[3] rc=[1] m=[3]" in r
+               for r in screen_rows(screen)), screen_text(screen)
+
+
+def test_async_load_refuses_other_widgets(bash_newt):
+    """Only listboxes and textboxes can be loaded."""
+    bash_newt.sendline(
+        b"printf 'x\\n' > /tmp/_async_text.txt; "
+        b"newt Init && "
+        b'newt -v e Entry 1 1 "keep" 20 && '
+        b'newt -v s Scale 1 2 20 100 && '
+        b'newt AsyncLoad "$e" /tmp/_async_text.txt 2>/dev/null; re=$?; '
+        b'newt AsyncLoad "$s" /tmp/_async_text.txt 2>/dev/null; rs=$?; '
+        b'newt -v v EntryGetValue "$e"; '
+        b"newt Finished; "
+        b'echo "re=[$re] rs=[$rs] v=[$v]"'
+    )
+    time.sleep(0.5)
+    screen = render(bash_newt, initial_timeout=1.5, drain_timeout=0.3)
+    assert any("re=[1] rs=[1] v=[keep]" in r for r in screen_rows(screen)), \
+        screen_text(screen)
+
+
+def test_async_load_waits_for_its_form(bash_newt):
+    """A dialog's run does not fill a listbox of the form underneath."""
+    bash_newt.sendline(
+        b"printf 'a\\nb\\nc\\n' > /tmp/_async_rows3.txt; "
+        b"newt Init && newt Cls && "
+        b'newt -v lb Listbox 1 1 4 0 && '
+        b'newt -v f Form "" "" 0 && newt FormAddComponent "$f" "$lb" && '
+        b'newt AsyncLoad "$lb" /tmp/_async_rows3.txt && '
+        b'newt -v d Form "" "" 0 && newt FormSetTimer "$d" 300 && '
+        b'newt FormRun "$d" R V && '
+        b'newt -v before ListboxItemCount "$lb" && '
+        b'newt FormSetTimer "$f" 100 && newt FormRun "$f" R V && '
+        b'newt -v after ListboxItemCount "$lb" && '
+        b'newt FormDestroy "$d"; newt FormDestroy "$f"; newt Finished; '
+        b'echo "before=[$before] after=[$after]"'
+    )
+    time.sleep(1.2)
+    screen = render(bash_newt, initial_timeout=1.5, drain_timeout=0.3)
+    assert any("before=[0] after=[3]" in r for r in screen_rows(screen)), \
+        screen_text(screen)
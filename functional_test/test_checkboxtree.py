@@ -190,3 +190,51 @@ def test_checkboxtree_finditem(bash_newt):
     idx_lines = [r for r in rows if "idxs=[" in r]
     assert idx_lines and "idxs=[]" not in idx_lines[0], \
         f"CheckboxTreeFindItem returned empty list.\n{full}"
+
+
+def test_checkboxtree_load_paths(bash_newt):
+    """CheckboxTreeLoad should build the tree and map data keys to paths."""
+    bash_newt.sendline(
+        b"newt Init && newt Cls && "
+        b'newt -v ct CheckboxTree 3 2 10 0 && '
+        b"paths=(usr/lib/libfoo usr/lib/libbar usr/bin/tool etc/conf) && "
+        b'newt -v keys CheckboxTreeLoad "$ct" paths && '
+        b'newt -v f Form "" "" 0 && '
+        b'newt FormAddComponents "$f" "$ct" && '
+        b'newt DrawForm "$f" && newt Refresh && sleep 0.5 && '
+        b'newt FormDestroy "$f" && '
+        b'newt Finished && '
+        b'echo "n=[${#keys[@]}] k3=[${keys[3]}] k7=[${keys[7]}]"'
+    )
+    time.sleep(1.0)
+    screen = render(bash_newt, initial_timeout=1.5, drain_timeout=0.3)
+    rows = screen_rows(screen)
+    full = screen_text(screen)
+
+    assert any("n=[7] k3=[usr/lib/libfoo] k7=[etc/conf]" in r for r in rows), \
+        f"CheckboxTreeLoad key mapping unexpected.\n{full}"
+
+
+def test_checkboxtree_entry_values_bulk(bash_newt):
+    """CheckboxTreeSetEntryValues / GetEntryValues should round-trip by path and key."""
+    bash_newt.sendline(
+        b"newt Init && newt Cls && "
+        b'newt -v ct CheckboxTreeMulti 3 2 10 " ab" 0 && '
+        b"paths=(usr/lib/libfoo usr/bin/tool etc/conf) && "
+        b'newt CheckboxTreeLoad "$ct" paths && '
+        b"declare -A want=([usr/lib/libfoo]=a [6]=b) && "
+        b'newt CheckboxTreeSetEntryValues "$ct" want && '
+        b'newt CheckboxTreeGetEntryValues "$ct" got && '
+        b'newt -v i CheckboxTreeFindItem "$ct" 5 && '
+        b"declare -A bad=([no/such]=a) && "
+        b'{ newt CheckboxTreeSetEntryValues "$ct" bad 2>/dev/null; rc=$?; } ; '
+        b'newt Finished ; '
+        b'echo "v=[${got[3]}${got[6]}${got[4]}] n=[${#got[@]}] i=[$i] rc=[$rc]"'
+    )
+    time.sleep(0.5)
+    screen = render(bash_newt, initial_timeout=1.5, drain_timeout=0.3)
+    rows = screen_rows(screen)
+    full = screen_text(screen)
+
+    assert any("v=[ab ] n=[7] i=[0 1 0] rc=[1]" in r for r in rows), \
+        f"Bulk checkbox tree values unexpected.\n{full}"
@@ -202,3 +202,45 @@ def test_arrays_are_readonly(bash_newt):
     assert any("readonly" in r.lower() for r in rows), (
         f"Expected 'readonly variable' error message.\n{full}"
     )
+
+
+# ─── symbolic integer arguments ───────────────────────────────────────────────
+
+def test_symbolic_flags_accepted_as_arguments(bash_newt):
+    """'SCROLL|RETURNEXIT' and KEY:F12 are valid integer arguments."""
+    bash_newt.sendline(
+        b"newt -v lb Listbox 1 1 5 'SCROLL|RETURNEXIT'; echo \"SYM_RC=$?\""
+    )
+    bash_newt.sendline(b"newt -v f Form; newt FormAddHotKey \"$f\" KEY:F12;"
+                       b" echo \"HOT_RC=$?\"")
+    time.sleep(0.3)
+    screen = render(bash_newt, initial_timeout=0.8, drain_timeout=0.2)
+    rows = screen_rows(screen)
+    full = screen_text(screen)
+    assert any("SYM_RC=0" in r for r in rows), full
+    assert any("HOT_RC=0" in r for r in rows), full
+
+
+def test_unknown_symbol_is_usage_error(bash_newt):
+    bash_newt.sendline(b'newt Listbox 1 1 5 SCROL; echo "BAD_RC=$?"')
+    time.sleep(0.3)
+    screen = render(bash_newt, initial_timeout=0.8, drain_timeout=0.2)
+    rows = screen_rows(screen)
+    full = screen_text(screen)
+    assert any("BAD_RC=1" in r for r in rows), full
+
+
+# ─── unloading ────────────────────────────────────────────────────────────────
+
+def test_arrays_survive_unload(bash_newt):
+    """Arrays never referenced before ``enable -d newt`` still read back.
+
+    Their first-reference hook lives in the module, so the unload hook fills
+    them before the module goes away.
+    """
+    bash_newt.sendline(b'enable -d newt; echo "AFTER_UNLOAD=${NEWT_FLAG[SCROLL]}"')
+    time.sleep(0.3)
+    screen = render(bash_newt, initial_timeout=0.8, drain_timeout=0.2)
+    rows = screen_rows(screen)
+    full = screen_text(screen)
+    assert any("AFTER_UNLOAD=4" in r for r in rows), full
@@ -1,6 +1,6 @@
 """Functional tests for ``newt Entry`` widget and related commands.
 
-Covers: Entry, EntryGetValue, EntrySet, EntrySetFlags.
+Covers: Entry, EntryGetValue, EntrySet, EntrySetFlags, EntrySetNativeFilter.
 """
 
 import time
@@ -180,3 +180,79 @@ def test_entry_set_filter_blocks_digits(bash_newt):
     assert any("val=[abc]" in r for r in rows2), \
         f"EntrySetFilter should have blocked digits; expected 'abc'.\n{full2}"
 
+
+
+def test_entry_native_filter_digits_max(bash_newt):
+    """EntrySetNativeFilter should keep digits only, up to the maximum length."""
+    bash_newt.sendline(
+        b"newt Init && newt Cls && "
+        b'newt OpenWindow 5 3 50 10 "NativeFilter" && '
+        b'newt -v e Entry 3 2 "" 30 && '
+        b'newt EntrySetNativeFilter "$e" digits,max:4 && '
+        b'newt -v h Entry 3 3 "" 30 && '
+        b'newt EntrySetNativeFilter "$h" hostname,lower && '
+        b'newt -v _ok Button 3 5 "OK" && '
+        b'newt -v f Form "" "" 0 && '
+        b'newt FormAddComponents "$f" "$e" "$h" "$_ok" && '
+        b'newt RunForm "$f"; '
+        b'newt -v val EntryGetValue "$e"; newt -v host EntryGetValue "$h"; '
+        b'newt FormDestroy "$f"; newt Finished; echo "val=[$val] host=[$host]"'
+    )
+    render(bash_newt, initial_timeout=2.0)
+    bash_newt.send(b"a1b2 c3d456")
+    time.sleep(0.2)
+    bash_newt.send(b"\t")
+    bash_newt.send(b"My_Host.Example")
+    time.sleep(0.2)
+    bash_newt.send(b"\t")
+    time.sleep(0.1)
+    bash_newt.send(b"\r")
+    time.sleep(0.5)
+    screen = render(bash_newt, initial_timeout=1.5, drain_timeout=0.3)
+    assert any("val=[1234] host=[myhost.example]" in r for r in screen_rows(screen)), \
+        screen_text(screen)
+
+
+def test_entry_native_filter_bad_spec(bash_newt):
+    """An unknown spec item is reported and nothing is installed."""
+    bash_newt.sendline(
+        b"newt Init && newt -v e Entry 3 2 \"\" 30 && "
+        b'newt EntrySetNativeFilter "$e" digits,nope; rc=$?; '
+        b'newt Finished; echo "rc=[$rc]"'
+    )
+    time.sleep(0.5)
+    screen = render(bash_newt, initial_timeout=1.5, drain_timeout=0.3)
+    full = screen_text(screen)
+    assert "bad spec item 'nope'" in full, full
+    assert any("rc=[1]" in r for r in screen_rows(screen)), full
+
+
+def test_entry_set_filter_paste_function(bash_newt):
+    """A burst of buffered keys goes to the paste function once, not key by key."""
+    bash_newt.sendline(
+        b"newt Init && newt Cls && "
+        b'newt OpenWindow 5 3 60 10 "PasteTest" && '
+        b'keys=0; pastes=0; '
+        b'count_key() { keys=$((keys + 1)); return 0; } && '
+        b'on_paste() { pastes=$((pastes + 1)); NEWT_PASTE=${NEWT_PASTE^^}; } && '
+        b'newt -v e Entry 3 2 "" 50 ${NEWT_FLAG[SCROLL]} && '
+        b'newt EntrySetNativeFilter "$e" alnum && '
+        b'newt EntrySetFilter "$e" count_key on_paste && '
+        b'newt -v _ok Button 3 5 "OK" && '
+        b'newt -v f Form "" "" 0 && '
+        b'newt FormAddComponents "$f" "$e" "$_ok" && '
+        b'newt RunForm "$f"; '
+        b'newt -v val EntryGetValue "$e"; newt FormDestroy "$f"; newt Finished; '
+        b'echo "len=[${#val}] head=[${val:0:7}] keys=[$keys] pastes=[$pastes]"'
+    )
+    render(bash_newt, initial_timeout=2.0)
+    bash_newt.send(b"x")
+    time.sleep(0.2)
+    bash_newt.send(b"abc-def_" * 40 + b"\t")
+    time.sleep(0.5)
+    bash_newt.send(b"\r")
+    time.sleep(0.5)
+    screen = render(bash_newt, initial_timeout=1.5, drain_timeout=0.3)
+    full = screen_text(screen)
+    assert any("len=[241] head=[xABCDEF] keys=[1] pastes=[1]" in r
+               for r in screen_rows(screen)), full
@@ -0,0 +1,51 @@
+"""Functional tests for queued callback events.
+
+Covers: EventsSetQueued, EventsDrain, and the CALLBACKS reason of FormRun.
+"""
+
+import time
+
+from conftest import render, screen_rows, screen_text
+
+
+def test_queued_callback_returns_from_formrun(bash_newt):
+    """A queued callback is not evaluated; FormRun returns CALLBACKS instead."""
+    bash_newt.sendline(
+        b"newt Init && newt Cls && "
+        b'newt OpenWindow 10 5 40 10 "Queued" && '
+        b"newt EventsSetQueued 1 && "
+        b'newt -v cb Checkbox 3 2 "Toggle me" && '
+        b"newt ComponentAddCallback \"$cb\" 'CB_FIRED=1' mydata && "
+        b'newt -v f Form "" "" 0 && '
+        b'newt FormAddComponents "$f" "$cb" && '
+        b'newt FormRun "$f" REASON VALUE && '
+        b'newt -v n EventsDrain ev && '
+        b'read -r type co data <<< "${ev[0]}"; '
+        b'newt FormDestroy "$f"; newt Finished; newt EventsSetQueued 0; '
+        b'echo "R=$REASON/$VALUE n=$n type=$type data=$data same=$([[ $co == "$cb" ]] && echo y) '
+        b'fired=${CB_FIRED:-0}"'
+    )
+    render(bash_newt, initial_timeout=2.0)
+    bash_newt.send(b" ")
+    time.sleep(0.8)
+    screen = render(bash_newt, initial_timeout=1.5, drain_timeout=0.3)
+    assert any("R=CALLBACKS/1 n=1 type=CALLBACK data=mydata same=y fired=0" in r
+               for r in screen_rows(screen)), screen_text(screen)
+
+
+def test_queued_destroy_callback(bash_newt):
+    """Destroy callbacks are queued too, and drained in order."""
+    bash_newt.sendline(
+        b"newt Init && newt EventsSetQueued 1 && "
+        b'newt -v a Label 1 1 "a" && newt -v b Label 1 2 "b" && '
+        b"newt ComponentAddDestroyCallback \"$a\" 'GONE=1' && "
+        b"newt ComponentAddDestroyCallback \"$b\" 'GONE=1' && "
+        b'newt -v f Form && newt FormAddComponents "$f" "$a" "$b" && '
+        b'newt FormDestroy "$f" && newt EventsDrain ev && newt EventsDrain again; '
+        b'newt Finished; newt EventsSetQueued 0; '
+        b'echo "n=${#ev[@]} first=${ev[0]%% *} left=${#again[@]} gone=${GONE:-0}"'
+    )
+    time.sleep(0.5)
+    screen = render(bash_newt, initial_timeout=1.5, drain_timeout=0.3)
+    assert any("n=2 first=DESTROY left=0 gone=0" in r
+               for r in screen_rows(screen)), screen_text(screen)
@@ -0,0 +1,74 @@
+"""Functional tests for ``newt FilePicker`` and related commands.
+
+Covers: FilePicker (constructor), FilePickerGetSelection, FilePickerGetCurrent.
+"""
+
+import time
+from conftest import render, screen_rows, screen_text
+
+_TREE = (
+    b"rm -rf /tmp/_fp && mkdir -p /tmp/_fp/docs /tmp/_fp/src/lib && "
+    b"touch /tmp/_fp/README /tmp/_fp/src/main.c; "
+)
+
+
+def test_file_picker_lists_root(bash_newt):
+    """The root's directories come first, each with a trailing slash."""
+    bash_newt.sendline(
+        _TREE +
+        b"newt Init && newt Cls && "
+        b'newt OpenWindow 2 2 50 14 "Files" && '
+        b'newt -v f Form && '
+        b'newt -v fp FilePicker "$f" 1 1 40 10 /tmp/_fp/ && '
+        b'newt RunForm "$f"; '
+        b'newt FormDestroy "$f"; newt Finished'
+    )
+    screen = render(bash_newt, initial_timeout=2.0)
+    rows = screen_rows(screen)
+    full = screen_text(screen)
+    docs = next((i for i, r in enumerate(rows) if "docs/" in r), None)
+    readme = next((i for i, r in enumerate(rows) if "README" in r), None)
+    assert docs is not None and readme is not None, full
+    assert docs < readme, full
+    assert not any("main.c" in r for r in rows), f"Subtree shown too early.\n{full}"
+    bash_newt.send(b"\x1b[24~")
+
+
+def test_file_picker_expands_directory(bash_newt):
+    """Expanding a directory fills in its entries while the form runs."""
+    bash_newt.sendline(
+        _TREE +
+        b"newt Init && newt Cls && "
+        b'newt OpenWindow 2 2 50 14 "Files" && '
+        b'newt -v f Form && '
+        b'newt -v fp FilePicker "$f" 1 1 40 10 /tmp/_fp && '
+        b'newt RunForm "$f"; '
+        b'newt FormDestroy "$f"; newt Finished'
+    )
+    render(bash_newt, initial_timeout=2.0)
+    bash_newt.send(b"\x1b[B\x1b[B ")               # Down to src/, expand
+    time.sleep(0.8)
+    screen = render(bash_newt, initial_timeout=1.0, drain_timeout=0.3)
+    rows = screen_rows(screen)
+    assert any("main.c" in r for r in rows), screen_text(screen)
+    assert any("lib/" in r for r in rows), screen_text(screen)
+    bash_newt.send(b"\x1b[24~")
+
+
+def test_file_picker_selection_paths(bash_newt):
+    """Selected "." nodes come back as directory paths with a slash."""
+    bash_newt.sendline(
+        _TREE +
+        b"newt Init && "
+        b'newt -v f Form && '
+        b'newt -v fp FilePicker "$f" 1 1 40 10 /tmp/_fp && '
+        b"newt CheckboxTreeSetEntryValue \"$fp\" 1 '*' && "
+        b'newt FilePickerGetSelection "$fp" picked && '
+        b'newt -v cur FilePickerGetCurrent "$fp" && '
+        b'newt FormDestroy "$f"; newt Finished; '
+        b'echo "picked=[${picked[*]}] cur=[$cur]"'
+    )
+    time.sleep(0.5)
+    screen = render(bash_newt, initial_timeout=1.5, drain_timeout=0.3)
+    assert any("picked=[/tmp/_fp/] cur=[/tmp/_fp/]" in r
+               for r in screen_rows(screen)), screen_text(screen)
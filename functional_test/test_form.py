@@ -2,12 +2,17 @@
 
 Covers:
     FormRun       – hand-written wrapper that exposes newtExitStruct fields
+    FormPoll      – FormRun with a bounded wait, reporting TIMEOUT
     FormWatchFd   – registers a file-descriptor watch on a running form
     FormSetTimer  – sets a millisecond timer that fires while the form runs
     DrawForm      – renders the form without entering the event loop
     ComponentGetPosition – queries a component's absolute screen position
     ComponentGetSize     – queries a component's screen dimensions
     ComponentAddCallback – registers a bash function as a component callback
+    FormCollect   – reads every value component of a form into an assoc array
+    FormSnapshot / FormRestore – save and reapply a form's field values
+    FormGetChanged – lists the fields edited during the last run
+    EntrySetValidator / FormValidate – regex rules checked in one call
 """
 
 import time
@@ -42,6 +47,68 @@ def test_formrun_timer_exit(bash_newt):
     )
 
 
+# ─── FormPoll: timeout and events ─────────────────────────────────────────────
+
+def test_formpoll_times_out_then_sees_key(bash_newt):
+    """FormPoll returns TIMEOUT while idle and COMPONENT once Enter is pressed."""
+    bash_newt.sendline(
+        b"newt Init && newt Cls && "
+        b'newt OpenWindow 10 5 40 6 "FormPoll" && '
+        b'newt -v btn Button 3 1 "OK" && '
+        b'newt -v f Form "" "" 0 && '
+        b'newt FormAddComponent "$f" "$btn" && '
+        b"n=0; while newt FormPoll \"$f\" 50 REASON VALUE && "
+        b'[[ $REASON == TIMEOUT ]]; do n=$((n+1)); done; '
+        b'newt FormDestroy "$f"; newt Finished; '
+        b'echo "REASON=$REASON polls=$((n > 3))"'
+    )
+    render(bash_newt, initial_timeout=2.0)
+    time.sleep(0.5)
+    bash_newt.send(b"\r")
+    time.sleep(0.8)
+    screen = render(bash_newt, initial_timeout=1.0, drain_timeout=0.3)
+    assert any("REASON=COMPONENT polls=1" in r for r in screen_rows(screen)), \
+        screen_text(screen)
+
+
+def test_formpoll_restores_form_timer(bash_newt):
+    """After FormPoll, the FormSetTimer interval applies to FormRun again."""
+    bash_newt.sendline(
+        b"newt Init && "
+        b'newt -v lbl Label 3 1 "waiting..." && '
+        b'newt -v f Form "" "" 0 && '
+        b'newt FormAddComponent "$f" "$lbl" && '
+        b'newt FormSetTimer "$f" 300 && '
+        b'newt FormPoll "$f" 0 R1 V1 && '
+        b'newt FormRun "$f" R2 V2 && '
+        b'newt FormDestroy "$f" && newt Finished && '
+        b'echo "R1=$R1 R2=$R2"'
+    )
+    time.sleep(1.2)
+    screen = render(bash_newt, initial_timeout=1.0, drain_timeout=0.3)
+    assert any("R1=TIMEOUT R2=TIMER" in r for r in screen_rows(screen)), \
+        screen_text(screen)
+
+
+def test_formpoll_reports_form_timer(bash_newt):
+    """A FormSetTimer timer fires as TIMER inside a FormPoll loop."""
+    bash_newt.sendline(
+        b"newt Init && "
+        b'newt -v lbl Label 3 1 "waiting..." && '
+        b'newt -v f Form "" "" 0 && '
+        b'newt FormAddComponent "$f" "$lbl" && '
+        b'newt FormSetTimer "$f" 200 && '
+        b"n=0; while newt FormPoll \"$f\" 50 REASON VALUE && "
+        b'[[ $REASON == TIMEOUT ]]; do n=$((n+1)); done; '
+        b'newt FormDestroy "$f"; newt Finished; '
+        b'echo "REASON=$REASON polls=$((n >= 2 && n <= 5))"'
+    )
+    time.sleep(1.2)
+    screen = render(bash_newt, initial_timeout=1.0, drain_timeout=0.3)
+    assert any("REASON=TIMER polls=1" in r for r in screen_rows(screen)), \
+        screen_text(screen)
+
+
 # ─── FormRun: component (button) exit ────────────────────────────────────────
 
 def test_formrun_component_exit(bash_newt):
@@ -319,3 +386,172 @@ def test_form_setcurrent_getcurrent(bash_newt):
 
     assert any("match" in r for r in rows), \
         f"FormGetCurrent should return btn2 after FormSetCurrent.\n{full}"
+
+
+# ─── FormCollect ──────────────────────────────────────────────────────────────
+
+def test_formcollect_values(bash_newt):
+    """FormCollect should read entries, checkboxes, radio groups, listboxes and scales."""
+    bash_newt.sendline(
+        b"newt Init && newt Cls && "
+        b'newt -v e Entry 1 1 "hello" 20 && '
+        b'newt -v c Checkbox 1 2 "Opt" "*" && '
+        b'newt -v r1 Radiobutton 1 3 "A" 0 "" && '
+        b'newt -v r2 Radiobutton 1 4 "B" 1 "$r1" && '
+        b'newt -v lb Listbox 1 5 3 0 && '
+        b'newt ListboxAppendEntry "$lb" "x" 7 && '
+        b'newt -v sc Scale 1 9 20 100 && newt ScaleSet "$sc" 40 && '
+        b'newt ComponentSetId "$e" name && newt ComponentSetId "$r1" mode && '
+        b'newt ComponentSetId "$r2" fast && newt ComponentSetId "$lb" pick && '
+        b'newt -v f Form "" "" 0 && '
+        b'newt FormAddComponents "$f" "$e" "$c" "$r1" "$r2" "$lb" "$sc" && '
+        b'newt FormCollect "$f" vals && '
+        b'newt FormDestroy "$f" && newt Finished && '
+        b'echo "n=[${#vals[@]}] e=[${vals[name]}] c=[${vals[$c]}] r=[${vals[mode]}]'
+        b' l=[${vals[pick]}] s=[${vals[$sc]}]"'
+    )
+    time.sleep(0.5)
+    screen = render(bash_newt, initial_timeout=1.5, drain_timeout=0.3)
+    rows = screen_rows(screen)
+    full = screen_text(screen)
+
+    assert any("n=[5] e=[hello] c=[*] r=[fast] l=[7] s=[40]" in r for r in rows), \
+        f"FormCollect values unexpected.\n{full}"
+
+
+# ─── FormSnapshot / FormRestore ───────────────────────────────────────────────
+
+def test_formsnapshot_restore(bash_newt):
+    """FormRestore should bring back values saved by FormSnapshot."""
+    bash_newt.sendline(
+        b"newt Init && newt Cls && "
+        b'newt -v e Entry 1 1 "first" 20 && '
+        b'newt -v c Checkbox 1 2 "Opt" " " && '
+        b'newt -v r1 Radiobutton 1 3 "A" 1 "" && '
+        b'newt -v r2 Radiobutton 1 4 "B" 0 "$r1" && '
+        b'newt -v f Form "" "" 0 && '
+        b'newt FormAddComponents "$f" "$e" "$c" "$r1" "$r2" && '
+        b'newt FormSnapshot "$f" snap && '
+        b'newt EntrySet "$e" "changed" 1 && newt CheckboxSetValue "$c" "*" && '
+        b'newt RadioSetCurrent "$r2" && '
+        b'newt FormRestore "$f" snap && '
+        b'newt -v ev EntryGetValue "$e" && newt -v cv CheckboxGetValue "$c" && '
+        b'newt -v rv RadioGetCurrent "$r1" && '
+        b'bad="newt-snapshot 1" && { newt FormRestore "$f" bad 2>/dev/null; rc=$?; } ; '
+        b'newt FormDestroy "$f" ; newt Finished ; '
+        b'[[ $rv == "$r1" ]] && r=ok || r=no; '
+        b'echo "e=[$ev] c=[$cv] r=[$r] rc=[$rc]"'
+    )
+    time.sleep(0.5)
+    screen = render(bash_newt, initial_timeout=1.5, drain_timeout=0.3)
+    rows = screen_rows(screen)
+    full = screen_text(screen)
+
+    assert any("e=[first] c=[ ] r=[ok] rc=[1]" in r for r in rows), \
+        f"FormRestore did not restore the snapshot.\n{full}"
+
+
+def test_formrestore_focus_in_rebuilt_form(bash_newt):
+    """The focused field is restored by position, also into a rebuilt form."""
+    bash_newt.sendline(
+        b"newt Init && newt Cls && "
+        b'newt -v e1 Entry 1 1 "one" 20 && newt -v e2 Entry 1 2 "two" 20 && '
+        b'newt -v f Form "" "" 0 && '
+        b'newt FormAddComponents "$f" "$e1" "$e2" && '
+        b'newt FormSetCurrent "$f" "$e2" && '
+        b'newt FormSnapshot "$f" snap && '
+        b'newt FormDestroy "$f" && '
+        b'newt -v g1 Entry 1 1 "" 20 && newt -v g2 Entry 1 2 "" 20 && '
+        b'newt -v g Form "" "" 0 && '
+        b'newt FormAddComponents "$g" "$g1" "$g2" && '
+        b'newt FormRestore "$g" snap && '
+        b'newt -v cur FormGetCurrent "$g" && newt -v v2 EntryGetValue "$g2" && '
+        b'newt FormDestroy "$g" ; newt Finished ; '
+        b'[[ $cur == "$g2" ]] && r=ok || r=no; '
+        b'echo "focus=[$r] v2=[$v2]"'
+    )
+    time.sleep(0.5)
+    rows = screen_rows(render(bash_newt, initial_timeout=1.5, drain_timeout=0.3))
+    assert any("focus=[ok] v2=[two]" in r for r in rows), "\n".join(rows)
+
+
+# ─── FormGetChanged ───────────────────────────────────────────────────────────
+
+def test_formgetchanged_reports_edited_entry(bash_newt):
+    """Only the entry typed into should be reported as changed."""
+    bash_newt.sendline(
+        b"newt Init && newt Cls && "
+        b'newt OpenWindow 10 5 40 6 "Changed" && '
+        b'newt -v e1 Entry 1 1 "one" 20 && '
+        b'newt -v e2 Entry 1 2 "two" 20 && '
+        b'newt -v c Checkbox 1 3 "Opt" && '
+        b'newt ComponentSetId "$e1" first && newt ComponentSetId "$e2" second && '
+        b'newt -v f Form "" "" 0 && '
+        b'newt FormAddComponents "$f" "$e1" "$e2" "$c" && '
+        b'newt FormAddHotKey "$f" 32880 && '
+        b'newt FormRun "$f" REASON VALUE && '
+        b'newt FormGetChanged "$f" ch && '
+        b'newt FormDestroy "$f" && newt Finished && '
+        b'echo "changed=[${ch[*]}]"'
+    )
+    screen = render(bash_newt, initial_timeout=2.0)
+    full = screen_text(screen)
+    assert "Changed" in full, f"Form window did not appear.\n{full}"
+
+    # Move to the second entry, type into it, then leave with F12.
+    bash_newt.send(b"\t")
+    time.sleep(0.2)
+    bash_newt.send(b"X")
+    time.sleep(0.2)
+    bash_newt.send(b"\x1b[24~")
+    time.sleep(0.8)
+    screen = render(bash_newt, initial_timeout=1.0, drain_timeout=0.3)
+    rows = screen_rows(screen)
+    full = screen_text(screen)
+
+    assert any("changed=[second]" in r for r in rows), \
+        f"FormGetChanged should list only the edited entry.\n{full}"
+
+
+# ─── EntrySetValidator / FormValidate ─────────────────────────────────────────
+
+def test_formvalidate_reports_and_focuses_failures(bash_newt):
+    """FormValidate lists failing entries in form order and focuses the first."""
+    bash_newt.sendline(
+        b"newt Init && "
+        b'newt -v e1 Entry 1 1 "8080" 20 && '
+        b'newt -v e2 Entry 1 2 "nope" 20 && '
+        b'newt -v e3 Entry 1 3 "x@y" 20 && '
+        b'newt -v e4 Entry 1 4 "12a" 20 && '
+        b'newt ComponentSetId "$e2" mail && newt ComponentSetId "$e4" port2 && '
+        b"newt EntrySetValidator \"$e1\" '^[0-9]+$' && "
+        b"newt EntrySetValidator \"$e2\" '@' 'need an at sign' && "
+        b"newt EntrySetValidator \"$e3\" '@' && "
+        b"newt EntrySetValidator \"$e4\" '^[0-9]+$' && "
+        b'newt -v f Form && newt FormAddComponents "$f" "$e1" "$e2" "$e3" "$e4" && '
+        b'newt -v n FormValidate "$f" bad msgs; rc=$?; '
+        b'newt -v cur FormGetCurrent "$f"; '
+        b'newt EntrySet "$e2" "a@b" 0; newt EntrySet "$e4" 7 0; '
+        b'newt FormValidate "$f" bad2; rc2=$?; '
+        b'newt FormDestroy "$f"; newt Finished; '
+        b'echo "rc=$rc n=$n bad=[${bad[*]}] msg0=[${msgs[0]}] '
+        b'focus=$([[ $cur == "$e2" ]] && echo y) rc2=$rc2 left=${#bad2[@]}"'
+    )
+    time.sleep(0.5)
+    screen = render(bash_newt, initial_timeout=1.5, drain_timeout=0.3)
+    assert any("rc=1 n=2 bad=[mail port2] msg0=[need an at sign] focus=y rc2=0 left=0" in r
+               for r in screen_rows(screen)), screen_text(screen)
+
+
+def test_entrysetvalidator_rejects_bad_regex(bash_newt):
+    """A regex that does not compile is reported when it is set."""
+    bash_newt.sendline(
+        b"newt Init && newt -v e Entry 1 1 \"\" 20 && "
+        b"newt EntrySetValidator \"$e\" '(' ; rc=$?; "
+        b'newt Finished; echo "rc=[$rc]"'
+    )
+    time.sleep(0.5)
+    screen = render(bash_newt, initial_timeout=1.5, drain_timeout=0.3)
+    full = screen_text(screen)
+    assert "EntrySetValidator: (:" in full, full
+    assert any("rc=[1]" in r for r in screen_rows(screen)), full
@@ -0,0 +1,118 @@
+"""Functional tests for ``newt FuzzyPicker`` and related commands.
+
+Covers: FuzzyPicker (constructor), FuzzyPickerSetRows, FuzzyPickerLoadFile,
+FuzzyPickerGetCurrent, FuzzyPickerGetRow, FuzzyPickerMatchCount.
+"""
+
+import time
+from conftest import render, screen_rows, screen_text
+
+
+def _pick(bash_newt, setup: bytes, load: bytes, keys: bytes) -> list[str]:
+    """Run a picker, type *keys*, press Enter and return the echoed output."""
+    bash_newt.sendline(
+        setup +
+        b"newt Init && newt Cls && "
+        b'newt OpenWindow 2 2 70 18 "Pick" && '
+        b'newt -v f Form && '
+        b'newt -v fp FuzzyPicker "$f" 1 1 66 14 20 && '
+        + load + b" && "
+        b'newt RunForm "$f"; '
+        b'newt -v idx FuzzyPickerGetCurrent "$fp"; '
+        b'newt -v row FuzzyPickerGetRow "$fp" "$idx"; '
+        b'newt -v n FuzzyPickerMatchCount "$fp"; '
+        b'newt FormDestroy "$f"; '
+        b"newt Finished; "
+        b'echo "row=[$row] n=[$n]"'
+    )
+    render(bash_newt, initial_timeout=2.0)
+    bash_newt.send(keys)
+    time.sleep(1.0)
+    bash_newt.send(b"\r")
+    time.sleep(0.5)
+    return screen_rows(render(bash_newt, initial_timeout=1.5, drain_timeout=0.3))
+
+
+def test_fuzzy_picker_small_list(bash_newt):
+    """Fuzzy query over a small array picks the best match."""
+    rows = _pick(
+        bash_newt,
+        b"cands=(libfoo-dev foo-utils bar baz fzf-tool); ",
+        b'newt FuzzyPickerSetRows "$fp" cands',
+        b"fzt",
+    )
+    assert any("row=[fzf-tool] n=[1]" in r for r in rows), "\n".join(rows)
+
+
+def test_fuzzy_picker_large_file(bash_newt):
+    """Background scoring of a large candidate file delivers results."""
+    rows = _pick(
+        bash_newt,
+        b"seq -f 'item-%06g' 0 199999 > /tmp/_fzp_rows.txt; ",
+        b'newt FuzzyPickerLoadFile "$fp" /tmp/_fzp_rows.txt',
+        b"123456",
+    )
+    assert any("row=[item-123456]" in r for r in rows), "\n".join(rows)
+
+
+def test_fuzzy_picker_arrows_keep_focus_on_entry(bash_newt):
+    """Down moves through the results; typing afterwards still edits the query."""
+    bash_newt.sendline(
+        b"cands=(apple apricot avocado banana); "
+        b"newt Init && newt Cls && "
+        b'newt OpenWindow 2 2 70 18 "Pick" && '
+        b'newt -v f Form && '
+        b'newt -v fp FuzzyPicker "$f" 1 1 66 14 && '
+        b'newt FuzzyPickerSetRows "$fp" cands && '
+        b'newt RunForm "$f"; '
+        b'newt -v q FuzzyPickerGetQuery "$fp"; '
+        b'newt -v n FuzzyPickerMatchCount "$fp"; '
+        b'newt FormDestroy "$f"; '
+        b"newt Finished; "
+        b'echo "q=[$q] n=[$n]"'
+    )
+    render(bash_newt, initial_timeout=2.0)
+    bash_newt.send(b"a")
+    time.sleep(0.3)
+    bash_newt.send(b"\x1b[B")
+    time.sleep(0.3)
+    bash_newt.send(b"p")
+    time.sleep(0.5)
+    bash_newt.send(b"\r")
+    time.sleep(0.5)
+    rows = screen_rows(render(bash_newt, initial_timeout=1.5, drain_timeout=0.3))
+    assert any("q=[ap] n=[2]" in r for r in rows), "\n".join(rows)
+
+
+def test_fuzzy_picker_arrows_reach_other_listbox(bash_newt):
+    """With another listbox focused, Down moves that listbox, not the results."""
+    bash_newt.sendline(
+        b"cands=(apple apricot avocado banana); "
+        b"newt Init && newt Cls && "
+        b'newt OpenWindow 2 2 70 20 "Pick" && '
+        b'newt -v f Form && '
+        b'newt -v fp FuzzyPicker "$f" 1 1 66 10 && '
+        b'newt FuzzyPickerSetRows "$fp" cands && '
+        b'newt -v lb Listbox 1 12 3 0 && '
+        b'newt ListboxAppendEntry "$lb" one 1 && '
+        b'newt ListboxAppendEntry "$lb" two 2 && '
+        b'newt ListboxAppendEntry "$lb" three 3 && '
+        b'newt FormAddComponent "$f" "$lb" && '
+        b'newt RunForm "$f"; '
+        b'newt -v idx FuzzyPickerGetCurrent "$fp"; '
+        b'newt -v cur ListboxGetCurrent "$lb"; '
+        b'newt FormDestroy "$f"; '
+        b"newt Finished; "
+        b'echo "idx=[$idx] cur=[$cur]"'
+    )
+    render(bash_newt, initial_timeout=2.0)
+    bash_newt.send(b"\t\t")                   # entry → results → other listbox
+    time.sleep(0.3)
+    bash_newt.send(b"\x1b[B")
+    time.sleep(0.2)
+    bash_newt.send(b"\x1b[B")
+    time.sleep(0.3)
+    bash_newt.send(b"\x1b[24~")
+    time.sleep(0.5)
+    rows = screen_rows(render(bash_newt, initial_timeout=1.5, drain_timeout=0.3))
+    assert any("idx=[0] cur=[3]" in r for r in rows), "\n".join(rows)
@@ -316,3 +316,29 @@ def test_listbox_setcurrentbykey(bash_newt):
 
     assert any("cur=[2]" in r for r in rows), \
         f"ListboxSetCurrentByKey did not select key 2 (expected cur=[2]).\n{full}"
+
+
+# ─── ListboxSort ──────────────────────────────────────────────────────────────
+
+def test_listbox_sort_natural_keeps_current(bash_newt):
+    """ListboxSort textNumeric should reorder rows and keep the current key."""
+    bash_newt.sendline(
+        b"newt Init && newt Cls && "
+        b'newt -v lb Listbox 3 1 8 0 && '
+        b'newt ListboxAddEntry "$lb" "host10" 10 && '
+        b'newt ListboxAddEntry "$lb" "host2"  2 && '
+        b'newt ListboxAddEntry "$lb" "host1"  1 && '
+        b'newt ListboxSetCurrentByKey "$lb" 2 && '
+        b'newt ListboxSort "$lb" textNumeric && '
+        b'newt ListboxGetEntry "$lb" 0 t0 d0 && '
+        b'newt -v cur ListboxGetCurrent "$lb" && '
+        b'newt Finished && '
+        b'echo "cur=[$cur] t0=[$t0]"'
+    )
+    time.sleep(0.5)
+    screen = render(bash_newt, initial_timeout=1.5, drain_timeout=0.3)
+    rows = screen_rows(screen)
+    full = screen_text(screen)
+
+    assert any("cur=[2] t0=[host1]" in r for r in rows), \
+        f"ListboxSort did not sort naturally or lost the current item.\n{full}"
@@ -0,0 +1,45 @@
+"""Functional tests for ``newt ListboxFilterBind``.
+
+Covers: ListboxFilterBind, ListboxFilterUnbind.
+"""
+
+import time
+from conftest import render, screen_rows, screen_text
+
+
+def test_listbox_filter_narrows_while_typing(bash_newt):
+    """Typing into the bound entry should hide non-matching rows."""
+    bash_newt.sendline(
+        b"newt Init && newt Cls && "
+        b'newt OpenWindow 5 3 50 15 "Filter" && '
+        b'newt -v e Entry 1 1 "" 20 && '
+        b'newt -v lb Listbox 1 3 8 0 && '
+        b'for h in web-01 web-02 DB-01 db-02 cache-01; do '
+        b'newt ListboxAppendEntry "$lb" "$h" "$h"; done && '
+        b'newt ListboxFilterBind "$lb" "$e" && '
+        b'newt -v f Form "" "" 0 && '
+        b'newt FormAddComponents "$f" "$e" "$lb" && '
+        b'newt RunForm "$f"; '
+        b'newt -v n ListboxItemCount "$lb"; '
+        b'newt ListboxFilterUnbind "$lb"; '
+        b'newt -v all ListboxItemCount "$lb"; '
+        b'newt FormDestroy "$f"; '
+        b"newt Finished; "
+        b'echo "n=[$n] all=[$all]"'
+    )
+    render(bash_newt, initial_timeout=2.0)
+    bash_newt.send(b"db")
+    screen = render(bash_newt, initial_timeout=1.0)
+    rows = screen_rows(screen)
+    full = screen_text(screen)
+
+    assert any("DB-01" in r for r in rows), f"DB-01 should match 'db'.\n{full}"
+    assert any("db-02" in r for r in rows), f"db-02 should match 'db'.\n{full}"
+    assert not any("web-01" in r for r in rows), f"web-01 should be hidden.\n{full}"
+
+    bash_newt.send(b"\x1b[24~")   # F12 exits the form
+    time.sleep(0.5)
+    screen = render(bash_newt, initial_timeout=1.5, drain_timeout=0.3)
+    rows = screen_rows(screen)
+    assert any("n=[2] all=[5]" in r for r in rows), \
+        f"Unexpected item counts.\n{screen_text(screen)}"
@@ -0,0 +1,58 @@
+"""Functional tests for terminal output accounting (``newt OutputStats*``)."""
+
+import time
+
+from conftest import render, screen_rows, screen_text
+
+
+def _stats(bash_newt):
+    bash_newt.sendline(
+        b'newt OutputStats st; newt Finished; '
+        b'echo "S bytes=${st[bytes]} frames=${st[frames]} max=${st[max]} '
+        b'maxf=${st[max_frame]} idle=${st[idle]}"'
+    )
+    time.sleep(0.3)
+    screen = render(bash_newt, initial_timeout=1.0)
+    for r in screen_rows(screen):
+        if r.startswith("S bytes="):
+            return dict(kv.split("=", 1) for kv in r[2:].split(" ") if "=" in kv), screen
+    return None, screen
+
+
+def test_output_stats_counts_frames(bash_newt):
+    bash_newt.sendline(
+        b"newt OutputStatsStart && newt Init && newt Cls && "
+        b'newt OpenWindow 5 3 40 6 "Stats" && '
+        b'newt -v l Label 2 1 "counting bytes" && '
+        b'newt -v f Form && newt FormAddComponents "$f" "$l" && '
+        b'newt DrawForm "$f" && newt Refresh && newt Refresh'
+    )
+    stats, screen = _stats(bash_newt)
+    assert stats, screen_text(screen)
+    assert int(stats["bytes"]) > 0
+    assert int(stats["frames"]) == 3
+    assert int(stats["max"]) > 0
+    assert stats["maxf"] == "Refresh" or stats["maxf"].startswith("DrawForm ")
+    assert int(stats["bytes"]) >= int(stats["max"]) + int(stats["idle"])
+
+
+def test_output_stats_idle_without_start(bash_newt):
+    bash_newt.sendline(b"newt Init && newt Refresh")
+    stats, screen = _stats(bash_newt)
+    assert stats, screen_text(screen)
+    assert stats["bytes"] == "0" and stats["frames"] == "0"
+
+
+def test_output_stats_survive_subshell_stop(bash_newt):
+    """Stopping the stats in a subshell must not stop the parent's forwarding."""
+    bash_newt.sendline(
+        b"newt OutputStatsStart && newt Init && newt Cls && "
+        b"( newt OutputStatsStop ) && "
+        b'newt OpenWindow 5 3 40 6 "after subshell" && newt Refresh'
+    )
+    time.sleep(0.5)
+    screen = render(bash_newt, initial_timeout=1.5, drain_timeout=0.3)
+    assert any("after subshell" in r for r in screen_rows(screen)), screen_text(screen)
+    stats, screen = _stats(bash_newt)
+    assert stats, screen_text(screen)
+    assert int(stats["frames"]) == 1
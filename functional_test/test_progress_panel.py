@@ -0,0 +1,50 @@
+"""Functional tests for ``newt ProgressPanel`` and related commands.
+
+Covers: ProgressPanel (constructor), ProgressPanelWatch, ProgressPanelUpdate,
+ProgressPanelSetFrameBudget.
+"""
+
+import time
+
+from conftest import render, screen_rows, screen_text
+
+
+def test_progress_panel_reads_watched_fd(bash_newt):
+    """Lines from a watched fd update the rows while the form runs."""
+    bash_newt.sendline(
+        b"newt Init && newt Cls && "
+        b'newt OpenWindow 2 2 64 8 "Jobs" && '
+        b'newt -v f Form && '
+        b'newt -v pp ProgressPanel "$f" 1 1 60 build test && '
+        b"exec {pfd}< <(sleep 0.3; echo 'build 10 starting'; echo 'build 55% compiling'; "
+        b"echo 'nosuch 5 ignored'; echo 'test 100 all passed') && "
+        b'newt ProgressPanelWatch "$pp" "$pfd" && '
+        b'newt RunForm "$f"; '
+        b'newt FormDestroy "$f"; newt Finished; exec {pfd}<&-'
+    )
+    time.sleep(1.0)
+    screen = render(bash_newt, initial_timeout=2.0)
+    rows = screen_rows(screen)
+    full = screen_text(screen)
+    assert any("build" in r and "compiling" in r for r in rows), full
+    assert any("test" in r and "all passed" in r for r in rows), full
+    assert "ignored" not in full
+    bash_newt.send(b"\x1b[24~")
+
+
+def test_progress_panel_update_and_errors(bash_newt):
+    """ProgressPanelUpdate shows at once; unknown jobs are reported."""
+    bash_newt.sendline(
+        b"newt Init && "
+        b'newt -v f Form && '
+        b'newt -v pp ProgressPanel "$f" 1 1 60 a b && '
+        b'newt ProgressPanelSetFrameBudget "$pp" 0 && '
+        b'newt ProgressPanelUpdate "$pp" b 12.5 half way there && '
+        b'newt ProgressPanelUpdate "$pp" zz 3; rc=$?; '
+        b'newt FormDestroy "$f"; newt Finished; echo "rc=[$rc]"'
+    )
+    time.sleep(0.5)
+    screen = render(bash_newt, initial_timeout=1.5, drain_timeout=0.3)
+    full = screen_text(screen)
+    assert "zz: no such job" in full, full
+    assert any("rc=[1]" in r for r in screen_rows(screen)), full
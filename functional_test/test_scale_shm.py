@@ -0,0 +1,88 @@
+"""Functional tests for ``newt ScaleBindShm``."""
+
+import mmap
+import os
+import struct
+import time
+
+from conftest import render, screen_rows, screen_text
+
+_PATH = "/tmp/_scale_shm"
+
+
+def _store(done, total):
+    with open(_PATH, "r+b") as f:
+        m = mmap.mmap(f.fileno(), 16)
+        m[0:16] = struct.pack("=QQ", done, total)
+        m.close()
+
+
+def test_scale_bind_shm_follows_counter(bash_newt):
+    """The scale is sampled from the counter file while the form runs."""
+    if os.path.exists(_PATH):
+        os.unlink(_PATH)
+    bash_newt.sendline(
+        b"newt Init && newt Cls && "
+        b'newt OpenWindow 5 3 50 8 "Shm" && '
+        b'newt -v sc Scale 3 2 40 100 && '
+        b'newt ScaleBindShm "$sc" /tmp/_scale_shm 20 && '
+        b'newt -v f Form "" "" 0 && '
+        b'newt FormAddComponents "$f" "$sc" && '
+        b'newt ComponentSetId "$sc" bar && '
+        b'newt RunForm "$f"; '
+        b'newt FormCollect "$f" vals; '
+        b'newt FormDestroy "$f"; newt Finished; echo "bar=[${vals[bar]}]"'
+    )
+    render(bash_newt, initial_timeout=2.0)
+    assert os.path.getsize(_PATH) == 16
+    _store(37, 100)
+    time.sleep(0.5)
+    bash_newt.send(b"\x1b[24~")
+    time.sleep(0.5)
+    screen = render(bash_newt, initial_timeout=1.5, drain_timeout=0.3)
+    assert any("bar=[37]" in r for r in screen_rows(screen)), screen_text(screen)
+
+
+def test_scale_bind_shm_only_samples_in_its_form(bash_newt):
+    """A dialog run over the scale's window does not sample (and redraw) it."""
+    if os.path.exists(_PATH):
+        os.unlink(_PATH)
+    bash_newt.sendline(
+        b"newt Init && newt Cls && "
+        b'newt OpenWindow 5 3 50 8 "Shm" && '
+        b'newt -v sc Scale 3 2 40 100 && '
+        b'newt ScaleBindShm "$sc" /tmp/_scale_shm 20 && '
+        b'newt -v f Form "" "" 0 && '
+        b'newt FormAddComponents "$f" "$sc" && '
+        b'newt ComponentSetId "$sc" bar && '
+        b'newt OpenWindow 10 6 30 6 "Dialog" && '
+        b'newt -v ok Button 3 1 "OK" && '
+        b'newt -v d Form && '
+        b'newt FormAddComponents "$d" "$ok" && '
+        b'newt RunForm "$d"; '
+        b'newt FormCollect "$f" vals; '
+        b'newt FormDestroy "$d"; newt FormDestroy "$f"; newt Finished; '
+        b'echo "bar=[${vals[bar]}]"'
+    )
+    render(bash_newt, initial_timeout=2.0)
+    _store(37, 100)
+    time.sleep(0.5)
+    bash_newt.send(b"\r")
+    time.sleep(0.5)
+    screen = render(bash_newt, initial_timeout=1.5, drain_timeout=0.3)
+    assert any("bar=[0]" in r for r in screen_rows(screen)), screen_text(screen)
+
+
+def test_scale_bind_shm_rejects_non_scale(bash_newt):
+    """Only scales can be bound."""
+    bash_newt.sendline(
+        b"newt Init && "
+        b'newt -v b Button 1 1 "OK" && '
+        b'newt ScaleBindShm "$b" /tmp/_scale_shm; rc=$?; '
+        b'newt Finished; echo "rc=[$rc]"'
+    )
+    time.sleep(0.5)
+    screen = render(bash_newt, initial_timeout=1.5, drain_timeout=0.3)
+    full = screen_text(screen)
+    assert "ScaleBindShm: not a scale" in full, full
+    assert any("rc=[1]" in r for r in screen_rows(screen)), full
@@ -0,0 +1,34 @@
+"""Functional tests for ``newt ScreenDump``.
+
+ScreenDump reads the S-Lang screen buffer in-process, so these tests assert
+on the screen through the ``screen_dump`` helper rather than a pyte render.
+"""
+
+from conftest import COLS, ROWS, render, screen_dump, screen_rows, screen_text
+
+
+def test_screendump_matches_drawn_window(bash_newt, tmp_path):
+    bash_newt.sendline(
+        b"newt Init && newt Cls && "
+        b'newt OpenWindow 10 5 30 6 "Dump Test" && '
+        b'newt -v lbl Label 2 1 "hello from newt" && '
+        b'newt -v f Form && newt FormAddComponents "$f" "$lbl" && '
+        b'newt DrawForm "$f"'
+    )
+    rows, colors = screen_dump(bash_newt, tmp_path / "dump", colors=True)
+    bash_newt.sendline(b"newt Finished")
+
+    assert len(rows) == ROWS and len(colors) == ROWS
+    text = "\n".join(rows)
+    assert "hello from newt" in text, text
+    assert "Dump Test" in text, text
+    assert any("┌" in r or "┐" in r for r in rows), text   # window border
+    # Each colour row covers the full width.
+    for runs in colors:
+        assert sum(int(r.split(":")[1]) for r in runs.split()) == COLS, runs
+
+
+def test_screendump_without_init_fails(bash_newt):
+    bash_newt.sendline(b'newt ScreenDump rows; echo "RC=$?"')
+    screen = render(bash_newt, initial_timeout=1.0)
+    assert any("RC=1" in r for r in screen_rows(screen)), screen_text(screen)
@@ -140,3 +140,41 @@ def test_setcolor_single_pair(bash_newt):
         f"Rendering after SetColor crashed or label not visible.\n{full}"
 
     bash_newt.send(b"\n")
+
+
+# ─── Palettes ─────────────────────────────────────────────────────────────────
+
+def test_palette_define_load_apply(bash_newt, tmp_path):
+    """Palettes from an array and from a NEWT_COLORS file apply and render."""
+    colors = tmp_path / "alert.colors"
+    colors.write_text("root=white,red:window=black,yellow\ntitle=red,yellow\n")
+    bash_newt.sendline(
+        b'declare -A calm=( [ROOT]="white,blue" [window]="black,white" ); '
+        b"newt PaletteDefine calm calm && "
+        b"newt PaletteLoad alert " + str(colors).encode() + b" && "
+        b"newt Init && newt Cls && "
+        b"newt PaletteApply alert && newt PaletteApply calm && "
+        b'newt DrawRootText 0 0 "palette ok" && '
+        b"newt Refresh && newt WaitForKey && newt Finished"
+    )
+    screen = render(bash_newt, initial_timeout=2.0)
+    rows = screen_rows(screen)
+    assert any("palette ok" in r for r in rows), screen_text(screen)
+    bash_newt.send(b"\n")
+
+
+def test_palette_errors(bash_newt, tmp_path):
+    """Unknown colorsets, bad files and undefined palettes are failures."""
+    bad = tmp_path / "bad.colors"
+    bad.write_text("root=white,blue buton=red,white\n")
+    bash_newt.sendline(
+        b'declare -A typo=( [BUTON]="white,red" ); '
+        b'newt PaletteDefine p typo; echo "R1=$?"; '
+        b"newt PaletteLoad p " + str(bad).encode() + b'; echo "R2=$?"; '
+        b'newt PaletteApply nosuch; echo "R3=$?"'
+    )
+    screen = render(bash_newt, initial_timeout=2.0)
+    rows = screen_rows(screen)
+    full = screen_text(screen)
+    for tag in (b"R1=1", b"R2=1", b"R3=1"):
+        assert any(tag.decode() in r for r in rows), full
@@ -0,0 +1,138 @@
+"""Functional tests for ``newt TextboxRunCommand`` and ``TextboxRunCommandWait``."""
+
+import time
+
+from conftest import render, screen_rows, screen_text
+
+
+def test_textbox_run_command_streams_into_running_form(bash_newt):
+    """Output shows up while the form runs; the status lands in the -v variable."""
+    bash_newt.sendline(
+        b"newt Init && newt Cls && "
+        b'newt OpenWindow 5 3 50 10 "Command" && '
+        b'newt -v tb Textbox 1 1 40 4 0 && '
+        b'newt -v f Form "" "" 0 && '
+        b'newt FormAddComponent "$f" "$tb" && '
+        b"newt -v st TextboxRunCommand \"$tb\" "
+        b"'for i in 1 2 3 4 5 6; do echo \"line $i\"; done; printf \"10%%\\r99%%\\n\"; exit 4' && "
+        b'newt RunForm "$f"; '
+        b'newt FormDestroy "$f"; newt Finished; echo "st=[$st]"'
+    )
+    time.sleep(1.0)
+    screen = render(bash_newt, initial_timeout=2.0)
+    rows = screen_rows(screen)
+    full = screen_text(screen)
+    assert any("99%" in r for r in rows), full
+    assert any("line 6" in r for r in rows), full
+    assert not any("line 2" in r for r in rows), f"Only the tail should be shown.\n{full}"
+    assert not any("10%" in r for r in rows), full
+
+    bash_newt.send(b"\x1b[24~")
+    time.sleep(0.5)
+    screen = render(bash_newt, initial_timeout=1.5, drain_timeout=0.3)
+    assert any("st=[4]" in r for r in screen_rows(screen)), screen_text(screen)
+
+
+def test_textbox_run_command_wait_argv(bash_newt):
+    """With several arguments no shell is involved; Wait returns the status."""
+    bash_newt.sendline(
+        b"newt Init && "
+        b'newt -v tb Textbox 1 1 40 4 0 && '
+        b'newt -v st TextboxRunCommand "$tb" printf "%s;" "$HOME" "a b" && '
+        b'newt TextboxRunCommandWait "$tb"; rc=$?; '
+        b'newt TextboxRunCommand "$tb" /nonexistent/cmd x; newt TextboxRunCommandWait "$tb"; rc2=$?; '
+        b'newt Finished; echo "rc=[$rc] st=[$st] rc2=[$rc2]"'
+    )
+    time.sleep(0.8)
+    screen = render(bash_newt, initial_timeout=1.5, drain_timeout=0.3)
+    assert any("rc=[0] st=[0] rc2=[127]" in r for r in screen_rows(screen)), \
+        screen_text(screen)
+
+
+def test_textbox_run_command_scrollback_pages(bash_newt):
+    """With a form given to TextboxSetScrollback the paging keys scroll back."""
+    bash_newt.sendline(
+        b"newt Init && newt Cls && "
+        b'newt OpenWindow 5 3 50 10 "Command" && '
+        b'newt -v tb Textbox 1 1 40 4 0 && '
+        b'newt -v f Form "" "" 0 && '
+        b'newt FormAddComponent "$f" "$tb" && '
+        b'newt TextboxSetScrollback "$tb" 100 "$f" && '
+        b"newt TextboxRunCommand \"$tb\" 'for i in $(seq 1 10); do echo \"line $i\"; done' && "
+        b'newt RunForm "$f"; '
+        b'newt FormDestroy "$f"; newt Finished'
+    )
+    time.sleep(1.0)
+    rows = screen_rows(render(bash_newt, initial_timeout=2.0))
+    assert any("line 10" in r for r in rows), "\n".join(rows)
+
+    bash_newt.send(b"\x1b[5~")                     # PgUp
+    time.sleep(0.3)
+    rows = screen_rows(render(bash_newt, initial_timeout=1.0, drain_timeout=0.3))
+    assert any("line 3" in r for r in rows), "\n".join(rows)
+    assert not any("line 10" in r for r in rows), "\n".join(rows)
+
+    bash_newt.send(b"\x1b[4~")                     # End
+    time.sleep(0.3)
+    rows = screen_rows(render(bash_newt, initial_timeout=1.0, drain_timeout=0.3))
+    assert any("line 10" in r for r in rows), "\n".join(rows)
+    bash_newt.send(b"\x1b[24~")
+
+
+def test_textbox_run_command_waits_for_its_form(bash_newt):
+    """A dialog run over the textbox's form does not stream output into it."""
+    bash_newt.sendline(
+        b"newt Init && newt Cls && "
+        b'newt OpenWindow 2 2 40 6 "Command" && '
+        b'newt -v tb Textbox 1 1 30 3 0 && '
+        b'newt -v f Form "" "" 0 && '
+        b'newt FormAddComponent "$f" "$tb" && '
+        b"newt TextboxRunCommand \"$tb\" 'sleep 0.3; echo late-output' && "
+        b'newt OpenWindow 2 12 30 5 "Dialog" && '
+        b'newt -v ok Button 3 1 "OK" && '
+        b'newt -v d Form && '
+        b'newt FormAddComponents "$d" "$ok" && '
+        b'newt RunForm "$d"; '
+        b'newt FormDestroy "$d"; newt FormDestroy "$f"; newt Finished'
+    )
+    time.sleep(1.2)
+    screen = render(bash_newt, initial_timeout=2.0)
+    full = screen_text(screen)
+    assert "Dialog" in full, full
+    assert "late-output" not in full, full
+    bash_newt.send(b"\r")
+
+
+def test_textbox_run_command_reflowed_textbox_in_grid(bash_newt):
+    """A TextboxReflowed added through a grid is streamed into like any other."""
+    bash_newt.sendline(
+        b"newt Init && newt Cls && "
+        b'newt -v tb TextboxReflowed 0 0 "waiting" 30 0 0 0 && '
+        b'newt -v b Button 0 0 "Close" && '
+        b'newt -v g GridVStacked 1 "$tb" 1 "$b" && '
+        b'newt GridWrappedWindow "$g" "Command" && '
+        b'newt -v f Form "" "" 0 && '
+        b'newt GridAddComponentsToForm "$g" "$f" 1 && '
+        b"newt TextboxRunCommand \"$tb\" 'sleep 0.3; echo grid-output' && "
+        b'newt RunForm "$f"; '
+        b'newt FormDestroy "$f"; newt GridFree "$g" 1; newt Finished'
+    )
+    time.sleep(1.2)
+    screen = render(bash_newt, initial_timeout=2.0)
+    assert any("grid-output" in r for r in screen_rows(screen)), screen_text(screen)
+    bash_newt.send(b"\r")
+
+
+def test_textbox_run_command_refuses_other_widgets(bash_newt):
+    """Only textboxes take a command; a button is refused, not written to."""
+    bash_newt.sendline(
+        b"newt Init && "
+        b'newt -v b Button 0 0 "OK" && '
+        b'newt TextboxRunCommand "$b" true; rc=$?; '
+        b'newt Finished; echo "rc=[$rc]"'
+    )
+    time.sleep(0.8)
+    screen = render(bash_newt, initial_timeout=1.5, drain_timeout=0.3)
+    full = screen_text(screen)
+    assert "TextboxRunCommand: not a textbox" in full, full
+    assert any("rc=[1]" in r for r in screen_rows(screen)), full
@@ -0,0 +1,65 @@
+"""Functional tests for ``newt VirtualListbox`` and related commands.
+
+Covers: VirtualListbox (constructor), VirtualListboxSetRows,
+VirtualListboxLoadFile, VirtualListboxItemCount, VirtualListboxSetCurrent,
+VirtualListboxGetCurrent.
+"""
+
+import time
+from conftest import render, screen_rows, screen_text
+
+
+def test_virtual_listbox_rows_visible(bash_newt):
+    """The first rows of a large array should be visible."""
+    bash_newt.sendline(
+        b"rows=(); for ((i=0; i<5000; i++)); do rows+=(\"row $i\"); done; "
+        b"newt Init && newt Cls && "
+        b'newt OpenWindow 5 3 50 15 "Virtual" && '
+        b'newt -v lb VirtualListbox 3 1 8 0 && '
+        b'newt VirtualListboxSetRows "$lb" rows && '
+        b'newt -v f Form "" "" 0 && '
+        b'newt FormAddComponents "$f" "$lb" && '
+        b'newt RunForm "$f" && '
+        b'newt FormDestroy "$f" && '
+        b"newt Finished"
+    )
+    screen = render(bash_newt, initial_timeout=2.0)
+    rows = screen_rows(screen)
+    full = screen_text(screen)
+
+    assert any("row 0" in r for r in rows), f"First row not visible.\n{full}"
+    assert not any("row 100" in r for r in rows), \
+        f"Rows beyond the first page should not be visible.\n{full}"
+
+    bash_newt.send(b"\n")
+
+
+def test_virtual_listbox_set_current_far(bash_newt):
+    """SetCurrent far outside the initial window should show that row."""
+    bash_newt.sendline(
+        b"seq 0 99999 > /tmp/_vlb_rows.txt; "
+        b"newt Init && newt Cls && "
+        b'newt OpenWindow 5 3 50 15 "Virtual" && '
+        b'newt -v lb VirtualListbox 3 1 8 0 && '
+        b'newt VirtualListboxLoadFile "$lb" /tmp/_vlb_rows.txt && '
+        b'newt VirtualListboxSetCurrent "$lb" 77777 && '
+        b'newt -v f Form "" "" 0 && '
+        b'newt FormAddComponents "$f" "$lb" && '
+        b'newt RunForm "$f" && '
+        b'newt -v cur VirtualListboxGetCurrent "$lb" && '
+        b'newt -v n VirtualListboxItemCount "$lb" && '
+        b'newt FormDestroy "$f" && '
+        b"newt Finished; "
+        b'echo "cur=[$cur] n=[$n]"'
+    )
+    screen = render(bash_newt, initial_timeout=2.0)
+    rows = screen_rows(screen)
+    full = screen_text(screen)
+    assert any("77777" in r for r in rows), f"Row 77777 not visible.\n{full}"
+
+    bash_newt.send(b"\n")
+    time.sleep(0.5)
+    screen = render(bash_newt, initial_timeout=1.5, drain_timeout=0.3)
+    rows = screen_rows(screen)
+    assert any("cur=[77777] n=[100000]" in r for r in rows), \
+        f"Unexpected cursor/count.\n{screen_text(screen)}"
@@ -25,7 +25,7 @@ extern "C" {
 }
 
 #include "newt_wrappers.hpp"   // WrapperFn, find_command
-#include "newt_constants.hpp"  // register_newt_constants
+#include "newt_constants.hpp"  // register_newt_constants, populate_newt_constants
 
 // ─── bash builtin boilerplate ─────────────────────────────────────────────────
 
@@ -106,4 +106,5 @@ extern "C" int newt_builtin_load(char* /*s*/) {
 }
 
 extern "C" void newt_builtin_unload(char* /*s*/) {
+    populate_newt_constants();
 }
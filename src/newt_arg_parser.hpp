@@ -31,6 +31,8 @@
 #include <cstdlib>
 #include <cstdint>
 
+#include "newt_symbols.hpp"
+
 // NOTE: The caller must include the bash headers and <newt.h> before this file:
 //   extern "C" { #include <newt.h> }
 //   extern "C" { #include "builtins.h"; #include "shell.h"; ... }
@@ -38,16 +40,23 @@
 // ─── from_string overloads ────────────────────────────────────────────────────
 // Each overload parses a C string into a typed output reference.
 // Returns true on success, false on parse failure.
+//
+// int, unsigned int and the enums also accept symbolic constants such as
+// 'SCROLL|RETURNEXIT' or KEY:F12 (see newt_symbols.hpp).
 
 inline bool from_string(const char* s, int& out) {
     intmax_t i;
     if (legal_number(s, &i)) { out = static_cast<int>(i); return true; }
+    long long v;
+    if (newt_symbols::evaluate(s, v)) { out = static_cast<int>(v); return true; }
     return false;
 }
 
 inline bool from_string(const char* s, unsigned int& out) {
     intmax_t i;
     if (legal_number(s, &i)) { out = static_cast<unsigned int>(i); return true; }
+    long long v;
+    if (newt_symbols::evaluate(s, v)) { out = static_cast<unsigned int>(v); return true; }
     return false;
 }
 
@@ -156,16 +165,20 @@ inline bool from_string(const char* s, newtEntryFilter& out) {
     return false;
 }
 
-// Enum types — parse as int then cast.
+// Enum types — parse as int (or symbol, e.g. SENSE:TOGGLE) then cast.
 inline bool from_string(const char* s, enum newtFlagsSense& out) {
     intmax_t i;
     if (legal_number(s, &i)) { out = static_cast<enum newtFlagsSense>(i); return true; }
+    long long v;
+    if (newt_symbols::evaluate(s, v)) { out = static_cast<enum newtFlagsSense>(v); return true; }
     return false;
 }
 
 inline bool from_string(const char* s, enum newtGridElement& out) {
     intmax_t i;
     if (legal_number(s, &i)) { out = static_cast<enum newtGridElement>(i); return true; }
+    long long v;
+    if (newt_symbols::evaluate(s, v)) { out = static_cast<enum newtGridElement>(v); return true; }
     return false;
 }
 
@@ -0,0 +1,249 @@
+#pragma once
+
+/**
+ * newt_async_load.hpp
+ *
+ * Background file loads for AsyncLoad.  A load reads a file (or lists a
+ * directory) on a pool thread and, for listboxes, splits it into rows there
+ * too; the finished Result is queued and one byte is written to a notify
+ * pipe.  The builtin watches the pipe's read end with newtFormWatchFd, so a
+ * running form wakes up, take()s the results and installs them into their
+ * widgets on the main thread.
+ *
+ * Loads are keyed by their target widget.  Starting another load for the
+ * same target, or cancel()ing it, makes the earlier one stale: it still runs
+ * to completion but take() and wait() drop its result.
+ */
+
+#include "newt_row_store.hpp"
+#include "newt_thread_pool.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstddef>
+#include <dirent.h>
+#include <fcntl.h>
+#include <map>
+#include <mutex>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace newt_async_load {
+
+// Reads 'path' into 'out': a file whole, a directory as its entry names one
+// per line in byte order, subdirectories with a trailing '/'.  Returns false
+// (errno set) on failure.
+inline bool read_path(const std::string& path, std::string& out) {
+    out.clear();
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    struct stat sb;
+    if (::fstat(fd, &sb) < 0) {
+        int e = errno;
+        ::close(fd);
+        errno = e;
+        return false;
+    }
+
+    if (S_ISDIR(sb.st_mode)) {
+        DIR* dir = ::fdopendir(fd);
+        if (!dir) {
+            int e = errno;
+            ::close(fd);
+            errno = e;
+            return false;
+        }
+        std::vector<std::string> names;
+        while (struct dirent* de = ::readdir(dir)) {
+            std::string name = de->d_name;
+            if (name == "." || name == "..") continue;
+            bool is_dir = de->d_type == DT_DIR;
+            if (de->d_type == DT_UNKNOWN || de->d_type == DT_LNK) {
+                struct stat st;
+                is_dir = ::fstatat(::dirfd(dir), de->d_name, &st, 0) == 0 && S_ISDIR(st.st_mode);
+            }
+            if (is_dir) name += '/';
+            names.push_back(std::move(name));
+        }
+        ::closedir(dir);
+        std::sort(names.begin(), names.end());
+        for (const std::string& n : names) {
+            out += n;
+            out += '\n';
+        }
+        return true;
+    }
+
+    if (S_ISREG(sb.st_mode)) out.reserve(static_cast<std::size_t>(sb.st_size));
+    char buf[65536];
+    for (;;) {
+        ssize_t n = ::read(fd, buf, sizeof(buf));
+        if (n == 0) break;
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            int e = errno;
+            ::close(fd);
+            errno = e;
+            return false;
+        }
+        out.append(buf, static_cast<std::size_t>(n));
+    }
+    ::close(fd);
+    return true;
+}
+
+struct Result {
+    const void* target = nullptr;
+    std::string path;
+    int         error = 0;    // errno of a failed load, 0 on success
+    std::string text;         // the content, when not split into lines
+    RowStore    rows;         // one row per line, when split
+};
+
+class Loader {
+public:
+    Loader() = default;
+    Loader(const Loader&) = delete;
+    Loader& operator=(const Loader&) = delete;
+
+    // Waits for loads still running.
+    ~Loader() {
+        std::unique_lock<std::mutex> lk(m_);
+        cv_.wait(lk, [this] { return running_ == 0; });
+        for (int fd : notify_) if (fd >= 0) ::close(fd);
+    }
+
+    // Read end of the notify pipe; -1 until the first start().
+    int fd() const { return notify_[0]; }
+
+    // Starts loading 'path' for 'target' on 'pool'.  With 'lines' the result
+    // is split into rows, otherwise it is kept as text.  Returns false (errno
+    // set) if the notify pipe cannot be created.
+    bool start(const void* target, std::string path, bool lines, ThreadPool& pool) {
+        if (notify_[0] < 0) {
+            int p[2];
+            if (::pipe(p) < 0) return false;
+            for (int fd : p) {
+                ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+                ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+            }
+            notify_[0] = p[0];
+            notify_[1] = p[1];
+        }
+        unsigned long gen;
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            gen = ++generation_;
+            jobs_[target] = gen;
+            ++running_;
+        }
+        pool.post([this, target, gen, lines, path = std::move(path)]() mutable {
+            Done d;
+            d.generation    = gen;
+            d.result.target = target;
+            std::string text;
+            if (!read_path(path, text))
+                d.result.error = errno;
+            else if (lines)
+                d.result.rows.assign_lines(std::move(text));
+            else
+                d.result.text = std::move(text);
+            d.result.path = std::move(path);
+            {
+                std::lock_guard<std::mutex> lk(m_);
+                done_.push_back(std::move(d));
+                char c = 0;
+                while (::write(notify_[1], &c, 1) < 0 && errno == EINTR) {}
+                --running_;
+            }
+            cv_.notify_all();
+        });
+        return true;
+    }
+
+    // True while a load for 'target' has not been taken or cancelled.
+    bool pending(const void* target) const {
+        std::lock_guard<std::mutex> lk(m_);
+        return jobs_.count(target) != 0;
+    }
+
+    bool pending() const {
+        std::lock_guard<std::mutex> lk(m_);
+        return !jobs_.empty();
+    }
+
+    void cancel(const void* target) {
+        std::lock_guard<std::mutex> lk(m_);
+        jobs_.erase(target);
+    }
+
+    // The finished, current loads in completion order.  Empties the notify
+    // pipe.
+    std::vector<Result> take() {
+        return take([](const void*) { return true; });
+    }
+
+    // Like take(), but only for targets 'want' accepts; the loads of other
+    // targets stay queued for a later take() or wait().
+    template <class Pred>
+    std::vector<Result> take(Pred want) {
+        if (notify_[0] >= 0) {
+            char buf[64];
+            while (::read(notify_[0], buf, sizeof(buf)) > 0) {}
+        }
+        std::vector<Result> out;
+        std::lock_guard<std::mutex> lk(m_);
+        std::vector<Done> keep;
+        for (Done& d : done_) {
+            auto job = jobs_.find(d.result.target);
+            if (job == jobs_.end() || job->second != d.generation) continue;   // stale
+            if (!want(d.result.target)) {
+                keep.push_back(std::move(d));
+                continue;
+            }
+            jobs_.erase(job);
+            out.push_back(std::move(d.result));
+        }
+        done_.swap(keep);
+        return out;
+    }
+
+    // Blocks until the load for 'target' finishes and moves its result to
+    // 'out'.  Returns false if there is no such load.  Other results stay
+    // queued for take().
+    bool wait(const void* target, Result& out) {
+        std::unique_lock<std::mutex> lk(m_);
+        for (;;) {
+            auto job = jobs_.find(target);
+            if (job == jobs_.end()) return false;
+            for (auto it = done_.begin(); it != done_.end(); ++it) {
+                if (it->result.target != target || it->generation != job->second) continue;
+                jobs_.erase(job);
+                out = std::move(it->result);
+                done_.erase(it);
+                return true;
+            }
+            cv_.wait(lk);
+        }
+    }
+
+private:
+    struct Done {
+        unsigned long generation = 0;
+        Result        result;
+    };
+
+    mutable std::mutex                   m_;
+    std::condition_variable              cv_;
+    std::map<const void*, unsigned long> jobs_;   // target → latest generation
+    std::vector<Done>                    done_;
+    unsigned long                        generation_ = 0;
+    unsigned                             running_    = 0;
+    int                                  notify_[2]  = { -1, -1 };
+};
+
+} // namespace newt_async_load
@@ -0,0 +1,176 @@
+#pragma once
+
+/**
+ * newt_child_command.hpp
+ *
+ * A command run for TextboxRunCommand, with its stdout and stderr on a pipe
+ * the builtin reads, and its exit status reported back once it is done.
+ *
+ * Bash reaps every child process it has from its SIGCHLD handler, including
+ * ones it did not start, so the builtin cannot waitpid() for the command
+ * itself.  Instead it forks a small supervisor, which bash may reap when it
+ * likes; the supervisor runs the command as its own child, waits for it and
+ * writes the status to a second pipe.  Between fork and exec only
+ * async-signal-safe calls are made (the pool threads of the parent do not
+ * exist in the child).
+ *
+ * With one argument the command is a shell command line run by /bin/sh -c;
+ * with more it is an argv executed directly.  The command gets /dev/null as
+ * stdin and runs in a process group of its own (led by the supervisor), so
+ * terminate() stops it along with anything it started.
+ */
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+class ChildCommand {
+public:
+    ChildCommand() = default;
+    ChildCommand(const ChildCommand&) = delete;
+    ChildCommand& operator=(const ChildCommand&) = delete;
+    ~ChildCommand() { terminate(); }
+
+    // Starts the command.  Returns false (errno set) if it could not be
+    // started; a program that does not exist still starts and exits 127.
+    bool start(const std::vector<std::string>& argv) {
+        if (argv.empty()) { errno = EINVAL; return false; }
+        std::vector<std::string> args = argv.size() == 1
+            ? std::vector<std::string>{ "/bin/sh", "-c", argv[0] } : argv;
+        std::vector<char*> cargv;
+        for (std::string& s : args) cargv.push_back(&s[0]);
+        cargv.push_back(nullptr);
+
+        int out[2], status[2];
+        if (::pipe2(out, O_CLOEXEC) < 0) return false;
+        if (::pipe2(status, O_CLOEXEC) < 0) {
+            int e = errno;
+            ::close(out[0]);
+            ::close(out[1]);
+            errno = e;
+            return false;
+        }
+        pid_t pid = ::fork();
+        if (pid == 0) supervise(cargv.data(), out[1], status[1]);
+        int e = errno;
+        ::close(out[1]);
+        ::close(status[1]);
+        if (pid < 0) {
+            ::close(out[0]);
+            ::close(status[0]);
+            errno = e;
+            return false;
+        }
+        ::fcntl(out[0], F_SETFL, ::fcntl(out[0], F_GETFL) | O_NONBLOCK);
+        pid_       = pid;
+        out_fd_    = out[0];
+        status_fd_ = status[0];
+        return true;
+    }
+
+    // The output pipe; -1 before start() and once the output has ended.
+    int fd() const { return out_fd_; }
+
+    // Most read() takes in one call, so that a command writing faster than
+    // the pipe drains (yes, a noisy build) cannot keep the caller here.
+    static constexpr std::size_t kReadLimit = 2 * 65536;
+
+    // Appends what the command has written so far, up to kReadLimit bytes, to
+    // 'out'.  Returns false once all of its output has been read (the pipe is
+    // then closed); the pipe stays readable if more is waiting.
+    bool read(std::string& out) {
+        if (out_fd_ < 0) return false;
+        char buf[65536];
+        for (std::size_t got = 0; got < kReadLimit; ) {
+            ssize_t n = ::read(out_fd_, buf, sizeof(buf));
+            if (n > 0) {
+                out.append(buf, static_cast<std::size_t>(n));
+                got += static_cast<std::size_t>(n);
+                continue;
+            }
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0 && errno == EAGAIN) return true;
+            ::close(out_fd_);
+            out_fd_ = -1;
+            return false;
+        }
+        return true;
+    }
+
+    // The exit status, as bash reports it (128 + signal number when killed),
+    // waiting for the command to exit.  255 if it cannot be known.
+    int status() {
+        if (status_fd_ >= 0) {
+            int code = 255;
+            ssize_t n;
+            while ((n = ::read(status_fd_, &code, sizeof(code))) < 0 && errno == EINTR) {}
+            status_    = n == static_cast<ssize_t>(sizeof(code)) ? code : 255;
+            ::close(status_fd_);
+            status_fd_ = -1;
+            pid_       = 0;
+        }
+        return status_;
+    }
+
+    // Stops a command still running and closes the pipes.
+    void terminate() {
+        if (pid_ > 0) ::kill(-pid_, SIGTERM);
+        pid_ = 0;
+        for (int* fd : { &out_fd_, &status_fd_ }) {
+            if (*fd >= 0) ::close(*fd);
+            *fd = -1;
+        }
+    }
+
+private:
+    [[noreturn]] static void supervise(char* const* argv, int out, int status) {
+        struct sigaction dfl;
+        std::memset(&dfl, 0, sizeof(dfl));
+        dfl.sa_handler = SIG_DFL;
+        sigemptyset(&dfl.sa_mask);
+        for (int sig : { SIGCHLD, SIGHUP, SIGINT, SIGQUIT, SIGTERM, SIGPIPE,
+                         SIGTSTP, SIGTTIN, SIGTTOU })
+            ::sigaction(sig, &dfl, nullptr);
+        sigset_t none;
+        sigemptyset(&none);
+        ::sigprocmask(SIG_SETMASK, &none, nullptr);
+        ::setpgid(0, 0);
+
+        pid_t pid = ::fork();
+        if (pid == 0) {
+            int null = ::open("/dev/null", O_RDONLY);
+            if (null >= 0) ::dup2(null, 0);
+            ::dup2(out, 1);
+            ::dup2(out, 2);
+            ::execvp(argv[0], argv);
+            int e = errno;
+            static const char msg[] = ": cannot execute\n";
+            ::write(2, argv[0], std::strlen(argv[0]));
+            ::write(2, msg, sizeof(msg) - 1);
+            ::_exit(e == ENOENT ? 127 : 126);
+        }
+        ::close(out);
+        int code = 255;
+        int ws;
+        if (pid > 0) {
+            pid_t r;
+            while ((r = ::waitpid(pid, &ws, 0)) < 0 && errno == EINTR) {}
+            if (r == pid)
+                code = WIFEXITED(ws) ? WEXITSTATUS(ws)
+                     : WIFSIGNALED(ws) ? 128 + WTERMSIG(ws) : 255;
+        }
+        ::write(status, &code, sizeof(code));
+        ::_exit(0);
+    }
+
+    pid_t pid_       = 0;
+    int   out_fd_    = -1;
+    int   status_fd_ = -1;
+    int   status_    = 255;
+};
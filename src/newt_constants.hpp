@@ -4,7 +4,11 @@
  * Exports libnewt #define constants into bash as read-only associative arrays.
  *
  * Called once from newt_builtin_load() so the arrays are available as soon as
- * the builtin is loaded.
+ * the builtin is loaded.  They are declared empty there and filled from
+ * newt_symbols::kConstants the first time bash looks each one up, so loading
+ * the builtin costs eight empty variables, and a script pays only for the
+ * arrays it uses.  Integer arguments accept the names directly ('SCROLL|WRAP',
+ * KEY:F12) without touching the arrays at all.
  *
  * Arrays created:
  *   NEWT_COLORSET   – colorset indices (ROOT, BORDER, WINDOW, …)
@@ -26,6 +30,10 @@
 
 #pragma once
 
-/// Register all NEWT_* #define constants as read-only bash associative arrays.
+/// Declare the NEWT_* read-only associative arrays, populated on first lookup.
 /// Must be called only within a real bash environment (not in unit-test stubs).
 void register_newt_constants();
+
+/// Fill every NEWT_* array not referenced yet.  Called on unload: the arrays
+/// outlive `enable -d newt`, and their hook points into the unloaded module.
+void populate_newt_constants();
@@ -0,0 +1,197 @@
+#pragma once
+
+/**
+ * newt_dir_scan.hpp
+ *
+ * Directory listings for FilePicker, read on pool threads and cached by path.
+ *
+ * scan_directory() lists one directory: the entries of an openat()'d
+ * directory fd read with readdir (getdents underneath), types from d_type or,
+ * where the filesystem does not report it, from fstatat() relative to the
+ * same fd.  Symlinks are never followed, so a link to a directory is listed
+ * as a file and a tree with link loops stays finite.  Subdirectories come
+ * first, then files, each group in byte order.
+ *
+ * DirScanner runs those scans on a ThreadPool.  request() queues a directory
+ * unless it is cached or already queued; with 'prefetch', its subdirectories
+ * are queued as soon as it has been read (or at once, if it is cached), so
+ * the next level is usually ready before the user expands it.  Every
+ * finished scan writes one byte to the notify pipe, which the builtin
+ * watches with newtFormWatchFd.  Listings are kept until the scanner is
+ * destroyed: expanding a node twice never reads the directory twice.
+ */
+
+#include "newt_thread_pool.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <dirent.h>
+#include <fcntl.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace newt_dir_scan {
+
+struct Entry {
+    std::string name;
+    bool        dir = false;
+};
+
+struct Listing {
+    int                error = 0;   // errno if the directory could not be read
+    std::vector<Entry> entries;
+};
+
+// "dir" + "/" + "name", without doubling the slash after "/".
+inline std::string join(const std::string& dir, const std::string& name) {
+    return !dir.empty() && dir.back() == '/' ? dir + name : dir + '/' + name;
+}
+
+inline Listing scan_directory(const std::string& path) {
+    Listing l;
+    int fd = ::openat(AT_FDCWD, path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    DIR* dir = fd >= 0 ? ::fdopendir(fd) : nullptr;
+    if (!dir) {
+        l.error = errno;
+        if (fd >= 0) ::close(fd);
+        return l;
+    }
+    while (struct dirent* de = ::readdir(dir)) {
+        const char* n = de->d_name;
+        if (n[0] == '.' && (n[1] == '\0' || (n[1] == '.' && n[2] == '\0'))) continue;
+        Entry e;
+        e.name = n;
+        if (de->d_type == DT_UNKNOWN) {
+            struct stat st;
+            e.dir = ::fstatat(fd, n, &st, AT_SYMLINK_NOFOLLOW) == 0 && S_ISDIR(st.st_mode);
+        } else {
+            e.dir = de->d_type == DT_DIR;
+        }
+        l.entries.push_back(std::move(e));
+    }
+    ::closedir(dir);
+    std::sort(l.entries.begin(), l.entries.end(), [](const Entry& a, const Entry& b) {
+        return a.dir != b.dir ? a.dir : a.name < b.name;
+    });
+    return l;
+}
+
+class DirScanner {
+public:
+    explicit DirScanner(ThreadPool& pool) : pool_(pool) {}
+    DirScanner(const DirScanner&) = delete;
+    DirScanner& operator=(const DirScanner&) = delete;
+
+    // Skips scans still queued and waits for those running.
+    ~DirScanner() {
+        std::unique_lock<std::mutex> lk(m_);
+        stopping_ = true;
+        cv_.wait(lk, [this] { return running_ == 0; });
+        for (int fd : notify_) if (fd >= 0) ::close(fd);
+    }
+
+    // Creates the notify pipe.  Returns false (errno set) on failure.
+    bool open() {
+        if (::pipe(notify_) < 0) return false;
+        for (int fd : notify_) {
+            ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+            ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+        }
+        return true;
+    }
+
+    // Read end of the notify pipe.
+    int fd() const { return notify_[0]; }
+
+    // Queues a scan of 'path' unless it is cached or queued already.  With
+    // 'prefetch', subdirectories not read yet are queued once it is read.
+    void request(const std::string& path, bool prefetch) {
+        std::lock_guard<std::mutex> lk(m_);
+        queue_locked(path, prefetch);
+    }
+
+    // The listing of 'path' if it has been read, else nullptr.
+    std::shared_ptr<const Listing> find(const std::string& path) const {
+        std::lock_guard<std::mutex> lk(m_);
+        auto it = cache_.find(path);
+        return it == cache_.end() ? nullptr : it->second;
+    }
+
+    // Requests 'path' and blocks until its listing is there.
+    std::shared_ptr<const Listing> wait(const std::string& path, bool prefetch) {
+        std::unique_lock<std::mutex> lk(m_);
+        queue_locked(path, prefetch);
+        cv_.wait(lk, [&] { return cache_.count(path) != 0; });
+        return cache_[path];
+    }
+
+    // Makes the notify pipe readable without a scan, for a listing the caller
+    // wants picked up on the next wake-up.
+    void wake() {
+        char c = 0;
+        while (::write(notify_[1], &c, 1) < 0 && errno == EINTR) {}
+    }
+
+    // Empties the notify pipe.
+    void drain() {
+        char buf[64];
+        while (notify_[0] >= 0 && ::read(notify_[0], buf, sizeof(buf)) > 0) {}
+    }
+
+private:
+    void queue_locked(const std::string& path, bool prefetch) {
+        if (stopping_) return;
+        auto it = cache_.find(path);
+        if (it != cache_.end()) {
+            if (prefetch) prefetch_locked(path, *it->second);
+            return;
+        }
+        if (!queued_.insert(path).second) return;
+        ++running_;
+        pool_.post([this, path, prefetch] { run(path, prefetch); });
+    }
+
+    void prefetch_locked(const std::string& path, const Listing& l) {
+        for (const Entry& e : l.entries)
+            if (e.dir) queue_locked(join(path, e.name), false);
+    }
+
+    void run(const std::string& path, bool prefetch) {
+        bool skip;
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            skip = stopping_;
+        }
+        auto listing = skip ? nullptr : std::make_shared<const Listing>(scan_directory(path));
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            if (listing) {
+                cache_[path] = listing;
+                if (prefetch) prefetch_locked(path, *listing);
+                wake();
+            }
+            queued_.erase(path);
+            --running_;
+        }
+        cv_.notify_all();
+    }
+
+    ThreadPool&                                                     pool_;
+    mutable std::mutex                                              m_;
+    std::condition_variable                                         cv_;
+    std::unordered_map<std::string, std::shared_ptr<const Listing>> cache_;
+    std::unordered_set<std::string>                                 queued_;
+    unsigned                                                        running_  = 0;
+    bool                                                            stopping_ = false;
+    int                                                             notify_[2] = { -1, -1 };
+};
+
+} // namespace newt_dir_scan
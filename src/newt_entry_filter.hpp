@@ -0,0 +1,150 @@
+#pragma once
+
+/**
+ * newt_entry_filter.hpp
+ *
+ * Entry filters for EntrySetNativeFilter, applied to every keystroke without
+ * calling into bash.  A spec is a comma-separated list of:
+ *
+ *   digits hex alpha alnum space hostname printable utf8
+ *                   character classes; a key is accepted if any class has it
+ *   chars:SET       the characters in SET, with ranges such as a-z; it takes
+ *                   the rest of the spec, commas included, so it comes last
+ *   max:N           at most N characters (UTF-8 sequences count as one)
+ *   upper | lower   fold ASCII letters before checking and inserting them
+ *
+ * e.g. "digits,max:5", "hostname,lower", "hex,upper,max:16".  Without a class
+ * every character is allowed.  The classes are compiled into a 256-bit
+ * bitmap, so checking a key is one bit test.  Only keys that insert a
+ * character are filtered; editing and movement keys always pass.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+namespace newt_entry_filter {
+
+class NativeFilter {
+public:
+    enum class Fold { None, Upper, Lower };
+
+    // Compiles 'spec'.  On error returns false with the offending item in
+    // 'error'.
+    bool parse(const std::string& spec, std::string& error) {
+        *this = NativeFilter();
+        bool any_class = false;
+        std::size_t pos = 0;
+        while (pos <= spec.size()) {
+            std::size_t comma = spec.find(',', pos);
+            std::string item = spec.substr(pos, comma == std::string::npos ? std::string::npos
+                                                                            : comma - pos);
+            if (item.compare(0, 6, "chars:") == 0) {
+                add_set(spec.substr(pos + 6));
+                any_class = true;
+                break;
+            }
+            if (item == "digits")         { add_range('0', '9'); any_class = true; }
+            else if (item == "hex")       { add_range('0', '9'); add_range('a', 'f');
+                                            add_range('A', 'F'); any_class = true; }
+            else if (item == "alpha")     { add_alpha(); any_class = true; }
+            else if (item == "alnum")     { add_alpha(); add_range('0', '9'); any_class = true; }
+            else if (item == "space")     { add_range(' ', ' '); any_class = true; }
+            else if (item == "hostname")  { add_alpha(); add_range('0', '9');
+                                            add_set("-."); any_class = true; }
+            else if (item == "printable") { add_range(0x20, 0x7e); any_class = true; }
+            else if (item == "utf8")      { add_range(0x80, 0xff); any_class = true; }
+            else if (item == "upper")     fold_ = Fold::Upper;
+            else if (item == "lower")     fold_ = Fold::Lower;
+            else if (item.compare(0, 4, "max:") == 0) {
+                char* end = nullptr;
+                long n = std::strtol(item.c_str() + 4, &end, 10);
+                if (item.size() == 4 || *end || n < 0) { error = item; return false; }
+                max_ = static_cast<std::size_t>(n);
+                has_max_ = true;
+            } else if (!item.empty()) {
+                error = item;
+                return false;
+            }
+            if (comma == std::string::npos) break;
+            pos = comma + 1;
+        }
+        if (!any_class) add_range(0, 0xff);
+        return true;
+    }
+
+    // The key to hand back to libnewt for 'ch' typed into an entry holding
+    // 'value': 'ch' itself, its folded form, or 0 to reject it.
+    int apply(int ch, const char* value) const { return apply_at(ch, length(value), true); }
+
+    // The part of 'text' (a pasted run of keys) that the filter lets into an
+    // entry holding 'value', folded.  Keys that do not insert text are
+    // dropped, and so is the rest of a UTF-8 sequence whose first byte was.
+    std::string filter_text(const char* value, const std::string& text) const {
+        std::size_t len = length(value);
+        bool open = true;
+        std::string out;
+        for (char c : text) {
+            int ch = static_cast<unsigned char>(c);
+            if (ch < 0x20 || ch == 0x7f) continue;
+            bool starts_char = (ch & 0xC0) != 0x80;
+            ch = apply_at(ch, len, open);
+            if (starts_char) open = ch != 0;
+            if (!ch) continue;
+            if (starts_char) ++len;
+            out += static_cast<char>(ch);
+        }
+        return out;
+    }
+
+    bool allows(unsigned char c) const { return bits_[c >> 6] >> (c & 63) & 1; }
+
+    // Characters in 'value', counting a UTF-8 sequence as one.
+    static std::size_t length(const char* value) {
+        std::size_t n = 0;
+        for (const char* p = value ? value : ""; *p; ++p)
+            if ((*p & 0xC0) != 0x80) ++n;
+        return n;
+    }
+
+private:
+    // apply() for an entry holding 'len' characters; 'open' is false when the
+    // byte starting the current UTF-8 sequence was rejected.
+    int apply_at(int ch, std::size_t len, bool open) const {
+        if (ch < 0x20 || ch == 0x7f || ch > 0xff) return ch;   // not an insertion
+        if (fold_ == Fold::Upper && ch >= 'a' && ch <= 'z') ch -= 'a' - 'A';
+        if (fold_ == Fold::Lower && ch >= 'A' && ch <= 'Z') ch += 'a' - 'A';
+        if (!allows(static_cast<unsigned char>(ch))) return 0;
+        if ((ch & 0xC0) == 0x80) return open ? ch : 0;
+        if (has_max_ && len >= max_) return 0;
+        return ch;
+    }
+
+    void add_range(unsigned lo, unsigned hi) {
+        for (unsigned c = lo; c <= hi; ++c) bits_[c >> 6] |= std::uint64_t(1) << (c & 63);
+    }
+    void add_alpha() {
+        add_range('a', 'z');
+        add_range('A', 'Z');
+    }
+    void add_set(const std::string& set) {
+        for (std::size_t i = 0; i < set.size(); ++i) {
+            unsigned char lo = static_cast<unsigned char>(set[i]);
+            if (i + 2 < set.size() && set[i + 1] == '-') {
+                unsigned char hi = static_cast<unsigned char>(set[i + 2]);
+                if (lo <= hi) add_range(lo, hi);
+                i += 2;
+            } else {
+                add_range(lo, lo);
+            }
+        }
+    }
+
+    std::uint64_t bits_[4] = { 0, 0, 0, 0 };
+    Fold          fold_    = Fold::None;
+    std::size_t   max_     = 0;
+    bool          has_max_ = false;
+};
+
+} // namespace newt_entry_filter
@@ -0,0 +1,42 @@
+#pragma once
+
+/**
+ * newt_entry_validator.hpp
+ *
+ * Validation rules for EntrySetValidator / FormValidate: a POSIX extended
+ * regular expression, compiled once when the rule is set, and the message
+ * to report when an entry's value does not match it.
+ *
+ * Matching follows bash's [[ value =~ regex ]]: the expression may match
+ * anywhere in the value, so anchor it with ^…$ to constrain the whole value.
+ */
+
+#include <regex>
+#include <string>
+
+class EntryValidator {
+public:
+    // Compiles 'pattern'.  On error returns false with the reason in 'error'
+    // and leaves the validator unchanged.
+    bool compile(const std::string& pattern, const std::string& message, std::string& error) {
+        try {
+            re_ = std::regex(pattern, std::regex::extended | std::regex::nosubs);
+        } catch (const std::regex_error& e) {
+            error = e.what();
+            return false;
+        }
+        pattern_ = pattern;
+        message_ = message.empty() ? "does not match " + pattern : message;
+        return true;
+    }
+
+    bool check(const std::string& value) const { return std::regex_search(value, re_); }
+
+    const std::string& pattern() const { return pattern_; }
+    const std::string& message() const { return message_; }
+
+private:
+    std::regex  re_;
+    std::string pattern_;
+    std::string message_;
+};
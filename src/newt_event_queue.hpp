@@ -0,0 +1,99 @@
+#pragma once
+
+/**
+ * newt_event_queue.hpp
+ *
+ * The queue behind EventsSetQueued / EventsDrain.  In queued mode the
+ * component callback and destroy shims do not evaluate bash code while
+ * libnewt is in the middle of handling a key; they push a small record here
+ * instead, and the script gets the whole batch with one EventsDrain.
+ *
+ * The queue is a fixed-size ring: when it is full the oldest event is
+ * dropped and counted, so a script that stops draining cannot make it grow
+ * without bound.  A pipe becomes readable when the queue goes from empty to
+ * non-empty and is emptied by take(); FormRun watches it so that it returns
+ * (reason CALLBACKS) as soon as there is something to drain.
+ */
+
+#include <cerrno>
+#include <cstddef>
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+class EventQueue {
+public:
+    enum class Type { Callback, Destroy };
+
+    struct Event {
+        Type        type = Type::Callback;
+        const void* co   = nullptr;
+        std::string data;            // the data string given with the callback
+    };
+
+    explicit EventQueue(std::size_t capacity = 4096)
+        : ring_(capacity ? capacity : 1) {}
+    EventQueue(const EventQueue&) = delete;
+    EventQueue& operator=(const EventQueue&) = delete;
+    ~EventQueue() {
+        for (int fd : pipe_)
+            if (fd >= 0) ::close(fd);
+    }
+
+    // Creates the wake-up pipe.  Returns false (errno set) on failure.
+    bool open() {
+        if (pipe_[0] >= 0) return true;
+        return ::pipe2(pipe_, O_CLOEXEC | O_NONBLOCK) == 0;
+    }
+
+    // Readable while events are queued; -1 before open().
+    int fd() const { return pipe_[0]; }
+
+    void push(Type type, const void* co, const std::string& data) {
+        if (count_ == ring_.size()) {
+            head_ = (head_ + 1) % ring_.size();
+            --count_;
+            ++dropped_;
+        }
+        Event& e = ring_[(head_ + count_) % ring_.size()];
+        e.type = type;
+        e.co   = co;
+        e.data = data;
+        if (count_++ == 0 && pipe_[1] >= 0) {
+            char c = 0;
+            ssize_t n;
+            while ((n = ::write(pipe_[1], &c, 1)) < 0 && errno == EINTR) {}
+        }
+    }
+
+    // The queued events, oldest first; the queue is left empty.
+    std::vector<Event> take() {
+        std::vector<Event> out;
+        out.reserve(count_);
+        for (; count_; --count_, head_ = (head_ + 1) % ring_.size())
+            out.push_back(std::move(ring_[head_]));
+        if (pipe_[0] >= 0) {
+            char buf[64];
+            while (::read(pipe_[0], buf, sizeof(buf)) > 0) {}
+        }
+        return out;
+    }
+
+    // Events dropped because the queue was full, since the last call.
+    std::size_t take_dropped() {
+        std::size_t d = dropped_;
+        dropped_ = 0;
+        return d;
+    }
+
+    std::size_t size() const     { return count_; }
+    std::size_t capacity() const { return ring_.size(); }
+
+private:
+    std::vector<Event> ring_;
+    std::size_t        head_    = 0;
+    std::size_t        count_   = 0;
+    std::size_t        dropped_ = 0;
+    int                pipe_[2] = { -1, -1 };
+};
@@ -0,0 +1,203 @@
+#pragma once
+
+/**
+ * newt_form_registry.hpp
+ *
+ * What the builtin knows about the value-holding components it created and
+ * the forms they were added to.  libnewt components are opaque and cannot be
+ * asked for their type, so the constructors record each component's kind
+ * here and FormAddComponent(s) records which form it belongs to, in order.
+ * FormCollect walks that list instead of the script calling one getter per
+ * field.
+ *
+ * Radio buttons are grouped by the first button of their group: a group is
+ * one field, keyed and read through that button.
+ *
+ * Change tracking (FormGetChanged): the component callbacks mark fields as
+ * touched while a form runs.  When the run ends, only touched fields are read
+ * and compared with the value seen at the end of the previous run (or, for
+ * the first run, at its start); those that differ are the run's changes.
+ *
+ * Components are plain pointers here; the registry never dereferences them.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class FormRegistry {
+public:
+    enum class Kind { Entry, Checkbox, Radio, Listbox, Scale, CheckboxTree };
+
+    struct Component {
+        Kind               kind;
+        const void*        group = nullptr;   // radio: first button of the group
+        const void*        form  = nullptr;   // form it was added to, if any
+        std::string        id;                // user-assigned key, may be empty
+        unsigned long long scale = 0;         // last amount set on a scale
+        unsigned long long scale_full = 0;    // full value the scale was created with
+        bool               touched = false;   // callback fired during this run
+        bool               seen_valid = false;
+        std::string        seen;              // value at the end of the last run
+    };
+
+    // One value to collect: a component, or the first button of a radio group.
+    struct Field {
+        const void* co;
+        const Component* info;
+    };
+
+    // Records a new component.  For radio buttons 'prev' is the previous
+    // button of the group (nullptr for the first).
+    void created(const void* co, Kind kind, const void* prev = nullptr) {
+        Component c{};
+        c.kind = kind;
+        if (kind == Kind::Radio) {
+            const Component* p = find(prev);
+            c.group = (p && p->kind == Kind::Radio) ? p->group : co;
+        }
+        components_[co] = c;
+    }
+
+    Component* find(const void* co) {
+        auto it = components_.find(co);
+        return it == components_.end() ? nullptr : &it->second;
+    }
+    const Component* find(const void* co) const {
+        auto it = components_.find(co);
+        return it == components_.end() ? nullptr : &it->second;
+    }
+
+    // Records that 'co' was added to 'form'.  Components the builtin did not
+    // create, and repeated adds, are ignored.
+    void added(const void* form, const void* co) {
+        Component* c = find(co);
+        if (!c || c->form == form) return;
+        if (c->form) unlink(c->form, co);
+        c->form = form;
+        forms_[form].push_back(co);
+    }
+
+    // Registered components of 'form' in the order they were added.
+    const std::vector<const void*>& members(const void* form) const {
+        static const std::vector<const void*> none;
+        auto it = forms_.find(form);
+        return it == forms_.end() ? none : it->second;
+    }
+
+    // The fields of 'form': every member, except that a radio group appears
+    // once, at the position of its first member, as its first button.
+    std::vector<Field> fields(const void* form) const {
+        std::vector<Field> out;
+        std::unordered_set<const void*> groups;
+        for (const void* co : members(form)) {
+            const Component* c = find(co);
+            if (c->kind == Kind::Radio) {
+                if (!groups.insert(c->group).second) continue;
+                const Component* g = find(c->group);
+                out.push_back(g ? Field{ c->group, g } : Field{ co, c });
+            } else {
+                out.push_back({ co, c });
+            }
+        }
+        return out;
+    }
+
+    // Marks the field 'co' belongs to as touched.  Unknown components are
+    // ignored.
+    void touch(const void* co) {
+        Component* c = find(co);
+        if (!c) return;
+        if (c->kind == Kind::Radio) {
+            Component* g = find(c->group);
+            if (g) c = g;
+        }
+        c->touched = true;
+    }
+
+    // Start of a run of 'form': records the value of every field that has
+    // none yet, and forgets touches made outside a run.  'value' maps a field
+    // (co, const Component&) to its current value.
+    template <class ValueFn>
+    void run_started(const void* form, ValueFn value) {
+        for (const auto& f : fields(form)) {
+            Component& c = *find(f.co);
+            c.touched = false;
+            if (!c.seen_valid) {
+                c.seen       = value(f.co, c);
+                c.seen_valid = true;
+            }
+        }
+    }
+
+    // End of a run of 'form', with 'focused' (which may not have reported its
+    // edit yet, e.g. an entry) counted as touched.  Rereads touched fields and
+    // returns those whose value differs from the one seen last.
+    template <class ValueFn>
+    const std::vector<const void*>& run_finished(const void* form, const void* focused,
+                                                 ValueFn value) {
+        touch(focused);
+        auto& changed = changed_[form];
+        changed.clear();
+        for (const auto& f : fields(form)) {
+            Component& c = *find(f.co);
+            if (!c.touched) continue;
+            c.touched = false;
+            std::string v = value(f.co, c);
+            if (c.seen_valid && v == c.seen) continue;
+            c.seen       = std::move(v);
+            c.seen_valid = true;
+            changed.push_back(f.co);
+        }
+        return changed;
+    }
+
+    // Fields changed in the last run of 'form', in field order.
+    const std::vector<const void*>& changed(const void* form) const {
+        static const std::vector<const void*> none;
+        auto it = changed_.find(form);
+        return it == changed_.end() ? none : it->second;
+    }
+
+    // Forgets 'co', both as a component and as a form.
+    void destroyed(const void* co) {
+        auto it = components_.find(co);
+        if (it != components_.end()) {
+            if (it->second.form) unlink(it->second.form, co);
+            components_.erase(it);
+        }
+        changed_.erase(co);
+        auto f = forms_.find(co);
+        if (f != forms_.end()) {
+            for (const void* m : f->second) {
+                Component* c = find(m);
+                if (c) c->form = nullptr;
+            }
+            forms_.erase(f);
+        }
+    }
+
+private:
+    void unlink(const void* form, const void* co) {
+        auto f = forms_.find(form);
+        if (f == forms_.end()) return;
+        auto& v = f->second;
+        v.erase(std::remove(v.begin(), v.end(), co), v.end());
+        // newtFormDestroy does not run the form's own destroy callback, so
+        // this is where a destroyed form's entry goes away.
+        auto c = changed_.find(form);
+        if (c != changed_.end())
+            c->second.erase(std::remove(c->second.begin(), c->second.end(), co), c->second.end());
+        if (v.empty()) {
+            forms_.erase(f);
+            changed_.erase(form);
+        }
+    }
+
+    std::unordered_map<const void*, Component>                components_;
+    std::unordered_map<const void*, std::vector<const void*>> forms_;
+    std::unordered_map<const void*, std::vector<const void*>> changed_;
+};
@@ -0,0 +1,114 @@
+#pragma once
+
+/**
+ * newt_form_snapshot.hpp
+ *
+ * Text encoding of a form's state for FormSnapshot / FormRestore.  A snapshot
+ * is a list of records, one per field of the form (see FormRegistry::fields)
+ * plus one for the form itself; each record is a one-character tag followed
+ * by string values:
+ *
+ *   F focus scroll        form: member position of the focused component
+ *                         (-1 if it is not a field), scroll position
+ *   E value cursor        entry
+ *   C value               checkbox
+ *   R position            radio group: member position of the selected button
+ *   L current selected    listbox: current data key, selected keys
+ *   S amount              scale
+ *   T current values      checkbox tree: current data key, "key=char …"
+ *
+ * Encoded form: a version line "newt-snapshot 1", then one line per record
+ * with the tag and the values separated by tabs.  '%', tab, newline and CR
+ * inside values are written as %25, %09, %0A and %0D, so any entry text
+ * round-trips and the result is safe to keep in a bash variable.
+ */
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace newt_form_snapshot {
+
+struct Record {
+    char                     tag = 0;
+    std::vector<std::string> values;
+};
+
+constexpr const char* kHeader = "newt-snapshot 1";
+
+inline void escape_into(std::string& out, const std::string& s) {
+    for (char c : s) {
+        switch (c) {
+        case '%':  out += "%25"; break;
+        case '\t': out += "%09"; break;
+        case '\n': out += "%0A"; break;
+        case '\r': out += "%0D"; break;
+        default:   out += c;
+        }
+    }
+}
+
+inline int hex_digit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+// Reverses escape_into() on s[begin, end).  Returns false on a malformed
+// escape.
+inline bool unescape(const std::string& s, std::size_t begin, std::size_t end,
+                     std::string& out) {
+    out.clear();
+    for (std::size_t i = begin; i < end; ++i) {
+        if (s[i] != '%') { out += s[i]; continue; }
+        if (i + 2 >= end) return false;
+        int hi = hex_digit(s[i + 1]), lo = hex_digit(s[i + 2]);
+        if (hi < 0 || lo < 0) return false;
+        out += static_cast<char>(hi * 16 + lo);
+        i += 2;
+    }
+    return true;
+}
+
+inline std::string encode(const std::vector<Record>& records) {
+    std::string out(kHeader);
+    for (const auto& r : records) {
+        out += '\n';
+        out += r.tag;
+        for (const auto& v : r.values) {
+            out += '\t';
+            escape_into(out, v);
+        }
+    }
+    return out;
+}
+
+// Parses a string produced by encode().  Returns false if it is not one.
+inline bool decode(const std::string& s, std::vector<Record>& records) {
+    records.clear();
+    std::size_t pos = s.find('\n');
+    if (s.compare(0, pos == std::string::npos ? s.size() : pos, kHeader) != 0) return false;
+    while (pos != std::string::npos) {
+        std::size_t begin = pos + 1;
+        pos = s.find('\n', begin);
+        std::size_t end = pos == std::string::npos ? s.size() : pos;
+        if (end == begin) return false;
+
+        Record r;
+        r.tag = s[begin];
+        std::size_t f = begin + 1;
+        while (f < end) {
+            if (s[f] != '\t') return false;
+            std::size_t g = s.find('\t', f + 1);
+            if (g == std::string::npos || g > end) g = end;
+            r.values.emplace_back();
+            if (!unescape(s, f + 1, g, r.values.back())) return false;
+            f = g;
+        }
+        records.push_back(std::move(r));
+    }
+    return true;
+}
+
+} // namespace newt_form_snapshot
@@ -0,0 +1,307 @@
+#pragma once
+
+/**
+ * newt_fuzzy.hpp
+ *
+ * fzf-style fuzzy matching for FuzzyPicker.
+ *
+ * A row matches when the query characters appear in it in order (ASCII case
+ * is ignored).  The match is first found greedily left to right, then
+ * tightened right to left so that "ab" in "a_xxx_ab" scores the adjacent
+ * pair instead of the first 'a'.  Matched characters earn points; extra
+ * points go to consecutive matches and to matches at word starts ('/', '-',
+ * '_', '.', ' ' boundaries, camelCase humps, the first digit of a number).
+ * Gaps cost points.  Ties go to the shorter row, then to the earlier one.
+ *
+ * FuzzyMatcher scores a RowStore either on the calling thread or across a
+ * ThreadPool.  Rows are handed out in fixed-size chunks from an atomic cursor,
+ * each worker keeps only its best `limit` rows (nth_element), and the last
+ * worker merges them with partial_sort.  Starting a new run bumps a
+ * generation counter; workers of older runs notice it between chunks and
+ * stop, and their results are thrown away.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "newt_row_store.hpp"
+#include "newt_thread_pool.hpp"
+
+namespace newt_fuzzy {
+
+inline char fold(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+inline std::string prepare_query(const std::string& q) {
+    std::string r(q);
+    for (char& c : r) c = fold(c);
+    return r;
+}
+
+inline bool is_alnum(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+}
+
+// True if s[i] starts a "word" within s.
+inline bool word_start(const char* s, std::size_t i) {
+    if (i == 0) return true;
+    char p = s[i - 1], c = s[i];
+    if (!is_alnum(p)) return is_alnum(c);
+    if (p >= 'a' && p <= 'z' && c >= 'A' && c <= 'Z') return true;
+    return !(p >= '0' && p <= '9') && (c >= '0' && c <= '9');
+}
+
+constexpr int kScoreMatch       = 16;
+constexpr int kBonusWordStart   = 8;
+constexpr int kBonusConsecutive = 6;
+constexpr int kPenaltyGapStart  = 3;
+constexpr int kPenaltyGapExtend = 1;
+
+// Score of s[0, n) against a prepared, non-empty query, or -1 if it does not
+// match.
+inline int score(const char* s, std::size_t n, const std::string& needle) {
+    const std::size_t m = needle.size();
+    if (m > n) return -1;
+
+    // Forward pass: earliest end of a match.
+    std::size_t j = 0, end = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (fold(s[i]) == needle[j] && ++j == m) { end = i; break; }
+    }
+    if (j < m) return -1;
+
+    // Backward pass: latest start of a match ending at 'end'.
+    std::size_t start = end;
+    for (std::size_t i = end + 1, k = m; i-- > 0; ) {
+        if (fold(s[i]) == needle[k - 1] && --k == 0) { start = i; break; }
+    }
+
+    int  total = 0;
+    bool prev  = false;
+    j = 0;
+    for (std::size_t i = start; i <= end; ++i) {
+        if (j < m && fold(s[i]) == needle[j]) {
+            total += kScoreMatch;
+            if (word_start(s, i)) total += kBonusWordStart;
+            if (prev)             total += kBonusConsecutive;
+            prev = true;
+            ++j;
+        } else {
+            total -= prev ? kPenaltyGapStart : kPenaltyGapExtend;
+            prev = false;
+        }
+    }
+    return total < 0 ? 0 : total;
+}
+
+struct Scored {
+    int           score;
+    std::uint32_t length;
+    std::uint32_t index;
+};
+
+inline bool better(const Scored& a, const Scored& b) {
+    if (a.score  != b.score)  return a.score  > b.score;
+    if (a.length != b.length) return a.length < b.length;
+    return a.index < b.index;
+}
+
+// Drops everything but the best 'limit' entries (unordered).
+inline void keep_best(std::vector<Scored>& v, std::size_t limit) {
+    if (v.size() <= limit) return;
+    std::nth_element(v.begin(), v.begin() + limit, v.end(), better);
+    v.resize(limit);
+}
+
+// Scores rows [begin, end) and appends the matches to 'out', trimming it to
+// the best 'limit' whenever it grows past twice that.
+inline void score_range(const RowStore& rows, const std::string& needle,
+                        std::size_t begin, std::size_t end, std::size_t limit,
+                        std::vector<Scored>& out, std::size_t& matches) {
+    for (std::size_t i = begin; i < end; ++i) {
+        std::size_t len = rows.length(i);
+        int sc = score(rows[i], len, needle);
+        if (sc < 0) continue;
+        ++matches;
+        out.push_back({sc, static_cast<std::uint32_t>(len), static_cast<std::uint32_t>(i)});
+        if (out.size() >= 2 * limit + 64) keep_best(out, limit);
+    }
+}
+
+struct Result {
+    std::uint64_t              generation = 0;
+    std::vector<std::uint32_t> top;       // row indices, best first
+    std::size_t                matches = 0;
+};
+
+// Sorts the best 'limit' of 'v' into 'r.top'.
+inline void finish(std::vector<Scored>& v, std::size_t limit, Result& r) {
+    std::size_t k = std::min(limit, v.size());
+    std::partial_sort(v.begin(), v.begin() + k, v.end(), better);
+    r.top.resize(k);
+    for (std::size_t i = 0; i < k; ++i) r.top[i] = v[i].index;
+}
+
+class FuzzyMatcher {
+public:
+    static constexpr std::size_t kChunk = 8192;
+
+    FuzzyMatcher(const RowStore& rows, std::size_t limit)
+        : rows_(rows), limit_(limit ? limit : 1) {}
+
+    FuzzyMatcher(const FuzzyMatcher&) = delete;
+    FuzzyMatcher& operator=(const FuzzyMatcher&) = delete;
+
+    ~FuzzyMatcher() {
+        cancel();
+        wait();
+    }
+
+    // Scores every row on the calling thread.  An empty query matches every
+    // row in its original order.
+    Result run(const std::string& query) const {
+        Result r;
+        std::string needle = prepare_query(query);
+        if (needle.empty()) {
+            r.matches = rows_.size();
+            r.top.resize(std::min(limit_, rows_.size()));
+            for (std::size_t i = 0; i < r.top.size(); ++i)
+                r.top[i] = static_cast<std::uint32_t>(i);
+            return r;
+        }
+        std::vector<Scored> best;
+        score_range(rows_, needle, 0, rows_.size(), limit_, best, r.matches);
+        finish(best, limit_, r);
+        return r;
+    }
+
+    // Starts scoring 'query' on 'pool' and returns at once, cancelling any
+    // earlier run.  When the run completes without being superseded its
+    // result is kept for take() and one byte is written to 'notify_fd'.
+    // Returns the generation of the new run.
+    std::uint64_t start(ThreadPool& pool, const std::string& query, int notify_fd) {
+        auto job = std::make_shared<Job>();
+        job->generation = ++generation_;
+        job->needle     = prepare_query(query);
+        job->notify_fd  = notify_fd;
+
+        if (job->needle.empty()) {
+            Result r = run(query);
+            r.generation = job->generation;
+            publish(std::move(r), notify_fd);
+            return job->generation;
+        }
+
+        std::size_t chunks  = (rows_.size() + kChunk - 1) / kChunk;
+        unsigned    workers = static_cast<unsigned>(
+            std::max<std::size_t>(1, std::min<std::size_t>(pool.size(), chunks)));
+        job->workers_left = workers;
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            ++inflight_;
+        }
+        for (unsigned w = 0; w < workers; ++w)
+            pool.post([this, job] { work(*job); });
+        return job->generation;
+    }
+
+    // Moves the pending result, if any, into 'out'.
+    bool take(Result& out) {
+        std::lock_guard<std::mutex> lk(m_);
+        if (!has_result_) return false;
+        out = std::move(result_);
+        has_result_ = false;
+        return true;
+    }
+
+    // Makes every run in flight stale; their results will be discarded.
+    void cancel() { ++generation_; }
+
+    // Blocks until no run is in flight.
+    void wait() {
+        std::unique_lock<std::mutex> lk(m_);
+        done_cv_.wait(lk, [this] { return inflight_ == 0; });
+    }
+
+    std::uint64_t generation() const { return generation_; }
+
+private:
+    struct Job {
+        std::uint64_t            generation = 0;
+        std::string              needle;
+        int                      notify_fd  = -1;
+        std::atomic<std::size_t> next{0};
+        std::atomic<unsigned>    workers_left{0};
+        std::mutex               m;
+        std::vector<Scored>      best;
+        std::size_t              matches = 0;
+    };
+
+    bool stale(const Job& job) const { return generation_ != job.generation; }
+
+    void work(Job& job) {
+        std::vector<Scored> best;
+        std::size_t matches = 0;
+        while (!stale(job)) {
+            std::size_t begin = job.next.fetch_add(kChunk);
+            if (begin >= rows_.size()) break;
+            std::size_t end = std::min(begin + kChunk, rows_.size());
+            score_range(rows_, job.needle, begin, end, limit_, best, matches);
+        }
+        if (!stale(job)) {
+            keep_best(best, limit_);
+            std::lock_guard<std::mutex> lk(job.m);
+            job.best.insert(job.best.end(), best.begin(), best.end());
+            job.matches += matches;
+        }
+
+        if (--job.workers_left > 0) return;
+
+        // Last worker out merges and publishes.
+        if (!stale(job)) {
+            Result r;
+            r.generation = job.generation;
+            r.matches    = job.matches;
+            finish(job.best, limit_, r);
+            publish(std::move(r), job.notify_fd);
+        }
+        std::lock_guard<std::mutex> lk(m_);
+        --inflight_;
+        done_cv_.notify_all();
+    }
+
+    void publish(Result&& r, int notify_fd) {
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            if (r.generation != generation_) return;
+            result_     = std::move(r);
+            has_result_ = true;
+        }
+        if (notify_fd >= 0) {
+            char byte = 0;
+            ssize_t n = ::write(notify_fd, &byte, 1);
+            (void)n;   // a full pipe already has a wake-up pending
+        }
+    }
+
+    const RowStore&            rows_;
+    const std::size_t          limit_;
+    std::atomic<std::uint64_t> generation_{0};
+
+    std::mutex                 m_;
+    std::condition_variable    done_cv_;
+    unsigned                   inflight_   = 0;
+    bool                       has_result_ = false;
+    Result                     result_;
+};
+
+} // namespace newt_fuzzy
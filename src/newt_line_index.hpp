@@ -0,0 +1,85 @@
+#pragma once
+
+/**
+ * newt_line_index.hpp
+ *
+ * Lazy, sparse line index over a read-only text buffer (typically an mmap'd
+ * file, see newt_mapped_file.hpp).  Only the start offset of every STRIDE-th
+ * line is remembered, so a 1 GB log with 20 M lines costs ~2.5 MB of index;
+ * any other line is found by scanning at most STRIDE-1 newlines forward from
+ * the nearest checkpoint.  The buffer is scanned only as far as the highest
+ * line requested so far, so opening a huge file and showing its first page
+ * touches only the first few kilobytes.
+ *
+ * Newline search uses memchr, which glibc implements with SIMD.
+ *
+ * Line model: lines are separated by '\n'; a trailing '\n' does not start an
+ * extra empty line; an empty buffer has zero lines.
+ */
+
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+class LineIndex {
+public:
+    static constexpr std::size_t STRIDE = 64;
+    static constexpr std::size_t npos   = static_cast<std::size_t>(-1);
+
+    void reset(const char* data, std::size_t size) {
+        data_     = data;
+        size_     = size;
+        known_    = 0;
+        next_     = 0;
+        complete_ = (size == 0);
+        checkpoints_.clear();
+    }
+
+    // Offset of the first byte of line n, or npos if there is no such line.
+    std::size_t line_start(std::size_t n) {
+        while (!complete_ && known_ <= n) step();
+        if (n >= known_) return npos;
+        std::size_t p = checkpoints_[n / STRIDE];
+        for (std::size_t i = n % STRIDE; i > 0; --i)
+            p = line_end(p) + 1;
+        return p;
+    }
+
+    // Offset one past the last byte of the line starting at 'start' (i.e. the
+    // offset of its '\n', or the buffer size for an unterminated last line).
+    std::size_t line_end(std::size_t start) const {
+        const void* nl = std::memchr(data_ + start, '\n', size_ - start);
+        return nl ? static_cast<std::size_t>(static_cast<const char*>(nl) - data_)
+                  : size_;
+    }
+
+    // Total number of lines.  Scans the rest of the buffer on first call.
+    std::size_t line_count() {
+        while (!complete_) step();
+        return known_;
+    }
+
+    // True once the whole buffer has been scanned.
+    bool complete() const { return complete_; }
+
+private:
+    // Discovers the start of line 'known_' (which begins at next_) and the
+    // start of the line after it.
+    void step() {
+        if (known_ % STRIDE == 0) checkpoints_.push_back(next_);
+        ++known_;
+        std::size_t end = line_end(next_);
+        if (end + 1 >= size_) {
+            complete_ = true;
+        } else {
+            next_ = end + 1;
+        }
+    }
+
+    const char*              data_     = nullptr;
+    std::size_t              size_     = 0;
+    std::size_t              known_    = 0;      // lines whose start is known
+    std::size_t              next_     = 0;      // start of line 'known_'
+    bool                     complete_ = true;
+    std::vector<std::size_t> checkpoints_;       // start of line k*STRIDE
+};
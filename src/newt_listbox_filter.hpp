@@ -0,0 +1,156 @@
+#pragma once
+
+/**
+ * newt_listbox_filter.hpp
+ *
+ * Substring matching and entry-edit prediction for ListboxFilterBind, which
+ * narrows a listbox to the rows containing the text typed into an entry.
+ *
+ * Matching scans each row with memchr for the first byte of the query (glibc
+ * memchr is SIMD) and only compares the rest at the candidate positions.
+ * Case-insensitive matching folds ASCII letters only; the query is folded
+ * once up front and, when its first byte is a letter, both cases of that byte
+ * are searched for.  When a keystroke only extends the query, the new matches
+ * are a subset of the previous ones and only those rows are rescanned.
+ *
+ * libnewt calls entry filters *before* applying the key, so the new entry
+ * value is predicted from the old value, the cursor and the key.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "newt_row_store.hpp"
+
+namespace newt_listbox_filter {
+
+inline char fold_ascii(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+// Query in the form expected by contains(): ASCII-lowercased when folding.
+inline std::string prepare_query(const std::string& q, bool fold) {
+    if (!fold) return q;
+    std::string r(q);
+    for (char& c : r) c = fold_ascii(c);
+    return r;
+}
+
+// True if 'needle' (already prepared) occurs in hay[0, hlen).
+inline bool contains(const char* hay, std::size_t hlen,
+                     const std::string& needle, bool fold) {
+    std::size_t nlen = needle.size();
+    if (nlen == 0) return true;
+    if (nlen > hlen) return false;
+
+    const char* end   = hay + hlen - nlen + 1;   // last possible start + 1
+    const char  first = needle[0];
+    const char  upper = (fold && first >= 'a' && first <= 'z')
+                        ? static_cast<char>(first - 'a' + 'A') : first;
+
+    auto tail_matches = [&](const char* p) {
+        if (!fold) return std::memcmp(p + 1, needle.data() + 1, nlen - 1) == 0;
+        for (std::size_t i = 1; i < nlen; ++i)
+            if (fold_ascii(p[i]) != needle[i]) return false;
+        return true;
+    };
+
+    if (upper == first) {
+        for (const char* p = hay; p < end; ++p) {
+            p = static_cast<const char*>(std::memchr(p, first, end - p));
+            if (!p) return false;
+            if (tail_matches(p)) return true;
+        }
+        return false;
+    }
+
+    // Letter under folding: track the next occurrence of each case and take
+    // the nearer one, re-searching only the case that was consumed.
+    const char* lo = static_cast<const char*>(std::memchr(hay, first, end - hay));
+    const char* up = static_cast<const char*>(std::memchr(hay, upper, end - hay));
+    while (lo || up) {
+        const char* p = (!up || (lo && lo < up)) ? lo : up;
+        if (tail_matches(p)) return true;
+        if (p == lo) lo = static_cast<const char*>(std::memchr(p + 1, first, end - p - 1));
+        else         up = static_cast<const char*>(std::memchr(p + 1, upper, end - p - 1));
+    }
+    return false;
+}
+
+// Indices of all rows matching 'needle' (prepared).
+inline void match_all(const RowStore& rows, const std::string& needle, bool fold,
+                      std::vector<std::uint32_t>& out) {
+    out.clear();
+    for (std::size_t i = 0; i < rows.size(); ++i)
+        if (contains(rows[i], rows.length(i), needle, fold))
+            out.push_back(static_cast<std::uint32_t>(i));
+}
+
+// Indices among 'prev' (ascending) matching 'needle'.  Valid whenever every
+// row matching 'needle' is known to be in 'prev'.
+inline void match_subset(const RowStore& rows, const std::string& needle, bool fold,
+                         const std::vector<std::uint32_t>& prev,
+                         std::vector<std::uint32_t>& out) {
+    out.clear();
+    for (std::uint32_t i : prev)
+        if (contains(rows[i], rows.length(i), needle, fold))
+            out.push_back(i);
+}
+
+// ─── entry edit prediction ────────────────────────────────────────────────────
+
+enum class EditOp {
+    None,          // cursor movement, Enter, Tab, … — value unchanged
+    Insert,        // insert the byte 'ch' at the cursor
+    Backspace,     // delete the character before the cursor
+    Delete,        // delete the character at the cursor
+    KillToEnd,     // ^K
+    KillToStart,   // ^U
+};
+
+inline bool utf8_continuation(char c) {
+    return (static_cast<unsigned char>(c) & 0xC0) == 0x80;
+}
+
+// Value of an entry holding 'value' with the cursor at byte offset 'cursor'
+// after applying 'op'.  Multi-byte UTF-8 characters are deleted whole.
+inline std::string predict_edit(const std::string& value, int cursor, EditOp op,
+                                int ch = 0) {
+    std::size_t cur = cursor < 0 ? 0 : static_cast<std::size_t>(cursor);
+    if (cur > value.size()) cur = value.size();
+    std::string r(value);
+
+    switch (op) {
+    case EditOp::None:
+        break;
+    case EditOp::Insert:
+        r.insert(cur, 1, static_cast<char>(ch));
+        break;
+    case EditOp::Backspace:
+        if (cur > 0) {
+            std::size_t s = cur - 1;
+            while (s > 0 && utf8_continuation(r[s])) --s;
+            r.erase(s, cur - s);
+        }
+        break;
+    case EditOp::Delete:
+        if (cur < r.size()) {
+            std::size_t e = cur + 1;
+            while (e < r.size() && utf8_continuation(r[e])) ++e;
+            r.erase(cur, e - cur);
+        }
+        break;
+    case EditOp::KillToEnd:
+        r.erase(cur);
+        break;
+    case EditOp::KillToStart:
+        r.erase(0, cur);
+        break;
+    }
+    return r;
+}
+
+} // namespace newt_listbox_filter
@@ -0,0 +1,96 @@
+#pragma once
+
+/**
+ * newt_listbox_sort.hpp
+ *
+ * Orderings for ListboxSort.  Rows are sorted as a permutation of their
+ * positions so that text, data key and selection state travel together; all
+ * orderings are stable, so rows that compare equal keep their relative order
+ * (descending order reverses the comparison, not the result).
+ *
+ *   text         byte-wise comparison (strcmp), independent of the locale
+ *   textNumeric  natural order: runs of ASCII digits compare by numeric value,
+ *                so "file9" < "file10"; everything else compares byte-wise
+ *   data         the data key as an unsigned integer
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "newt_thread_pool.hpp"
+
+namespace newt_listbox_sort {
+
+enum class Key { Text, TextNumeric, Data };
+
+inline bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+// Natural-order three-way comparison.  Numbers with the same value but more
+// leading zeros sort after the shorter spelling ("7" < "07"); remaining ties
+// are broken byte-wise so the order is total.
+inline int natural_compare(const char* a, const char* b) {
+    const char* a0 = a;
+    const char* b0 = b;
+    int zeros = 0;   // first difference in leading-zero count
+    while (*a && *b) {
+        if (is_digit(*a) && is_digit(*b)) {
+            const char* za = a; while (*za == '0') ++za;
+            const char* zb = b; while (*zb == '0') ++zb;
+            const char* ea = za; while (is_digit(*ea)) ++ea;
+            const char* eb = zb; while (is_digit(*eb)) ++eb;
+            if (ea - za != eb - zb) return (ea - za) < (eb - zb) ? -1 : 1;
+            int c = std::memcmp(za, zb, static_cast<std::size_t>(ea - za));
+            if (c) return c < 0 ? -1 : 1;
+            if (!zeros && (za - a) != (zb - b)) zeros = (za - a) < (zb - b) ? -1 : 1;
+            a = ea;
+            b = eb;
+            continue;
+        }
+        if (*a != *b)
+            return static_cast<unsigned char>(*a) < static_cast<unsigned char>(*b) ? -1 : 1;
+        ++a;
+        ++b;
+    }
+    if (*a || *b) return *a ? 1 : -1;
+    if (zeros) return zeros;
+    int c = std::strcmp(a0, b0);
+    return c < 0 ? -1 : (c > 0 ? 1 : 0);
+}
+
+// Stable permutation of 0..texts.size()-1 ordering the rows by 'key'.
+// Large inputs are sorted on 'pool' (see parallel_stable_sort).
+inline std::vector<std::uint32_t> sorted_order(const std::vector<const char*>& texts,
+                                               const std::vector<void*>& data,
+                                               Key key, bool descending,
+                                               ThreadPool& pool) {
+    std::vector<std::uint32_t> order(texts.size());
+    for (std::size_t i = 0; i < order.size(); ++i) order[i] = static_cast<std::uint32_t>(i);
+
+    auto three_way = [&](std::uint32_t x, std::uint32_t y) -> int {
+        switch (key) {
+        case Key::Text: {
+            int c = std::strcmp(texts[x], texts[y]);
+            return c < 0 ? -1 : (c > 0 ? 1 : 0);
+        }
+        case Key::TextNumeric:
+            return natural_compare(texts[x], texts[y]);
+        case Key::Data: {
+            auto dx = reinterpret_cast<std::uintptr_t>(data[x]);
+            auto dy = reinterpret_cast<std::uintptr_t>(data[y]);
+            return dx < dy ? -1 : (dx > dy ? 1 : 0);
+        }
+        }
+        return 0;
+    };
+    if (descending)
+        parallel_stable_sort(pool, order.begin(), order.end(),
+                             [&](std::uint32_t x, std::uint32_t y) { return three_way(x, y) > 0; });
+    else
+        parallel_stable_sort(pool, order.begin(), order.end(),
+                             [&](std::uint32_t x, std::uint32_t y) { return three_way(x, y) < 0; });
+    return order;
+}
+
+} // namespace newt_listbox_sort
@@ -0,0 +1,81 @@
+#pragma once
+
+/**
+ * newt_mapped_file.hpp
+ *
+ * Minimal RAII wrapper around a read-only private mmap of a whole file.
+ * The mapping is released when the object is destroyed or re-opened, so it
+ * can live inside the per-component state maps in newt_wrappers.cpp.
+ *
+ * Touching a page past the end of a file that was truncated after mapping
+ * raises SIGBUS (a log rotated with copytruncate, say), so the descriptor is
+ * kept open: callers check shrunk() before reading and remap() if it is.
+ */
+
+#include <cerrno>
+#include <cstddef>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() { close(); }
+
+    // Maps 'path'.  Returns false with errno set on failure.  Empty files
+    // succeed with size() == 0 and data() == nullptr.
+    bool open(const char* path) {
+        close();
+        fd_ = ::open(path, O_RDONLY | O_CLOEXEC);
+        if (fd_ < 0) return false;
+        if (!remap()) { int e = errno; close(); errno = e; return false; }
+        return true;
+    }
+
+    // True if the file is now shorter than the mapping.
+    bool shrunk() const {
+        struct stat sb;
+        return fd_ >= 0 && ::fstat(fd_, &sb) == 0 &&
+               static_cast<std::size_t>(sb.st_size) < size_;
+    }
+
+    // Maps the file again at its current size.  Returns false with errno set
+    // (and nothing mapped) on failure.
+    bool remap() {
+        unmap();
+        struct stat sb;
+        if (::fstat(fd_, &sb) < 0) return false;
+        if (sb.st_size > 0) {
+            void* p = ::mmap(nullptr, static_cast<std::size_t>(sb.st_size),
+                             PROT_READ, MAP_PRIVATE, fd_, 0);
+            if (p == MAP_FAILED) return false;
+            data_ = static_cast<const char*>(p);
+            size_ = static_cast<std::size_t>(sb.st_size);
+        }
+        return true;
+    }
+
+    void close() {
+        unmap();
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = -1;
+    }
+
+    const char* data() const { return data_; }
+    std::size_t size() const { return size_; }
+
+private:
+    void unmap() {
+        if (data_) ::munmap(const_cast<char*>(data_), size_);
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+    int         fd_   = -1;
+};
@@ -0,0 +1,228 @@
+#pragma once
+
+/**
+ * newt_output_stats.hpp
+ *
+ * Accounting of the bytes S-Lang writes to the terminal, for OutputStats.
+ *
+ * CountingPipe is the interposed layer: S-Lang's output fd is pointed at the
+ * write end of a pipe, and a forwarding thread copies everything to the real
+ * terminal while counting it.  total() is exact at any moment on the writer's
+ * side (bytes forwarded plus bytes still queued in the pipe), so a frame's
+ * size does not depend on how far the thread has got.  drain() waits until
+ * everything written so far has reached the terminal, which matters before
+ * the shell writes to the terminal itself (after newtFinished, newtSuspend).
+ * stop() wakes the thread through a pipe of its own rather than waiting for
+ * EOF: every process bash forks without exec'ing (coprocs, background
+ * subshells) inherits the write end, so EOF may never come.  Like the pool
+ * workers, the thread starts with every signal blocked.
+ *
+ * FrameStats turns the running total into per-frame figures: a frame is one
+ * Refresh, DrawForm or form run, bracketed by begin()/end().  Frames started
+ * while another is open (a callback refreshing inside a form run) belong to
+ * the outer frame.
+ */
+
+#include "newt_thread_pool.hpp"
+
+#include <cerrno>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <fcntl.h>
+#include <mutex>
+#include <poll.h>
+#include <string>
+#include <sys/ioctl.h>
+#include <thread>
+#include <unistd.h>
+
+class CountingPipe {
+public:
+    CountingPipe() = default;
+    CountingPipe(const CountingPipe&) = delete;
+    CountingPipe& operator=(const CountingPipe&) = delete;
+    ~CountingPipe() { stop(); }
+
+    // Starts forwarding to 'target'.  Returns false (errno set) on failure.
+    bool start(int target) {
+        stop();
+        int p[2], q[2];
+        if (::pipe(p) < 0) return false;
+        if (::pipe2(q, O_CLOEXEC) < 0) {
+            int e = errno;
+            ::close(p[0]);
+            ::close(p[1]);
+            errno = e;
+            return false;
+        }
+        ::fcntl(p[0], F_SETFD, FD_CLOEXEC);
+        ::fcntl(p[1], F_SETFD, FD_CLOEXEC);
+        ::fcntl(p[0], F_SETFL, ::fcntl(p[0], F_GETFL) | O_NONBLOCK);
+        read_fd_  = p[0];
+        write_fd_ = p[1];
+        stop_[0]  = q[0];
+        stop_[1]  = q[1];
+        target_   = target;
+        counted_  = 0;
+        busy_     = false;
+        SignalsBlocked blocked;
+        thread_   = std::thread([this] { run(); });
+        return true;
+    }
+
+    bool active() const { return write_fd_ >= 0; }
+
+    // The fd to write through; -1 when not started.
+    int fd() const { return write_fd_; }
+
+    // Bytes written to fd() since start().
+    std::uint64_t total() {
+        std::lock_guard<std::mutex> lk(m_);
+        return counted_ + pending();
+    }
+
+    // Waits until everything written to fd() has been forwarded.
+    void drain() {
+        if (!active()) return;
+        std::unique_lock<std::mutex> lk(m_);
+        cv_.wait(lk, [this] { return !busy_ && pending() == 0; });
+    }
+
+    // Forwards what is queued in the pipe, then joins the thread and closes
+    // the pipes.  Does not wait for other holders of fd() to close it.
+    void stop() {
+        if (!active()) return;
+        ::close(write_fd_);
+        write_fd_ = -1;
+        char c = 0;
+        while (::write(stop_[1], &c, 1) < 0 && errno == EINTR) {}
+        thread_.join();
+        ::close(read_fd_);
+        ::close(stop_[0]);
+        ::close(stop_[1]);
+        read_fd_ = stop_[0] = stop_[1] = -1;
+    }
+
+private:
+    std::size_t pending() const {
+        int n = 0;
+        return ::ioctl(read_fd_, FIONREAD, &n) == 0 && n > 0 ? static_cast<std::size_t>(n) : 0;
+    }
+
+    void run() {
+        char buf[16384];
+        std::size_t left = 0;        // bytes to forward after stop()
+        bool stopping = false;
+        for (;;) {
+            if (!stopping) {
+                struct pollfd pfd[2] = { { read_fd_, POLLIN, 0 }, { stop_[0], POLLIN, 0 } };
+                if (::poll(pfd, 2, -1) < 0) {
+                    if (errno == EINTR) continue;
+                    break;
+                }
+                if (pfd[1].revents) {
+                    stopping = true;
+                    left = pending();
+                }
+            }
+            if (stopping && left == 0) break;
+            std::size_t want = stopping && left < sizeof(buf) ? left : sizeof(buf);
+            ssize_t n;
+            {
+                std::lock_guard<std::mutex> lk(m_);
+                n = ::read(read_fd_, buf, want);
+                if (n > 0) {
+                    counted_ += static_cast<std::uint64_t>(n);
+                    busy_ = true;
+                }
+            }
+            if (n == 0) break;
+            if (n < 0) {
+                if (errno == EINTR || (errno == EAGAIN && !stopping)) continue;
+                break;
+            }
+            if (stopping) left -= static_cast<std::size_t>(n);
+            for (ssize_t off = 0; off < n;) {
+                ssize_t w = ::write(target_, buf + off, static_cast<std::size_t>(n - off));
+                if (w < 0) {
+                    if (errno == EINTR) continue;
+                    break;               // terminal gone: drop the rest
+                }
+                off += w;
+            }
+            {
+                std::lock_guard<std::mutex> lk(m_);
+                busy_ = false;
+            }
+            cv_.notify_all();
+        }
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            busy_ = false;
+        }
+        cv_.notify_all();
+    }
+
+    int                     read_fd_  = -1;
+    int                     write_fd_ = -1;
+    int                     target_   = -1;
+    int                     stop_[2]  = { -1, -1 };
+    std::uint64_t           counted_  = 0;
+    bool                    busy_     = false;   // a chunk is being forwarded
+    std::mutex              m_;
+    std::condition_variable cv_;
+    std::thread             thread_;
+};
+
+class FrameStats {
+public:
+    // Forgets everything; 'total' is the byte counter's current value.
+    void reset(std::uint64_t total) {
+        *this = FrameStats();
+        base_ = total;
+    }
+
+    void begin(const std::string& label, std::uint64_t total) {
+        if (depth_++ == 0) {
+            start_ = total;
+            label_ = label;
+        }
+    }
+
+    void end(std::uint64_t total) {
+        if (depth_ == 0 || --depth_ > 0) return;
+        std::uint64_t n = total - start_;
+        ++frames_;
+        framed_ += n;
+        last_       = n;
+        last_label_ = label_;
+        if (frames_ == 1 || n > max_) {
+            max_       = n;
+            max_label_ = label_;
+        }
+    }
+
+    std::uint64_t bytes(std::uint64_t total) const { return total - base_; }
+    // Bytes written outside any frame (Init, Cls, window pops, …).  A frame
+    // still open counts as outside until it ends.
+    std::uint64_t idle(std::uint64_t total) const { return bytes(total) - framed_; }
+
+    std::uint64_t      frames() const     { return frames_; }
+    std::uint64_t      last() const       { return last_; }
+    const std::string& last_label() const { return last_label_; }
+    std::uint64_t      max() const        { return max_; }
+    const std::string& max_label() const  { return max_label_; }
+
+private:
+    std::uint64_t base_   = 0;
+    std::uint64_t start_  = 0;
+    std::uint64_t framed_ = 0;
+    std::uint64_t frames_ = 0;
+    std::uint64_t last_   = 0;
+    std::uint64_t max_    = 0;
+    int           depth_  = 0;
+    std::string   label_;
+    std::string   last_label_;
+    std::string   max_label_;
+};
@@ -0,0 +1,108 @@
+#pragma once
+
+/**
+ * newt_palette.hpp
+ *
+ * Named colour palettes for PaletteDefine / PaletteLoad / PaletteApply.  A
+ * palette holds the 44 colour strings of a struct newtColors, in field order
+ * (rootFg, rootBg, borderFg, … selListboxBg — see kColorsets), parsed once so
+ * that applying it is a single newtSetColors call.  Fields a palette does not
+ * set are left empty; the caller fills them from newtDefaultColorPalette.
+ *
+ * Colorsets are named as in NEWT_COLORS and the NEWT_COLORSET array (root,
+ * button, actsellistbox, …), case-insensitively.  A value is "fg,bg"; either
+ * half may be empty to leave it unset.  emptyscale and fullscale only have a
+ * background: their value is "bg" or ",bg".
+ *
+ * parse_colors() reads the NEWT_COLORS format: name=fg,bg items separated by
+ * ';', ':' or whitespace.  Unlike libnewt it rejects unknown names and
+ * malformed items instead of skipping them, so typos in palette files show.
+ */
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace newt_palette {
+
+constexpr int kFields = 44;
+
+struct Colorset {
+    std::string_view name;
+    int              fg;   // field index, -1 for the scales
+    int              bg;
+};
+
+// In NEWT_COLORSET order (ROOT = 2 … SELLISTBOX = 24).
+inline constexpr Colorset kColorsets[] = {
+    { "root",          0,  1 }, { "border",       2,  3 }, { "window",     4,  5 },
+    { "shadow",        6,  7 }, { "title",        8,  9 }, { "button",    10, 11 },
+    { "actbutton",    12, 13 }, { "checkbox",    14, 15 }, { "actcheckbox", 16, 17 },
+    { "entry",        18, 19 }, { "label",       20, 21 }, { "listbox",   22, 23 },
+    { "actlistbox",   24, 25 }, { "textbox",     26, 27 }, { "acttextbox", 28, 29 },
+    { "helpline",     30, 31 }, { "roottext",    32, 33 }, { "emptyscale", -1, 34 },
+    { "fullscale",    -1, 35 }, { "disentry",    36, 37 }, { "compactbutton", 38, 39 },
+    { "actsellistbox", 40, 41 }, { "sellistbox", 42, 43 },
+};
+
+struct Palette {
+    std::array<std::string, kFields> fields;   // "" = not set
+};
+
+inline bool iequals(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        char x = a[i], y = b[i];
+        if (x >= 'A' && x <= 'Z') x = static_cast<char>(x - 'A' + 'a');
+        if (y >= 'A' && y <= 'Z') y = static_cast<char>(y - 'A' + 'a');
+        if (x != y) return false;
+    }
+    return true;
+}
+
+inline const Colorset* find_colorset(std::string_view name) {
+    for (const auto& c : kColorsets)
+        if (iequals(c.name, name)) return &c;
+    return nullptr;
+}
+
+// Sets colorset 'name' to 'value' ("fg,bg", see the file comment).  Returns
+// false for an unknown name or a malformed value.
+inline bool set_colorset(Palette& p, std::string_view name, std::string_view value) {
+    const Colorset* c = find_colorset(name);
+    if (!c) return false;
+    std::size_t comma = value.find(',');
+    std::string_view fg = comma == std::string_view::npos ? std::string_view() : value.substr(0, comma);
+    std::string_view bg = comma == std::string_view::npos ? value : value.substr(comma + 1);
+    if (c->fg < 0) {
+        if (!fg.empty()) return false;
+    } else if (comma == std::string_view::npos) {
+        return false;
+    }
+    if (bg.find(',') != std::string_view::npos) return false;
+    if (!fg.empty()) p.fields[c->fg] = std::string(fg);
+    if (!bg.empty()) p.fields[c->bg] = std::string(bg);
+    return true;
+}
+
+// Applies the NEWT_COLORS-format 'text' to 'p'.  On failure 'bad' receives
+// the offending item and 'p' may be partly updated.
+inline bool parse_colors(std::string_view text, Palette& p, std::string& bad) {
+    constexpr std::string_view kSeparators = ";:\n\r\t ";
+    std::size_t pos = 0;
+    while ((pos = text.find_first_not_of(kSeparators, pos)) != std::string_view::npos) {
+        std::size_t end = text.find_first_of(kSeparators, pos);
+        if (end == std::string_view::npos) end = text.size();
+        std::string_view item = text.substr(pos, end - pos);
+        pos = end;
+        std::size_t eq = item.find('=');
+        if (eq == std::string_view::npos || !set_colorset(p, item.substr(0, eq), item.substr(eq + 1))) {
+            bad = std::string(item);
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace newt_palette
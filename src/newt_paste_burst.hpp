@@ -0,0 +1,54 @@
+#pragma once
+
+/**
+ * newt_paste_burst.hpp
+ *
+ * Paste detection for filtered entries.  libnewt hands an entry filter one
+ * key at a time, so a 2 KB paste into an entry with a bash filter would run
+ * the filter 2048 times.  A paste reaches the terminal in one write, though:
+ * when a text key arrives with more input already buffered behind it, the
+ * whole run of text keys is collected here and filtered once as a string.
+ * Typing never leaves keys buffered, so it keeps the per-key path.
+ *
+ * Terminal bracketed-paste mode is not used: libnewt's key parser does not
+ * know its ESC [ 200 ~ markers and would hand them to the entry as keys.
+ */
+
+#include <cstddef>
+#include <string>
+
+namespace newt_paste {
+
+// Keys that insert themselves into an entry: printable ASCII and the bytes
+// of UTF-8 sequences.
+inline bool is_text(int ch) { return ch >= 0x20 && ch <= 0xff && ch != 0x7f; }
+
+// The burst starting with key 'first': 'first' plus the text keys that
+// pending() says are already buffered, read with get().  The first key that
+// is not text (Enter, Tab, an escape sequence) is handed back with unget()
+// for libnewt to process.  At most 'max' bytes are taken; the rest stays
+// buffered and forms the next burst.
+template <class Pending, class Get, class Unget>
+std::string collect(int first, Pending pending, Get get, Unget unget, std::size_t max = 65536) {
+    std::string text(1, static_cast<char>(first));
+    while (text.size() < max && pending()) {
+        int ch = get();
+        if (!is_text(ch)) {
+            unget(ch);
+            break;
+        }
+        text += static_cast<char>(ch);
+    }
+    return text;
+}
+
+// 'value' with 'text' inserted at byte offset 'cursor' (clamped to the end).
+inline std::string splice(const std::string& value, std::size_t cursor, const std::string& text) {
+    if (cursor > value.size()) cursor = value.size();
+    std::string out;
+    out.reserve(value.size() + text.size());
+    out.append(value, 0, cursor).append(text).append(value, cursor, std::string::npos);
+    return out;
+}
+
+} // namespace newt_paste
@@ -0,0 +1,182 @@
+#pragma once
+
+/**
+ * newt_progress_panel.hpp
+ *
+ * The model behind ProgressPanel: one row per job (its id, a percentage and
+ * a status message) fed by "jobId pct [message]" lines.
+ *
+ *   • parse_update() reads one line.  pct may be fractional and may end in
+ *     '%'; it is clamped to 0–100.  Without a message the job keeps its
+ *     previous one.
+ *   • LineBuffer reassembles lines from the chunks read off a pipe.
+ *   • ProgressModel applies updates and remembers which jobs changed since
+ *     the widgets were last brought up to date, so a frame only touches rows
+ *     that changed, and a job reporting ten times between frames costs one
+ *     widget update.
+ *   • panel_layout() splits the panel width into id, scale and message
+ *     columns.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace newt_progress {
+
+struct Update {
+    std::string job;
+    int         permille = 0;   // 0–1000
+    bool        has_message = false;
+    std::string message;
+};
+
+// Parses "jobId pct [message]".  Returns false for anything else.
+inline bool parse_update(const std::string& line, Update& out) {
+    std::size_t p = line.find_first_not_of(" \t");
+    if (p == std::string::npos) return false;
+    std::size_t e = line.find_first_of(" \t", p);
+    if (e == std::string::npos) return false;
+    out.job = line.substr(p, e - p);
+
+    p = line.find_first_not_of(" \t", e);
+    if (p == std::string::npos) return false;
+    e = line.find_first_of(" \t", p);
+    std::string num = line.substr(p, e == std::string::npos ? std::string::npos : e - p);
+    if (!num.empty() && num.back() == '%') num.pop_back();
+    if (num.empty()) return false;
+    char* end = nullptr;
+    double pct = std::strtod(num.c_str(), &end);
+    if (*end || pct != pct) return false;
+    out.permille = static_cast<int>(std::min(std::max(pct, 0.0), 100.0) * 10 + 0.5);
+
+    out.has_message = false;
+    out.message.clear();
+    if (e != std::string::npos) {
+        p = line.find_first_not_of(" \t", e);
+        if (p != std::string::npos) {
+            std::size_t last = line.find_last_not_of(" \t\r");
+            out.message     = line.substr(p, last + 1 - p);
+            out.has_message = true;
+        }
+    }
+    return true;
+}
+
+// Splits a byte stream into lines.  A line longer than 'max' bytes is
+// dropped rather than buffered without bound.
+class LineBuffer {
+public:
+    explicit LineBuffer(std::size_t max = 4096) : max_(max) {}
+
+    template <typename Fn>
+    void feed(const char* data, std::size_t n, Fn&& on_line) {
+        for (std::size_t i = 0; i < n; ++i) {
+            char c = data[i];
+            if (c == '\n') {
+                if (!overflow_) on_line(buf_);
+                buf_.clear();
+                overflow_ = false;
+            } else if (!overflow_) {
+                if (buf_.size() < max_) buf_ += c;
+                else { buf_.clear(); overflow_ = true; }
+            }
+        }
+    }
+
+private:
+    std::string buf_;
+    std::size_t max_;
+    bool        overflow_ = false;
+};
+
+class ProgressModel {
+public:
+    struct Job {
+        std::string id;
+        int         permille = 0;
+        std::string message;
+        bool        dirty = false;
+    };
+
+    explicit ProgressModel(const std::vector<std::string>& ids) {
+        for (const std::string& id : ids) {
+            index_.emplace(id, jobs_.size());
+            jobs_.push_back({ id, 0, "", false });
+        }
+    }
+
+    // Applies an update.  Returns false for an unknown job.
+    bool apply(const Update& u) {
+        auto it = index_.find(u.job);
+        if (it == index_.end()) return false;
+        Job& j = jobs_[it->second];
+        if (j.permille != u.permille) { j.permille = u.permille; mark(it->second); }
+        if (u.has_message && j.message != u.message) { j.message = u.message; mark(it->second); }
+        return true;
+    }
+
+    // Indices of the jobs changed since the last call, in the order they
+    // first changed.
+    std::vector<std::size_t> take_dirty() {
+        std::vector<std::size_t> d;
+        d.swap(dirty_);
+        for (std::size_t i : d) jobs_[i].dirty = false;
+        return d;
+    }
+
+    std::size_t size() const                    { return jobs_.size(); }
+    const Job&  operator[](std::size_t i) const { return jobs_[i]; }
+
+private:
+    void mark(std::size_t i) {
+        if (jobs_[i].dirty) return;
+        jobs_[i].dirty = true;
+        dirty_.push_back(i);
+    }
+
+    std::vector<Job>                             jobs_;
+    std::unordered_map<std::string, std::size_t> index_;
+    std::vector<std::size_t>                     dirty_;
+};
+
+struct Layout {
+    int id_width;
+    int scale_width;
+    int message_width;   // 0: no message column
+};
+
+// Columns of a panel 'width' wide: the longest id (at most a quarter of the
+// width), then the scale and the message sharing the rest 3:2, one blank
+// column between each.  Panels narrower than 30 columns have no message.
+inline Layout panel_layout(int width, const std::vector<std::string>& ids) {
+    int id = 1;
+    for (const std::string& s : ids) id = std::max(id, static_cast<int>(s.size()));
+    id = std::max(1, std::min(id, width / 4));
+    int rest = width - id - 1;
+    if (width < 30) return { id, std::max(rest, 1), 0 };
+    int scale = (rest - 1) * 3 / 5;
+    return { id, scale, rest - 1 - scale };
+}
+
+// 'text' cut to at most 'cols' characters of UTF-8 and padded with blanks to
+// exactly 'cols', so a shorter message overwrites a longer one.
+inline std::string fit_columns(const std::string& text, int cols) {
+    std::string out;
+    int n = 0;
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if ((c & 0xC0) != 0x80) {
+            if (n == cols) break;
+            ++n;
+        }
+        out += (c < 0x20 ? ' ' : text[i]);
+    }
+    out.append(static_cast<std::size_t>(std::max(cols - n, 0)), ' ');
+    return out;
+}
+
+} // namespace newt_progress
@@ -0,0 +1,79 @@
+#pragma once
+
+/**
+ * newt_row_store.hpp
+ *
+ * Compact, append-only storage for a large number of text rows.  All rows
+ * live back-to-back in a single NUL-separated arena; a parallel offset vector
+ * gives O(1) access to each row as a C string that can be handed straight to
+ * libnewt (e.g. newtListboxAppendEntry) without copying.
+ *
+ * Used by the native listbox helpers (VirtualListbox, …) so that a million
+ * rows cost one allocation for the text plus one size_t per row, instead of a
+ * libnewt listbox item (malloc'd struct + strdup'd text) per row.
+ */
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+
+class RowStore {
+public:
+    void clear() {
+        arena_.clear();
+        offsets_.clear();
+    }
+
+    void reserve(std::size_t rows, std::size_t bytes) {
+        offsets_.reserve(rows);
+        arena_.reserve(bytes + rows);
+    }
+
+    void push_back(const char* s, std::size_t n) {
+        offsets_.push_back(arena_.size());
+        arena_.append(s, n);
+        arena_.push_back('\0');
+    }
+
+    void push_back(const char* s) { push_back(s, std::strlen(s)); }
+
+    // Takes ownership of a raw text buffer and splits it on '\n' in place:
+    // every newline becomes the NUL terminator of the preceding row.  A
+    // trailing newline does not produce an extra empty row.
+    void assign_lines(std::string&& text) {
+        clear();
+        arena_ = std::move(text);
+        if (arena_.empty()) return;
+        if (arena_.back() != '\n') arena_.push_back('\n');
+
+        char* base = &arena_[0];
+        char* end  = base + arena_.size();
+        char* p    = base;
+        while (p < end) {
+            offsets_.push_back(static_cast<std::size_t>(p - base));
+            char* nl = static_cast<char*>(std::memchr(p, '\n', end - p));
+            *nl = '\0';
+            p = nl + 1;
+        }
+    }
+
+    std::size_t size() const  { return offsets_.size(); }
+    bool        empty() const { return offsets_.empty(); }
+
+    // NUL-terminated text of row i.
+    const char* operator[](std::size_t i) const {
+        return arena_.data() + offsets_[i];
+    }
+
+    // Length of row i, excluding the terminator.
+    std::size_t length(std::size_t i) const {
+        std::size_t end = (i + 1 < offsets_.size()) ? offsets_[i + 1]
+                                                    : arena_.size();
+        return end - offsets_[i] - 1;
+    }
+
+private:
+    std::string              arena_;
+    std::vector<std::size_t> offsets_;
+};
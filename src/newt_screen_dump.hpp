@@ -0,0 +1,126 @@
+#pragma once
+
+/**
+ * newt_screen_dump.hpp
+ *
+ * Turns rows of S-Lang screen cells into what ScreenDump returns: the row's
+ * text as UTF-8 with trailing blanks removed, and its colours as runs
+ * "colorset:count colorset:count …" covering every column.  The colour of a
+ * cell is the libnewt colorset it was drawn with (NEWT_COLORSET_*).
+ *
+ * Cells drawn from the alternate character set (window borders, scrollbar
+ * thumbs) hold VT100 line-drawing codes such as 'q' and 'x'; they are
+ * returned as the Unicode characters the terminal shows (─, │, …).  A cell
+ * without characters is the right half of a wide character and adds nothing
+ * to the text.
+ *
+ * The caller reads the cells out of S-Lang; this header has no bash, libnewt
+ * or S-Lang dependency — see test/test_screen_dump.cpp.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace newt_screen_dump {
+
+inline void append_utf8(std::string& out, std::uint32_t c) {
+    if (c < 0x80) {
+        out += static_cast<char>(c);
+    } else if (c < 0x800) {
+        out += static_cast<char>(0xC0 | (c >> 6));
+        out += static_cast<char>(0x80 | (c & 0x3F));
+    } else if (c < 0x10000) {
+        out += static_cast<char>(0xE0 | (c >> 12));
+        out += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (c & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (c >> 18));
+        out += static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (c & 0x3F));
+    }
+}
+
+// Unicode for a VT100 alternate-character-set code; other codes unchanged.
+inline std::uint32_t acs_char(std::uint32_t c) {
+    switch (c) {
+    case '`': return 0x25C6;   // ◆
+    case 'a': return 0x2592;   // ▒
+    case 'f': return 0x00B0;   // °
+    case 'g': return 0x00B1;   // ±
+    case 'h': return 0x2591;   // ░
+    case 'j': return 0x2518;   // ┘
+    case 'k': return 0x2510;   // ┐
+    case 'l': return 0x250C;   // ┌
+    case 'm': return 0x2514;   // └
+    case 'n': return 0x253C;   // ┼
+    case 'q': return 0x2500;   // ─
+    case 't': return 0x251C;   // ├
+    case 'u': return 0x2524;   // ┤
+    case 'v': return 0x2534;   // ┴
+    case 'w': return 0x252C;   // ┬
+    case 'x': return 0x2502;   // │
+    case '~': return 0x00B7;   // ·
+    case '0': return 0x2588;   // █
+    case ',': return 0x2190;   // ←
+    case '+': return 0x2192;   // →
+    case '-': return 0x2191;   // ↑
+    case '.': return 0x2193;   // ↓
+    default:  return c;
+    }
+}
+
+// Accumulates one row, cell by cell.
+class RowBuilder {
+public:
+    // Adds the next cell: its 'n' characters (a base character and combining
+    // marks), its colorset and whether it was drawn in the alternate
+    // character set.
+    void cell(const std::uint32_t* chars, std::size_t n, unsigned color, bool acs) {
+        for (std::size_t i = 0; i < n; ++i)
+            append_utf8(text_, acs ? acs_char(chars[i]) : chars[i]);
+        if (n && !(n == 1 && chars[0] == ' ')) kept_ = text_.size();
+
+        if (count_ && color == color_) {
+            ++count_;
+        } else {
+            flush_run();
+            color_ = color;
+            count_ = 1;
+        }
+    }
+
+    std::string text() const { return text_.substr(0, kept_); }
+
+    std::string runs() const {
+        std::string r = runs_;
+        if (count_) {
+            if (!r.empty()) r += ' ';
+            r += std::to_string(color_) + ':' + std::to_string(count_);
+        }
+        return r;
+    }
+
+    void clear() {
+        text_.clear();
+        runs_.clear();
+        kept_  = 0;
+        count_ = 0;
+    }
+
+private:
+    void flush_run() {
+        if (!count_) return;
+        if (!runs_.empty()) runs_ += ' ';
+        runs_ += std::to_string(color_) + ':' + std::to_string(count_);
+    }
+
+    std::string text_;
+    std::string runs_;
+    std::size_t kept_  = 0;   // text_ length up to the last non-blank cell
+    unsigned    color_ = 0;
+    std::size_t count_ = 0;
+};
+
+} // namespace newt_screen_dump
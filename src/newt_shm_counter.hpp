@@ -0,0 +1,131 @@
+#pragma once
+
+/**
+ * newt_shm_counter.hpp
+ *
+ * Progress shared through a small file, for ScaleBindShm.  The producer maps
+ * the file and stores into two native-endian 64-bit words:
+ *
+ *   offset 0   done    work completed so far
+ *   offset 8   total   work to do (0: not known yet)
+ *
+ * with plain atomic stores (__atomic_store_n(&w[0], n, __ATOMIC_RELEASE) in C,
+ * or a std::atomic<uint64_t> laid over the mapping), so reporting progress
+ * costs it no system call at all.  The builtin samples the pair at a fixed
+ * rate with SampleTimer and sets the scale from it.
+ *
+ * ShmCounter creates the file (16 zero bytes) if it does not exist, so either
+ * side may start first.
+ */
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+class ShmCounter {
+public:
+    static constexpr std::size_t kSize = 2 * sizeof(std::uint64_t);
+
+    struct Sample {
+        std::uint64_t done  = 0;
+        std::uint64_t total = 0;
+
+        // done/total scaled to 0..full; 0 while the total is not known.
+        unsigned long long amount(unsigned long long full) const {
+            if (total == 0) return 0;
+            std::uint64_t d = done < total ? done : total;
+            return static_cast<unsigned long long>(
+                static_cast<unsigned __int128>(d) * full / total);
+        }
+    };
+
+    ShmCounter() = default;
+    ShmCounter(const ShmCounter&) = delete;
+    ShmCounter& operator=(const ShmCounter&) = delete;
+    ~ShmCounter() { close(); }
+
+    // Maps 'path', creating it or growing it to kSize bytes if needed.
+    // Returns false (errno set) on failure.
+    bool open(const std::string& path) {
+        close();
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+        if (fd < 0) return false;
+        struct stat sb;
+        bool ok = ::fstat(fd, &sb) == 0 &&
+                  (sb.st_size >= static_cast<off_t>(kSize) ||
+                   ::ftruncate(fd, static_cast<off_t>(kSize)) == 0);
+        void* p = ok ? ::mmap(nullptr, kSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)
+                     : MAP_FAILED;
+        int e = errno;
+        ::close(fd);
+        if (p == MAP_FAILED) { errno = e; return false; }
+        words_ = static_cast<std::uint64_t*>(p);
+        return true;
+    }
+
+    void close() {
+        if (words_) ::munmap(words_, kSize);
+        words_ = nullptr;
+    }
+
+    bool is_open() const { return words_ != nullptr; }
+
+    // Reads the pair.  The two loads are not one snapshot; a producer
+    // changing the total mid-run may be seen half-way, which a clamped
+    // progress bar tolerates.
+    Sample sample() const {
+        Sample s;
+        if (!words_) return s;
+        s.total = __atomic_load_n(&words_[1], __ATOMIC_ACQUIRE);
+        s.done  = __atomic_load_n(&words_[0], __ATOMIC_ACQUIRE);
+        return s;
+    }
+
+    // For producers in this process (and the tests).
+    void store(std::uint64_t done, std::uint64_t total) {
+        if (!words_) return;
+        __atomic_store_n(&words_[1], total, __ATOMIC_RELEASE);
+        __atomic_store_n(&words_[0], done, __ATOMIC_RELEASE);
+    }
+
+private:
+    std::uint64_t* words_ = nullptr;
+};
+
+// A periodic timerfd: readable every 'ms' milliseconds until closed.
+class SampleTimer {
+public:
+    SampleTimer() = default;
+    SampleTimer(const SampleTimer&) = delete;
+    SampleTimer& operator=(const SampleTimer&) = delete;
+    ~SampleTimer() { if (fd_ >= 0) ::close(fd_); }
+
+    // Fires every 'ms' (> 0) milliseconds, starting 'ms' from now.
+    bool start(int ms) {
+        if (fd_ < 0) fd_ = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (fd_ < 0) return false;
+        struct itimerspec its = {};
+        its.it_interval.tv_sec  = ms / 1000;
+        its.it_interval.tv_nsec = (ms % 1000) * 1000000L;
+        its.it_value            = its.it_interval;
+        return ::timerfd_settime(fd_, 0, &its, nullptr) == 0;
+    }
+
+    int fd() const { return fd_; }
+
+    // Acknowledges the expirations so far; returns how many there were.
+    std::uint64_t drain() {
+        std::uint64_t n = 0;
+        if (fd_ < 0 || ::read(fd_, &n, sizeof(n)) != static_cast<ssize_t>(sizeof(n))) return 0;
+        return n;
+    }
+
+private:
+    int fd_ = -1;
+};
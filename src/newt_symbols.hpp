@@ -0,0 +1,330 @@
+#pragma once
+
+/**
+ * newt_symbols.hpp
+ *
+ * Symbolic spellings of libnewt constants for integer and enum arguments, so
+ * scripts can write
+ *
+ *   newt Listbox 1 1 10 'SCROLL|RETURNEXIT'
+ *   newt FormAddHotKey "$f" KEY:F12
+ *   newt SetColor COLORSET:BUTTON white blue
+ *
+ * instead of "${NEWT_FLAG[SCROLL]}" lookups and $(( … )) arithmetic.
+ *
+ * An expression is one or more terms joined by '|' (bitwise or); spaces
+ * around terms are ignored.  A term is
+ *   • a decimal integer (optionally negative),
+ *   • GROUP:NAME — any constant, GROUP being the suffix of the NEWT_* array
+ *     that holds it (FLAG, KEY, COLORSET, FD, ARG, CHECKBOXTREE, ANCHOR,
+ *     GRID_FLAG) or SENSE / GRID for the newtFlagsSense / newtGridElement
+ *     enumerators,
+ *   • NAME alone — a FLAG, or a constant whose name is unique across groups
+ *     (F12, APPEND, GROWX, …).  LEFT and RIGHT exist both as keys and as
+ *     anchors and need their group.
+ * Names are case-sensitive.  Anything else makes the expression invalid.
+ *
+ * Lookups go through a perfect hash built at compile time (hash and
+ * displace): the first hash picks a bucket, the bucket's displacement seed
+ * gives the slot, and a single comparison confirms the hit.
+ *
+ * Requires <newt.h> (or the test stubs) to be included first.
+ * See test/test_symbols.cpp.
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace newt_symbols {
+
+struct Symbol {
+    std::string_view group;   // "" for a bare-name alias
+    std::string_view name;
+    int              value;
+};
+
+// Every constant, grouped as in the NEWT_* arrays.
+inline constexpr Symbol kConstants[] = {
+    { "COLORSET", "ROOT",          NEWT_COLORSET_ROOT          },
+    { "COLORSET", "BORDER",        NEWT_COLORSET_BORDER        },
+    { "COLORSET", "WINDOW",        NEWT_COLORSET_WINDOW        },
+    { "COLORSET", "SHADOW",        NEWT_COLORSET_SHADOW        },
+    { "COLORSET", "TITLE",         NEWT_COLORSET_TITLE         },
+    { "COLORSET", "BUTTON",        NEWT_COLORSET_BUTTON        },
+    { "COLORSET", "ACTBUTTON",     NEWT_COLORSET_ACTBUTTON     },
+    { "COLORSET", "CHECKBOX",      NEWT_COLORSET_CHECKBOX      },
+    { "COLORSET", "ACTCHECKBOX",   NEWT_COLORSET_ACTCHECKBOX   },
+    { "COLORSET", "ENTRY",         NEWT_COLORSET_ENTRY         },
+    { "COLORSET", "LABEL",         NEWT_COLORSET_LABEL         },
+    { "COLORSET", "LISTBOX",       NEWT_COLORSET_LISTBOX       },
+    { "COLORSET", "ACTLISTBOX",    NEWT_COLORSET_ACTLISTBOX    },
+    { "COLORSET", "TEXTBOX",       NEWT_COLORSET_TEXTBOX       },
+    { "COLORSET", "ACTTEXTBOX",    NEWT_COLORSET_ACTTEXTBOX    },
+    { "COLORSET", "HELPLINE",      NEWT_COLORSET_HELPLINE      },
+    { "COLORSET", "ROOTTEXT",      NEWT_COLORSET_ROOTTEXT      },
+    { "COLORSET", "EMPTYSCALE",    NEWT_COLORSET_EMPTYSCALE    },
+    { "COLORSET", "FULLSCALE",     NEWT_COLORSET_FULLSCALE     },
+    { "COLORSET", "DISENTRY",      NEWT_COLORSET_DISENTRY      },
+    { "COLORSET", "COMPACTBUTTON", NEWT_COLORSET_COMPACTBUTTON },
+    { "COLORSET", "ACTSELLISTBOX", NEWT_COLORSET_ACTSELLISTBOX },
+    { "COLORSET", "SELLISTBOX",    NEWT_COLORSET_SELLISTBOX    },
+
+    { "FLAG", "RETURNEXIT", NEWT_FLAG_RETURNEXIT },
+    { "FLAG", "HIDDEN",     NEWT_FLAG_HIDDEN     },
+    { "FLAG", "SCROLL",     NEWT_FLAG_SCROLL     },
+    { "FLAG", "DISABLED",   NEWT_FLAG_DISABLED   },
+    { "FLAG", "BORDER",     NEWT_FLAG_BORDER     },
+    { "FLAG", "WRAP",       NEWT_FLAG_WRAP       },
+    { "FLAG", "NOF12",      NEWT_FLAG_NOF12      },
+    { "FLAG", "MULTIPLE",   NEWT_FLAG_MULTIPLE   },
+    { "FLAG", "SELECTED",   NEWT_FLAG_SELECTED   },
+    { "FLAG", "CHECKBOX",   NEWT_FLAG_CHECKBOX   },
+    { "FLAG", "PASSWORD",   NEWT_FLAG_PASSWORD   },
+    { "FLAG", "SHOWCURSOR", NEWT_FLAG_SHOWCURSOR },
+
+    { "FD", "READ",   NEWT_FD_READ   },
+    { "FD", "WRITE",  NEWT_FD_WRITE  },
+    { "FD", "EXCEPT", NEWT_FD_EXCEPT },
+
+    { "ARG", "LAST",   NEWT_ARG_LAST   },
+    { "ARG", "APPEND", NEWT_ARG_APPEND },
+
+    // State chars are stored as their character codes.
+    { "CHECKBOXTREE", "UNSELECTABLE", NEWT_CHECKBOXTREE_UNSELECTABLE },
+    { "CHECKBOXTREE", "HIDE_BOX",     NEWT_CHECKBOXTREE_HIDE_BOX     },
+    { "CHECKBOXTREE", "COLLAPSED",    (unsigned char)NEWT_CHECKBOXTREE_COLLAPSED  },
+    { "CHECKBOXTREE", "EXPANDED",     (unsigned char)NEWT_CHECKBOXTREE_EXPANDED   },
+    { "CHECKBOXTREE", "UNSELECTED",   (unsigned char)NEWT_CHECKBOXTREE_UNSELECTED },
+    { "CHECKBOXTREE", "SELECTED",     (unsigned char)NEWT_CHECKBOXTREE_SELECTED   },
+
+    { "KEY", "TAB",     NEWT_KEY_TAB     },
+    { "KEY", "ENTER",   NEWT_KEY_ENTER   },
+    { "KEY", "RETURN",  NEWT_KEY_RETURN  },
+    { "KEY", "SUSPEND", NEWT_KEY_SUSPEND },
+    { "KEY", "ESCAPE",  NEWT_KEY_ESCAPE  },
+    { "KEY", "UP",      NEWT_KEY_UP      },
+    { "KEY", "DOWN",    NEWT_KEY_DOWN    },
+    { "KEY", "LEFT",    NEWT_KEY_LEFT    },
+    { "KEY", "RIGHT",   NEWT_KEY_RIGHT   },
+    { "KEY", "BKSPC",   NEWT_KEY_BKSPC   },
+    { "KEY", "DELETE",  NEWT_KEY_DELETE  },
+    { "KEY", "HOME",    NEWT_KEY_HOME    },
+    { "KEY", "END",     NEWT_KEY_END     },
+    { "KEY", "UNTAB",   NEWT_KEY_UNTAB   },
+    { "KEY", "PGUP",    NEWT_KEY_PGUP    },
+    { "KEY", "PGDN",    NEWT_KEY_PGDN    },
+    { "KEY", "INSERT",  NEWT_KEY_INSERT  },
+    { "KEY", "RESIZE",  NEWT_KEY_RESIZE  },
+    { "KEY", "ERROR",   NEWT_KEY_ERROR   },
+    { "KEY", "F1",      NEWT_KEY_F1      },
+    { "KEY", "F2",      NEWT_KEY_F2      },
+    { "KEY", "F3",      NEWT_KEY_F3      },
+    { "KEY", "F4",      NEWT_KEY_F4      },
+    { "KEY", "F5",      NEWT_KEY_F5      },
+    { "KEY", "F6",      NEWT_KEY_F6      },
+    { "KEY", "F7",      NEWT_KEY_F7      },
+    { "KEY", "F8",      NEWT_KEY_F8      },
+    { "KEY", "F9",      NEWT_KEY_F9      },
+    { "KEY", "F10",     NEWT_KEY_F10     },
+    { "KEY", "F11",     NEWT_KEY_F11     },
+    { "KEY", "F12",     NEWT_KEY_F12     },
+
+    { "ANCHOR", "LEFT",   NEWT_ANCHOR_LEFT   },
+    { "ANCHOR", "RIGHT",  NEWT_ANCHOR_RIGHT  },
+    { "ANCHOR", "TOP",    NEWT_ANCHOR_TOP    },
+    { "ANCHOR", "BOTTOM", NEWT_ANCHOR_BOTTOM },
+
+    { "GRID_FLAG", "GROWX", NEWT_GRID_FLAG_GROWX },
+    { "GRID_FLAG", "GROWY", NEWT_GRID_FLAG_GROWY },
+
+    { "SENSE", "SET",    NEWT_FLAGS_SET    },
+    { "SENSE", "RESET",  NEWT_FLAGS_RESET  },
+    { "SENSE", "TOGGLE", NEWT_FLAGS_TOGGLE },
+
+    { "GRID", "EMPTY",     NEWT_GRID_EMPTY     },
+    { "GRID", "COMPONENT", NEWT_GRID_COMPONENT },
+    { "GRID", "SUBGRID",   NEWT_GRID_SUBGRID   },
+};
+
+inline constexpr std::size_t kConstantCount = sizeof(kConstants) / sizeof(kConstants[0]);
+
+// ─── bare-name aliases ────────────────────────────────────────────────────────
+
+// Whether constant i may also be spelled without its group.
+constexpr bool has_bare_alias(std::size_t i) {
+    if (kConstants[i].group == "FLAG") return true;
+    for (std::size_t j = 0; j < kConstantCount; ++j)
+        if (j != i && kConstants[j].name == kConstants[i].name) return false;
+    return true;
+}
+
+constexpr std::size_t count_bare_aliases() {
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < kConstantCount; ++i) n += has_bare_alias(i);
+    return n;
+}
+
+inline constexpr std::size_t kSymbolCount = kConstantCount + count_bare_aliases();
+
+// kConstants followed by one { "", name, value } entry per bare alias.
+constexpr std::array<Symbol, kSymbolCount> make_symbols() {
+    std::array<Symbol, kSymbolCount> out{};
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < kConstantCount; ++i) out[n++] = kConstants[i];
+    for (std::size_t i = 0; i < kConstantCount; ++i)
+        if (has_bare_alias(i)) out[n++] = Symbol{ "", kConstants[i].name, kConstants[i].value };
+    return out;
+}
+
+inline constexpr std::array<Symbol, kSymbolCount> kSymbols = make_symbols();
+
+// ─── perfect hash ─────────────────────────────────────────────────────────────
+
+// FNV-1a over "group:name", seeded, with a murmur3 finaliser.
+constexpr std::uint32_t hash(std::string_view group, std::string_view name,
+                             std::uint32_t seed) {
+    std::uint32_t h = 2166136261u ^ (seed * 0x9E3779B9u);
+    auto mix = [&h](char c) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 16777619u;
+    };
+    for (char c : group) mix(c);
+    mix(':');
+    for (char c : name) mix(c);
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35u;
+    h ^= h >> 16;
+    return h;
+}
+
+constexpr std::size_t next_pow2(std::size_t n) {
+    std::size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+template <std::size_t N>
+struct PerfectHash {
+    static constexpr std::size_t kBuckets = N / 2 + 1;
+    static constexpr std::size_t kSlots   = next_pow2(2 * N);
+
+    std::array<std::uint32_t, kBuckets> displacement{};
+    std::array<std::int32_t, kSlots>    slot{};       // index into the keys, -1 = empty
+    bool                                ok = false;   // construction succeeded
+
+    constexpr std::size_t bucket(std::string_view g, std::string_view n) const {
+        return hash(g, n, 0) % kBuckets;
+    }
+    constexpr std::size_t place(std::string_view g, std::string_view n, std::uint32_t d) const {
+        return hash(g, n, d) & (kSlots - 1);
+    }
+};
+
+// Hash and displace: buckets are placed largest first, each with the first
+// displacement seed that sends all its keys to free slots.
+template <std::size_t N>
+constexpr PerfectHash<N> build_perfect_hash(const std::array<Symbol, N>& keys) {
+    using PH = PerfectHash<N>;
+    PH ph{};
+    for (auto& s : ph.slot) s = -1;
+
+    std::array<std::size_t, PH::kBuckets> size{};
+    std::array<std::size_t, N>            of{};   // bucket of each key
+    for (std::size_t i = 0; i < N; ++i) {
+        of[i] = ph.bucket(keys[i].group, keys[i].name);
+        ++size[of[i]];
+    }
+    std::array<bool, PH::kBuckets> done{};
+    for (std::size_t round = 0; round < PH::kBuckets; ++round) {
+        std::size_t b = 0, best = 0;
+        bool any = false;
+        for (std::size_t j = 0; j < PH::kBuckets; ++j)
+            if (!done[j] && (!any || size[j] > best)) { b = j; best = size[j]; any = true; }
+        done[b] = true;
+        if (best == 0) continue;
+
+        bool placed = false;
+        for (std::uint32_t d = 1; d < 100000 && !placed; ++d) {
+            std::array<std::size_t, N> taken{};
+            std::size_t nt = 0;
+            placed = true;
+            for (std::size_t i = 0; i < N && placed; ++i) {
+                if (of[i] != b) continue;
+                std::size_t s = ph.place(keys[i].group, keys[i].name, d);
+                if (ph.slot[s] != -1) { placed = false; break; }
+                for (std::size_t t = 0; t < nt; ++t)
+                    if (taken[t] == s) { placed = false; break; }
+                taken[nt++] = s;
+            }
+            if (!placed) continue;
+            ph.displacement[b] = d;
+            nt = 0;
+            for (std::size_t i = 0; i < N; ++i)
+                if (of[i] == b) ph.slot[taken[nt++]] = static_cast<std::int32_t>(i);
+        }
+        if (!placed) return ph;
+    }
+    ph.ok = true;
+    return ph;
+}
+
+inline constexpr PerfectHash<kSymbolCount> kHash = build_perfect_hash(kSymbols);
+static_assert(kHash.ok, "no perfect hash found for the newt symbol table");
+
+// Value of GROUP:NAME (group "" for a bare name), or nullptr.
+constexpr const int* find(std::string_view group, std::string_view name) {
+    std::uint32_t d = kHash.displacement[kHash.bucket(group, name)];
+    std::int32_t  i = kHash.slot[kHash.place(group, name, d)];
+    if (i < 0) return nullptr;
+    const Symbol& s = kSymbols[static_cast<std::size_t>(i)];
+    return (s.group == group && s.name == name) ? &s.value : nullptr;
+}
+
+// ─── expressions ──────────────────────────────────────────────────────────────
+
+inline bool parse_integer(std::string_view t, long long& out) {
+    bool neg = !t.empty() && t[0] == '-';
+    if (neg) t.remove_prefix(1);
+    if (t.empty() || t.size() > 18) return false;
+    long long v = 0;
+    for (char c : t) {
+        if (c < '0' || c > '9') return false;
+        v = v * 10 + (c - '0');
+    }
+    out = neg ? -v : v;
+    return true;
+}
+
+// Evaluates an expression (see the file comment).  Returns false if any term
+// is neither an integer nor a known constant.
+inline bool evaluate(std::string_view expr, long long& out) {
+    long long acc = 0;
+    for (;;) {
+        std::size_t bar = expr.find('|');
+        std::string_view term = expr.substr(0, bar);
+        while (!term.empty() && term.front() == ' ') term.remove_prefix(1);
+        while (!term.empty() && term.back()  == ' ') term.remove_suffix(1);
+
+        long long v;
+        if (!parse_integer(term, v)) {
+            std::size_t colon = term.find(':');
+            if (colon == 0) return false;   // "" is the bare-alias group
+            const int* p = colon == std::string_view::npos
+                         ? find("", term)
+                         : find(term.substr(0, colon), term.substr(colon + 1));
+            if (!p) return false;
+            v = *p;
+        }
+        acc |= v;
+        if (bar == std::string_view::npos) break;
+        expr.remove_prefix(bar + 1);
+    }
+    out = acc;
+    return true;
+}
+
+} // namespace newt_symbols
@@ -0,0 +1,119 @@
+#pragma once
+
+/**
+ * newt_text_tail.hpp
+ *
+ * The last lines of a stream of terminal output, the scrollback of
+ * TextboxRunCommand.  Bytes are fed in chunks of any size; TextTail keeps at
+ * most 'max_lines' lines (the completed ones plus the line being written)
+ * and clips each to 'max_cols' characters, so memory stays bounded however
+ * much a command prints.  lines() gives the page a textbox shows.
+ *
+ * Terminal conventions found in the output of apt, rsync, curl and build
+ * tools are applied rather than shown: a carriage return not followed by a
+ * newline starts the current line over (progress counters), and escape
+ * sequences (colours, cursor movement) are dropped.
+ */
+
+#include <cstddef>
+#include <deque>
+#include <string>
+
+class TextTail {
+public:
+    TextTail(std::size_t max_lines, std::size_t max_cols)
+        : max_lines_(max_lines ? max_lines : 1), max_cols_(max_cols) {}
+
+    void append(const char* data, std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) put(static_cast<unsigned char>(data[i]));
+    }
+
+    // The last max_lines lines joined with '\n', the one being written last
+    // if it has any text.
+    std::string text() const { return lines(line_count()); }
+
+    // Lines held: the completed ones plus the one being written, if it has
+    // any text.
+    std::size_t line_count() const {
+        return done_.size() - skip() + (line_.empty() ? 0 : 1);
+    }
+
+    // Up to 'n' lines joined with '\n', ending 'back' lines above the last
+    // one; 'back' is clamped so that the page starts at the oldest line at
+    // the earliest.
+    std::string lines(std::size_t n, std::size_t back = 0) const {
+        std::size_t count = line_count();
+        std::size_t most  = count > n ? count - n : 0;
+        std::size_t end   = count - (back < most ? back : most);
+        std::size_t begin = end > n ? end - n : 0;
+        std::string out;
+        for (std::size_t i = begin; i < end; ++i) {
+            if (i > begin) out += '\n';
+            out += i + skip() < done_.size() ? done_[i + skip()] : line_;
+        }
+        return out;
+    }
+
+    // Lines completed since the start, including those no longer held.
+    std::size_t completed() const { return completed_; }
+
+private:
+    enum class State { Text, Esc, Csi, Osc };
+
+    // The oldest completed line is not shown while a full tail has a line
+    // being written.
+    std::size_t skip() const { return !line_.empty() && done_.size() == max_lines_ ? 1 : 0; }
+
+    void put(unsigned char c) {
+        switch (state_) {
+        case State::Esc:                            // ESC, intermediates, final
+            if (c == '[')                  state_ = State::Csi;
+            else if (c == ']')             state_ = State::Osc;
+            else if (c < 0x20 || c > 0x2F) state_ = State::Text;
+            return;
+        case State::Csi:
+            if (c >= 0x40 && c <= 0x7E) state_ = State::Text;
+            return;
+        case State::Osc:                            // ends with BEL (or ST)
+            if (c == '\a' || c == '\\') state_ = State::Text;
+            return;
+        case State::Text:
+            break;
+        }
+
+        if (c == 0x1B) { state_ = State::Esc; return; }
+        if (c == '\n') { cr_ = false; newline(); return; }
+        if (c == '\r') { cr_ = true; return; }
+        if (cr_) {
+            cr_ = false;
+            line_.clear();
+            cols_ = 0;
+        }
+        if (c < 0x20 && c != '\t') return;          // BEL, backspace, …
+        bool starts_char = (c & 0xC0) != 0x80;
+        if (starts_char && cols_ >= max_cols_) { clipped_ = true; return; }
+        if (!starts_char && clipped_) return;       // rest of a clipped character
+        clipped_ = false;
+        if (starts_char) ++cols_;
+        line_ += static_cast<char>(c);
+    }
+
+    void newline() {
+        done_.push_back(std::move(line_));
+        if (done_.size() > max_lines_) done_.pop_front();
+        ++completed_;
+        line_.clear();
+        cols_    = 0;
+        clipped_ = false;
+    }
+
+    std::size_t             max_lines_;
+    std::size_t             max_cols_;
+    std::deque<std::string> done_;
+    std::string             line_;
+    std::size_t             cols_      = 0;
+    std::size_t             completed_ = 0;
+    bool                    cr_        = false;
+    bool                    clipped_   = false;
+    State                   state_     = State::Text;
+};
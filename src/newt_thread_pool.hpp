@@ -0,0 +1,202 @@
+#pragma once
+
+/**
+ * newt_thread_pool.hpp
+ *
+ * Small fixed-size worker pool for the native helpers that do bulk work off
+ * the UI thread (fuzzy matching, sorting, directory scans, …).  Tasks are
+ * plain std::function<void()>; callers that split one job across workers
+ * post one task per worker and let each pull chunks from a shared atomic
+ * cursor.  TaskGroup waits for a batch of tasks without waiting for unrelated
+ * work on the same pool, and parallel_stable_sort builds on it.
+ *
+ * Bash forks for subshells and command substitutions, and a forked child has
+ * no worker threads, so shared_thread_pool() builds a fresh pool when it
+ * notices it is running in a different process from the one that created the
+ * current pool.  The parent's pool object is leaked in the child on purpose:
+ * destroying it would try to join threads that do not exist there.
+ *
+ * Workers start with every signal blocked (see SignalsBlocked), so bash's
+ * handlers only ever run on the main thread.
+ */
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <pthread.h>
+#include <signal.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// Blocks every signal on the calling thread while it lives.  A new thread
+// inherits its creator's mask, so threads started inside one never run
+// bash's SIGCHLD/SIGINT/SIGWINCH handlers: bash masks those around its job
+// table updates with sigprocmask, which only covers the main thread.
+class SignalsBlocked {
+public:
+    SignalsBlocked() {
+        sigset_t all;
+        sigfillset(&all);
+        pthread_sigmask(SIG_SETMASK, &all, &old_);
+    }
+    ~SignalsBlocked() { pthread_sigmask(SIG_SETMASK, &old_, nullptr); }
+
+    SignalsBlocked(const SignalsBlocked&) = delete;
+    SignalsBlocked& operator=(const SignalsBlocked&) = delete;
+
+private:
+    sigset_t old_;
+};
+
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned workers) {
+        if (workers == 0) workers = 1;
+        SignalsBlocked blocked;
+        threads_.reserve(workers);
+        for (unsigned i = 0; i < workers; ++i)
+            threads_.emplace_back([this] { run(); });
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            stop_ = true;
+        }
+        work_cv_.notify_all();
+        for (auto& t : threads_) t.join();
+    }
+
+    unsigned size() const { return static_cast<unsigned>(threads_.size()); }
+
+    void post(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            queue_.push_back(std::move(task));
+        }
+        work_cv_.notify_one();
+    }
+
+    // Blocks until the queue is empty and no task is running.
+    void wait_idle() {
+        std::unique_lock<std::mutex> lk(m_);
+        idle_cv_.wait(lk, [this] { return queue_.empty() && busy_ == 0; });
+    }
+
+private:
+    void run() {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lk(m_);
+                work_cv_.wait(lk, [this] { return stop_ || !queue_.empty(); });
+                if (queue_.empty()) return;   // stop_ and drained
+                task = std::move(queue_.front());
+                queue_.pop_front();
+                ++busy_;
+            }
+            task();
+            {
+                std::lock_guard<std::mutex> lk(m_);
+                --busy_;
+                if (queue_.empty() && busy_ == 0) idle_cv_.notify_all();
+            }
+        }
+    }
+
+    std::mutex                        m_;
+    std::condition_variable           work_cv_;
+    std::condition_variable           idle_cv_;
+    std::deque<std::function<void()>> queue_;
+    unsigned                          busy_ = 0;
+    bool                              stop_ = false;
+    std::vector<std::thread>          threads_;
+};
+
+// Process-wide pool with one worker per hardware thread, created on first use.
+inline ThreadPool& shared_thread_pool() {
+    static ThreadPool* pool  = nullptr;
+    static pid_t       owner = 0;
+    if (!pool || owner != ::getpid()) {
+        pool  = new ThreadPool(std::thread::hardware_concurrency());
+        owner = ::getpid();
+    }
+    return *pool;
+}
+
+// A batch of tasks on a pool that can be waited for as a unit.  Must not be
+// waited on from a pool worker.
+class TaskGroup {
+public:
+    explicit TaskGroup(ThreadPool& pool) : pool_(pool) {}
+    ~TaskGroup() { wait(); }
+
+    void run(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            ++pending_;
+        }
+        pool_.post([this, task = std::move(task)] {
+            task();
+            std::lock_guard<std::mutex> lk(m_);
+            if (--pending_ == 0) cv_.notify_all();
+        });
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lk(m_);
+        cv_.wait(lk, [this] { return pending_ == 0; });
+    }
+
+private:
+    ThreadPool&             pool_;
+    std::mutex              m_;
+    std::condition_variable cv_;
+    std::size_t             pending_ = 0;
+};
+
+// std::stable_sort, split across the pool for ranges of at least
+// 'min_parallel' elements: equal slices are sorted concurrently, then
+// neighbouring runs are merged pairwise (std::inplace_merge keeps the sort
+// stable) until one run is left.
+template <class RandomIt, class Compare>
+void parallel_stable_sort(ThreadPool& pool, RandomIt first, RandomIt last,
+                          Compare cmp, std::size_t min_parallel = 32768) {
+    std::size_t n     = static_cast<std::size_t>(last - first);
+    std::size_t parts = std::min<std::size_t>(pool.size(), n / (min_parallel / 2 + 1));
+    if (n < min_parallel || parts < 2) {
+        std::stable_sort(first, last, cmp);
+        return;
+    }
+
+    std::vector<RandomIt> bounds;
+    for (std::size_t i = 0; i <= parts; ++i)
+        bounds.push_back(first + static_cast<std::ptrdiff_t>(n * i / parts));
+
+    {
+        TaskGroup g(pool);
+        for (std::size_t i = 0; i < parts; ++i)
+            g.run([&bounds, &cmp, i] { std::stable_sort(bounds[i], bounds[i + 1], cmp); });
+    }
+    while (bounds.size() > 2) {
+        std::vector<RandomIt> next;
+        TaskGroup g(pool);
+        std::size_t i = 0;
+        for (; i + 2 < bounds.size(); i += 2) {
+            next.push_back(bounds[i]);
+            g.run([&bounds, &cmp, i] {
+                std::inplace_merge(bounds[i], bounds[i + 1], bounds[i + 2], cmp);
+            });
+        }
+        for (; i < bounds.size(); ++i) next.push_back(bounds[i]);
+        g.wait();
+        bounds.swap(next);
+    }
+}
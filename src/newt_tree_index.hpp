@@ -0,0 +1,164 @@
+#pragma once
+
+/**
+ * newt_tree_index.hpp
+ *
+ * Mirror of the shape of a CheckboxTree populated by the builtin
+ * (CheckboxTreeLoad, CheckboxTreeAddItem): for every node its data key, its
+ * path string ("a/b/c") and its libnewt index path ({0, 2, 1}), plus maps
+ * from path, data key and index path to the node.  Loading uses it to find
+ * the parent of each new node in O(1) instead of asking libnewt; later
+ * lookups by data key use it instead of newtCheckboxTreeFindItem, which walks
+ * the whole tree.
+ *
+ * Input formats understood by load_lines():
+ *   • paths   — one node per line, components separated by 'sep'
+ *               ("usr/lib/x"); missing ancestors are created, empty
+ *               components are ignored.
+ *   • outline — one node per line, nesting given by indentation (a tab
+ *               advances to the next multiple of 8 columns).  Used when any
+ *               non-blank line starts with a space or tab.
+ *
+ * Nodes already present (same path) are reused, so loading twice merges.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class TreeIndex {
+public:
+    struct Node {
+        std::string      text;       // label (last path component)
+        std::string      path;       // full path, components joined by sep
+        std::uintptr_t   parent = 0; // data key of the parent, 0 for roots
+        std::vector<int> indexes;    // libnewt index path
+        int              children = 0;
+    };
+
+    // A node created by add(), in creation order, with what libnewt needs to
+    // append it: newtCheckboxTreeAddArray(co, text, key, 0,
+    // parent_indexes + {NEWT_ARG_APPEND, NEWT_ARG_LAST}).
+    struct Added {
+        std::uintptr_t key;
+        const Node*    node;
+    };
+
+    // Appends a child called 'text' under 'parent' (0 = root).  Returns the
+    // new node's data key: 'key' if non-zero (the caller makes sure it is
+    // unused), otherwise the next of 1, 2, 3, … not handed out yet.
+    std::uintptr_t add(std::uintptr_t parent, const std::string& text,
+                       const std::string& sep, std::uintptr_t key = 0) {
+        Node n;
+        n.text   = text;
+        n.parent = parent;
+        if (parent) {
+            Node& p = nodes_.at(parent);
+            n.path    = p.path + sep + text;
+            n.indexes = p.indexes;
+            n.indexes.push_back(p.children++);
+        } else {
+            n.path = text;
+            n.indexes.push_back(roots_++);
+        }
+        if (!key) key = next_key_;
+        if (key >= next_key_) next_key_ = key + 1;
+        by_path_.emplace(n.path, key);
+        by_indexes_.emplace(n.indexes, key);
+        order_.push_back(key);
+        nodes_.emplace(key, std::move(n));
+        return key;
+    }
+
+    // Data key of the node at libnewt index path 'indexes', or 0.
+    std::uintptr_t find_indexes(const std::vector<int>& indexes) const {
+        auto it = by_indexes_.find(indexes);
+        return it == by_indexes_.end() ? 0 : it->second;
+    }
+
+    // Data key of the node at 'path', or 0.
+    std::uintptr_t find_path(const std::string& path) const {
+        auto it = by_path_.find(path);
+        return it == by_path_.end() ? 0 : it->second;
+    }
+
+    // Node with data key 'key', or nullptr.
+    const Node* find(std::uintptr_t key) const {
+        auto it = nodes_.find(key);
+        return it == nodes_.end() ? nullptr : &it->second;
+    }
+
+    std::size_t size() const { return nodes_.size(); }
+
+    // Data keys in creation order.
+    const std::vector<std::uintptr_t>& keys() const { return order_; }
+
+    // Adds the nodes described by 'lines' (see the file comment) and reports
+    // each node created, parents before children, in 'added'.
+    void load_lines(const std::vector<std::string>& lines, const std::string& sep,
+                    std::vector<Added>& added) {
+        bool outline = false;
+        for (const auto& l : lines)
+            if (!blank(l) && (l[0] == ' ' || l[0] == '\t')) { outline = true; break; }
+        if (outline) load_outline(lines, sep, added);
+        else         load_paths(lines, sep, added);
+    }
+
+private:
+    static bool blank(const std::string& s) {
+        return s.find_first_not_of(" \t\r") == std::string::npos;
+    }
+
+    std::uintptr_t child(std::uintptr_t parent, const std::string& text,
+                         const std::string& sep, std::vector<Added>& added) {
+        std::string path = parent ? nodes_.at(parent).path + sep + text : text;
+        std::uintptr_t key = find_path(path);
+        if (!key) {
+            key = add(parent, text, sep);
+            added.push_back({ key, &nodes_.at(key) });
+        }
+        return key;
+    }
+
+    void load_paths(const std::vector<std::string>& lines, const std::string& sep,
+                    std::vector<Added>& added) {
+        for (std::string line : lines) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            std::uintptr_t parent = 0;
+            std::size_t pos = 0;
+            while (pos <= line.size()) {
+                std::size_t end = sep.empty() ? line.size() : line.find(sep, pos);
+                if (end == std::string::npos) end = line.size();
+                if (end > pos) parent = child(parent, line.substr(pos, end - pos), sep, added);
+                pos = end + (sep.empty() ? 1 : sep.size());
+            }
+        }
+    }
+
+    void load_outline(const std::vector<std::string>& lines, const std::string& sep,
+                      std::vector<Added>& added) {
+        std::vector<std::pair<std::size_t, std::uintptr_t>> stack;   // indent, key
+        for (std::string line : lines) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (blank(line)) continue;
+            std::size_t col = 0, i = 0;
+            for (; i < line.size() && (line[i] == ' ' || line[i] == '\t'); ++i)
+                col = line[i] == '\t' ? (col / 8 + 1) * 8 : col + 1;
+            while (!stack.empty() && stack.back().first >= col) stack.pop_back();
+            std::uintptr_t parent = stack.empty() ? 0 : stack.back().second;
+            std::size_t e = line.find_last_not_of(" \t");
+            stack.emplace_back(col, child(parent, line.substr(i, e + 1 - i), sep, added));
+        }
+    }
+
+    std::unordered_map<std::uintptr_t, Node>        nodes_;
+    std::unordered_map<std::string, std::uintptr_t> by_path_;
+    std::map<std::vector<int>, std::uintptr_t>      by_indexes_;
+    std::vector<std::uintptr_t>                     order_;
+    std::uintptr_t                                  next_key_ = 1;
+    int                                             roots_    = 0;
+};
@@ -0,0 +1,57 @@
+#pragma once
+
+/**
+ * newt_virtual_listbox.hpp
+ *
+ * Sliding-window arithmetic for VirtualListbox.  A virtual listbox keeps the
+ * full row set in a RowStore and materialises only `size` consecutive rows
+ * [base, base + count) in the real libnewt listbox.  Whenever the cursor comes
+ * within `margin` rows of either edge of the window (and there is more data
+ * beyond that edge) the window is re-centred on the cursor and refilled.
+ *
+ * Keeping margin >= the listbox height guarantees that a PgUp/PgDn never
+ * lands on the window edge, so the user never sees the list "end" early.
+ */
+
+#include <cstddef>
+
+namespace newt_virtual_listbox {
+
+struct Window {
+    std::size_t base  = 0;   // global index of the first materialised row
+    std::size_t count = 0;   // number of materialised rows
+};
+
+// Window rows and edge margin for a listbox that shows `height` rows.
+inline std::size_t window_size(int height) {
+    std::size_t h = height > 0 ? static_cast<std::size_t>(height) : 1;
+    return h * 4 < 64 ? 64 : h * 4;
+}
+
+inline std::size_t edge_margin(int height) {
+    return height > 0 ? static_cast<std::size_t>(height) : 1;
+}
+
+// Window of at most `size` rows out of `total`, centred on `cursor` and
+// clamped to the ends of the data set.
+inline Window centre_on(std::size_t cursor, std::size_t total, std::size_t size) {
+    Window w;
+    w.count = total < size ? total : size;
+    std::size_t half = w.count / 2;
+    w.base = cursor > half ? cursor - half : 0;
+    if (w.base + w.count > total) w.base = total - w.count;
+    return w;
+}
+
+// True when the cursor (a global index inside `w`) is within `margin` rows of
+// an edge that has more data beyond it.
+inline bool needs_refill(const Window& w, std::size_t cursor,
+                         std::size_t total, std::size_t margin) {
+    if (w.count == 0) return false;
+    std::size_t rel = cursor - w.base;
+    if (rel < margin && w.base > 0) return true;
+    if (rel + margin >= w.count && w.base + w.count < total) return true;
+    return false;
+}
+
+} // namespace newt_virtual_listbox
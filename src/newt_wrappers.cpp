@@ -1,15 +1,26 @@
 
 #include <config.h>
 
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <fcntl.h>
 #include <map>
 #include <memory>
+#include <poll.h>
+#include <set>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 extern "C" {
 #include <newt.h>
+#include <slang.h>
 #include "builtins.h"
 #include "shell.h"
 #include "bashgetopt.h"
@@ -17,7 +28,31 @@ extern "C" {
 }
 
 #include "newt_arg_parser.hpp"
+#include "newt_async_load.hpp"
+#include "newt_child_command.hpp"
+#include "newt_form_registry.hpp"
+#include "newt_form_snapshot.hpp"
+#include "newt_dir_scan.hpp"
+#include "newt_entry_filter.hpp"
+#include "newt_entry_validator.hpp"
+#include "newt_event_queue.hpp"
+#include "newt_fuzzy.hpp"
 #include "newt_init_guard.hpp"
+#include "newt_line_index.hpp"
+#include "newt_listbox_filter.hpp"
+#include "newt_listbox_sort.hpp"
+#include "newt_mapped_file.hpp"
+#include "newt_output_stats.hpp"
+#include "newt_palette.hpp"
+#include "newt_paste_burst.hpp"
+#include "newt_progress_panel.hpp"
+#include "newt_row_store.hpp"
+#include "newt_screen_dump.hpp"
+#include "newt_shm_counter.hpp"
+#include "newt_text_tail.hpp"
+#include "newt_thread_pool.hpp"
+#include "newt_tree_index.hpp"
+#include "newt_virtual_listbox.hpp"
 #include "newt_wrappers.hpp"
 
 // ─── per-component data storage ───────────────────────────────────────────────
@@ -30,6 +65,17 @@ static std::map<newtComponent, std::unique_ptr<char>> g_checkbox_results;
 // function that should be called as the entry filter.
 static std::map<newtComponent, std::string> g_entry_filters;
 
+// Paste functions (the optional third argument of EntrySetFilter): called once
+// with a whole burst of buffered text keys instead of the entry filter per key.
+static std::map<newtComponent, std::string> g_paste_filters;
+
+// Native entry filters (EntrySetNativeFilter), applied in entry_filter_shim
+// before the bash filter, if any.
+static std::map<newtComponent, newt_entry_filter::NativeFilter> g_native_filters;
+
+// Entry validators (EntrySetValidator), checked by FormValidate.
+static std::map<newtComponent, EntryValidator> g_entry_validators;
+
 // Suspend callback: name of the bash function registered via SetSuspendCallback.
 static std::string g_suspend_callback_fn;
 
@@ -42,14 +88,639 @@ static std::map<newtComponent, std::string> g_destroy_callbacks;
 // NEWT_CB_DATA before evaluating the expression.
 static std::map<newtComponent, std::pair<std::string, std::string>> g_component_callbacks;
 
+// Queued callback mode (EventsSetQueued): while it is on, the callback and
+// destroy shims queue an event for EventsDrain instead of evaluating the
+// registered bash expression.
+static EventQueue g_events;
+static bool       g_events_queued = false;
+
+// Virtual listboxes: maps a listbox created by VirtualListbox to its full row
+// set and the window of rows currently materialised in libnewt.  The libnewt
+// data key of every materialised row is its global row index.
+struct VirtualListboxState {
+    RowStore                      rows;
+    newt_virtual_listbox::Window  window;
+    std::size_t                   cursor    = 0;   // global index of current row
+    int                           height    = 0;
+    bool                          refilling = false;
+};
+static std::map<newtComponent, std::unique_ptr<VirtualListboxState>> g_virtual_listboxes;
+
+// File-backed textboxes: maps a textbox loaded with TextboxLoadFile to its
+// mmap'd file, lazy line index and the first file line currently shown.
+struct TextboxFileState {
+    MappedFile  file;
+    LineIndex   index;
+    std::size_t top    = 0;
+    int         width  = 1;
+    int         height = 1;
+};
+static std::map<newtComponent, std::unique_ptr<TextboxFileState>> g_textbox_files;
+
+// Forms whose paging hotkeys scroll a file-backed textbox: form → textbox.
+static std::map<newtComponent, newtComponent> g_paged_forms;
+
+// Hotkeys a script registered with FormAddHotKey.  The builtin's own paging
+// hotkeys (Up, Down, PgUp, PgDn, …) that nothing used are handed back to the
+// focused component (form_key_fallback) unless the script asked for them too.
+static std::map<newtComponent, std::set<int>> g_script_hotkeys;
+
+// Timers set with FormSetTimer: libnewt has no getter and restarts the
+// interval whenever the timer is set, so the builtin keeps the interval and
+// the time it last fired (or was set), and arms libnewt's timer with what is
+// left of it for each FormRun and FormPoll.
+struct FormTimer {
+    int interval;
+    std::chrono::steady_clock::time_point last;
+};
+static std::map<newtComponent, FormTimer> g_form_timers;
+
+// Textboxes showing a command started with TextboxRunCommand: the command,
+// the scrollback of its output, the page shown (in lines up from the bottom;
+// 0 follows the output) and the variable (from -v) that receives its exit
+// status.  The scrollback stays until the textbox is destroyed or runs the
+// next command.
+struct TextboxCommandState {
+    ChildCommand command;
+    TextTail     tail;
+    std::string  status_var;
+    std::size_t  height  = 1;
+    std::size_t  back    = 0;
+    bool         running = true;
+
+    TextboxCommandState(std::size_t lines, std::size_t cols, std::size_t rows)
+        : tail(lines, cols), height(rows) {}
+};
+static std::map<newtComponent, std::unique_ptr<TextboxCommandState>> g_textbox_commands;
+
+// Lines of command output kept per textbox unless TextboxSetScrollback says
+// otherwise.
+static constexpr std::size_t kTextboxScrollback = 2000;
+
+// Textboxes created with Textbox or TextboxReflowed: the form
+// FormAddComponent(s) or GridAddComponentsToForm added them to (form_run only
+// streams command output into the running form's textboxes) and their
+// scrollback.
+struct TextboxInfo {
+    newtComponent form       = nullptr;
+    std::size_t   scrollback = kTextboxScrollback;
+};
+static std::map<newtComponent, TextboxInfo> g_textboxes;
+
+// What GridSetField, the Grid*Stacked builders and GridSimpleWindow /
+// GridBasicWindow put in each cell of a grid, keyed by (col, row) so that the
+// walk in GridAddComponentsToForm adds them in libnewt's order.  libnewt does
+// not expose a grid's fields.
+using GridFields = std::map<std::pair<int, int>, std::pair<newtGridElement, void*>>;
+static std::map<newtGrid, GridFields> g_grid_fields;
+
+// Progress panels: maps the handle of a ProgressPanel (the scale of its first
+// job) to the job model, the widgets of each row, the fds feeding it and
+// when its widgets were last brought up to date.
+struct ProgressPanelState {
+    newtComponent                            form = nullptr;
+    newt_progress::ProgressModel             model;
+    newt_progress::Layout                    layout;
+    std::vector<newtComponent>               scales;
+    std::vector<newtComponent>               messages;   // empty without a message column
+    std::map<int, newt_progress::LineBuffer> fds;
+    int                                      budget_ms = 50;
+    std::chrono::steady_clock::time_point    last_frame;
+
+    ProgressPanelState(const std::vector<std::string>& ids, newt_progress::Layout l)
+        : model(ids), layout(l) {}
+};
+static std::map<newtComponent, std::unique_ptr<ProgressPanelState>> g_progress_panels;
+
+// Scales bound to a shared counter file by ScaleBindShm, sampled whenever
+// their timer fires during a form run.
+struct ScaleShmState {
+    ShmCounter  counter;
+    SampleTimer timer;
+};
+static std::map<newtComponent, std::unique_ptr<ScaleShmState>> g_scale_shm;
+
+// Filtered listboxes: maps a listbox bound with ListboxFilterBind to the
+// unfiltered rows (text + libnewt data key) and the rows currently shown.
+struct ListboxFilterState {
+    newtComponent              entry = nullptr;
+    RowStore                   rows;
+    std::vector<void*>         keys;
+    std::vector<std::uint32_t> shown;          // row indices, ascending
+    std::string                needle;         // prepared query of 'shown'
+    bool                       fold        = true;
+    bool                       unique_keys = true;
+};
+static std::map<newtComponent, std::unique_ptr<ListboxFilterState>> g_listbox_filters;
+
+// Entries driving a filtered listbox: entry → listbox.
+static std::map<newtComponent, newtComponent> g_filter_entries;
+
+// Fuzzy pickers: maps the listbox of a FuzzyPicker to its candidates, the
+// matcher scoring them and the pipe on which finished background runs are
+// announced to the form (watched with newtFormWatchFd).  The data key of each
+// listbox row is its candidate index.
+struct FuzzyPickerState {
+    newtComponent                             form    = nullptr;
+    newtComponent                             entry   = nullptr;
+    newtComponent                             listbox = nullptr;
+    newtComponent                             preview = nullptr;
+    RowStore                                  rows;
+    std::unique_ptr<newt_fuzzy::FuzzyMatcher> matcher;
+    int                                       notify[2] = { -1, -1 };
+    std::vector<std::uint32_t>                shown;   // candidate indices, best first
+    std::size_t                               matches = 0;
+    std::string                               query;
+
+    ~FuzzyPickerState() {
+        matcher.reset();   // waits for runs in flight
+        for (int fd : notify) if (fd >= 0) ::close(fd);
+    }
+};
+static std::map<newtComponent, std::unique_ptr<FuzzyPickerState>> g_fuzzy_pickers;
+
+// Entries of fuzzy pickers: entry → listbox.
+static std::map<newtComponent, newtComponent> g_fuzzy_entries;
+
+// File pickers: maps the checkbox tree of a FilePicker to its directory
+// scanner and the shape of what has been put into the tree, with paths
+// relative to 'root'.  Every directory node starts with a single child "."
+// standing for the directory itself: it makes the node expandable before its
+// entries are read, and selecting it picks the directory.
+struct FilePickerState {
+    std::string                                root;
+    TreeIndex                                  index;
+    std::unique_ptr<newt_dir_scan::DirScanner> scanner;
+    std::unordered_set<std::uintptr_t>         dirs;      // directory nodes
+    std::unordered_set<std::uintptr_t>         unread;    // … whose entries are not in the tree
+    std::unordered_set<std::uintptr_t>         waiting;   // … expanded, to fill on wake-up
+};
+static std::map<newtComponent, std::unique_ptr<FilePickerState>> g_file_pickers;
+
+// Checkbox trees created by the builtin: their value sequence and, as long as
+// every node was added through CheckboxTreeLoad or appended with
+// CheckboxTreeAddItem, their shape indexed by path, data key and index path.
+struct CheckboxTreeState {
+    TreeIndex   index;
+    std::string seq     = " *";   // value characters, unselected first
+    std::string sep     = "/";    // path separator of the last load
+    bool        indexed = true;   // false once a node was inserted mid-level
+};
+static std::map<newtComponent, std::unique_ptr<CheckboxTreeState>> g_checkbox_trees;
+
+// Palettes defined with PaletteDefine / PaletteLoad: the parsed strings and
+// the newtColors pointing into them, ready for newtSetColors.
+struct PaletteState {
+    newt_palette::Palette palette;
+    struct newtColors     colors;
+};
+static std::unordered_map<std::string, std::unique_ptr<PaletteState>> g_palettes;
+
+// Terminal output accounting (OutputStatsStart): while enabled and newt is
+// initialised, S-Lang writes through g_output_pipe, which counts and forwards
+// to the terminal.  The pipe is never destroyed: a subshell exiting must not
+// try to join a forwarding thread it does not have.  A subshell keeps writing
+// through the pipe it inherited (the parent forwards it) but never stops,
+// drains or counts it: the forwarder, and its stop signal, are the parent's.
+static CountingPipe*  g_output_pipe = new CountingPipe;
+static FrameStats     g_output_frames;
+static bool           g_output_stats     = false;
+static int            g_output_saved_fd  = -1;
+static std::uint64_t  g_output_carried   = 0;   // bytes counted by earlier pipes
+static pid_t          g_output_owner     = 0;   // process that started the pipe
+
+// Background loads started with AsyncLoad.  Like the thread pool they run on,
+// the loader belongs to the process that created it and is never destroyed:
+// a subshell gets a fresh one and must not wait for its parent's loads.
+static newt_async_load::Loader* g_async_loader = nullptr;
+static pid_t                    g_async_owner  = 0;
+
+static newt_async_load::Loader& async_loader() {
+    if (!g_async_loader || g_async_owner != ::getpid()) {
+        g_async_loader = new newt_async_load::Loader;
+        g_async_owner  = ::getpid();
+    }
+    return *g_async_loader;
+}
+
+// Kind, user-assigned id and form of every value-holding component created by
+// the builtin, and which of them changed in the last run of their form; read
+// by FormCollect, FormSnapshot and FormGetChanged.
+static FormRegistry g_forms;
+
+// ─── virtual listbox window management ───────────────────────────────────────
+// Replaces the listbox contents with the window centred on global row 'cursor'
+// and makes that row current.  When 'cursor_at_top' is set the row is shown
+// on the first visible line (scrolling up) rather than the last.
+static void virtual_listbox_refill(newtComponent co, VirtualListboxState& st,
+                                   std::size_t cursor, bool cursor_at_top) {
+    namespace vl = newt_virtual_listbox;
+
+    st.refilling = true;
+    newtListboxClear(co);
+    st.window = vl::centre_on(cursor, st.rows.size(), vl::window_size(st.height));
+    for (std::size_t i = 0; i < st.window.count; ++i) {
+        std::size_t g = st.window.base + i;
+        newtListboxAppendEntry(co, st.rows[g],
+                               reinterpret_cast<void*>(static_cast<intptr_t>(g)));
+    }
+    st.cursor = cursor;
+    if (st.window.count) {
+        int rel  = static_cast<int>(cursor - st.window.base);
+        int last = static_cast<int>(st.window.count) - 1;
+        // Selecting a row one page below first pins the scroll offset so that
+        // the real target ends up on the top line.
+        if (cursor_at_top && st.height > 1)
+            newtListboxSetCurrent(co, std::min(rel + st.height - 1, last));
+        newtListboxSetCurrent(co, rel);
+    }
+    st.refilling = false;
+}
+
+// Called from component_callback_shim whenever the libnewt cursor moves.
+// Home/End inside the window show up as a jump of at least one page onto the
+// window edge and are translated into jumps to the ends of the full data set.
+static void virtual_listbox_cursor_moved(newtComponent co, VirtualListboxState& st) {
+    namespace vl = newt_virtual_listbox;
+    if (st.window.count == 0) return;
+
+    std::size_t total = st.rows.size();
+    std::size_t page  = vl::edge_margin(st.height);
+    std::size_t first = st.window.base;
+    std::size_t last  = st.window.base + st.window.count - 1;
+    std::size_t cur   = reinterpret_cast<uintptr_t>(newtListboxGetCurrent(co));
+    bool        up    = cur < st.cursor;
+
+    if (cur == first && first > 0 && st.cursor >= cur + page)
+        cur = 0;
+    else if (cur == last && last + 1 < total && cur >= st.cursor + page)
+        cur = total - 1;
+
+    if (cur < first || cur > last || vl::needs_refill(st.window, cur, total, page))
+        virtual_listbox_refill(co, st, cur, up);
+    else
+        st.cursor = cur;
+}
+
+// ─── listbox filtering ────────────────────────────────────────────────────────
+// Rows of a bound listbox are matched natively against the entry text; the
+// libnewt listbox is only touched when the set of matching rows changes.
+
+// A narrowing keystroke that hides at most this many rows deletes them one by
+// one (each delete is a linear search in libnewt); otherwise the listbox is
+// cleared and refilled.
+static constexpr std::size_t kFilterIncrementalDeletes = 16;
+
+// Shows the rows matching 'query', keeping the current item when it is still
+// visible.
+static void listbox_filter_apply(newtComponent co, ListboxFilterState& st,
+                                 const std::string& query) {
+    namespace lf = newt_listbox_filter;
+
+    std::string needle = lf::prepare_query(query, st.fold);
+    if (needle == st.needle) return;
+
+    // Matches of a query containing the previous one are a subset of the
+    // previous matches.
+    bool narrowing = needle.find(st.needle) != std::string::npos;
+    std::vector<std::uint32_t> next;
+    if (narrowing)
+        lf::match_subset(st.rows, needle, st.fold, st.shown, next);
+    else
+        lf::match_all(st.rows, needle, st.fold, next);
+
+    if (next != st.shown) {
+        if (narrowing && st.unique_keys &&
+            st.shown.size() - next.size() <= kFilterIncrementalDeletes) {
+            std::size_t j = 0;
+            for (std::uint32_t i : st.shown) {
+                if (j < next.size() && next[j] == i) ++j;
+                else newtListboxDeleteEntry(co, st.keys[i]);
+            }
+        } else {
+            void* cur = newtListboxItemCount(co) ? newtListboxGetCurrent(co) : nullptr;
+            newtListboxClear(co);
+            bool cur_shown = false;
+            for (std::uint32_t i : next) {
+                newtListboxAppendEntry(co, st.rows[i], st.keys[i]);
+                cur_shown = cur_shown || st.keys[i] == cur;
+            }
+            if (cur_shown) newtListboxSetCurrentByKey(co, cur);
+        }
+        st.shown.swap(next);
+    }
+    st.needle.swap(needle);
+}
+
+// Puts every row back into the listbox, keeping the current item.
+static void listbox_filter_restore(newtComponent co, ListboxFilterState& st) {
+    if (st.shown.size() == st.rows.size()) return;
+    void* cur = newtListboxItemCount(co) ? newtListboxGetCurrent(co) : nullptr;
+    newtListboxClear(co);
+    for (std::size_t i = 0; i < st.rows.size(); ++i)
+        newtListboxAppendEntry(co, st.rows[i], st.keys[i]);
+    if (cur) newtListboxSetCurrentByKey(co, cur);
+}
+
+// Classifies an entry keystroke the way libnewt's entry widget applies it.
+static newt_listbox_filter::EditOp entry_edit_op(int ch) {
+    using newt_listbox_filter::EditOp;
+    switch (ch) {
+    case '\b': case 127: case NEWT_KEY_BKSPC: return EditOp::Backspace;
+    case '\004':         case NEWT_KEY_DELETE: return EditOp::Delete;
+    case '\013':                               return EditOp::KillToEnd;
+    case '\025':                               return EditOp::KillToStart;
+    default: break;
+    }
+    if ((ch >= 0x20 && ch <= 0x7e) || (ch >= 0x80 && ch <= 0xff))
+        return EditOp::Insert;
+    return EditOp::None;
+}
+
+// Called from entry_filter_shim with the key libnewt is about to apply.
+static void listbox_filter_key(newtComponent entry, int ch, int cursor) {
+    auto fe = g_filter_entries.find(entry);
+    if (fe == g_filter_entries.end()) return;
+    auto it = g_listbox_filters.find(fe->second);
+    if (it == g_listbox_filters.end()) return;
+
+    namespace lf = newt_listbox_filter;
+    lf::EditOp op = entry_edit_op(ch);
+    if (op == lf::EditOp::None) return;
+    const char* value = newtEntryGetValue(entry);
+    listbox_filter_apply(fe->second, *it->second,
+                         lf::predict_edit(value ? value : "", cursor, op, ch));
+}
+
+// ─── fuzzy picker ─────────────────────────────────────────────────────────────
+// Candidate sets up to this size are scored on the UI thread; larger ones go
+// to the shared thread pool and arrive through the picker's notify pipe.
+static constexpr std::size_t kFuzzySyncRows = 2 * newt_fuzzy::FuzzyMatcher::kChunk;
+
+// Number of best matches shown in the listbox.
+static constexpr std::size_t kFuzzyTopK = 1000;
+
+// Shows the full text of the current candidate in the preview textbox.
+static void fuzzy_picker_preview(FuzzyPickerState& st) {
+    if (!st.preview) return;
+    const char* text = "";
+    if (newtListboxItemCount(st.listbox) > 0)
+        text = st.rows[reinterpret_cast<uintptr_t>(newtListboxGetCurrent(st.listbox))];
+    newtTextboxSetText(st.preview, text);
+}
+
+static void fuzzy_picker_show(FuzzyPickerState& st, newt_fuzzy::Result&& r) {
+    st.matches = r.matches;
+    st.shown.swap(r.top);
+    newtListboxClear(st.listbox);
+    for (std::uint32_t i : st.shown)
+        newtListboxAppendEntry(st.listbox, st.rows[i],
+                               reinterpret_cast<void*>(static_cast<uintptr_t>(i)));
+    if (!st.shown.empty()) newtListboxSetCurrent(st.listbox, 0);
+    fuzzy_picker_preview(st);
+}
+
+// Rescores for 'query' unless it is already the current one ('force' skips
+// that check, e.g. after new candidates were loaded).
+static void fuzzy_picker_query(FuzzyPickerState& st, const std::string& query,
+                               bool force = false) {
+    if (!force && query == st.query) return;
+    st.query = query;
+    if (st.rows.size() <= kFuzzySyncRows) {
+        st.matcher->cancel();
+        fuzzy_picker_show(st, st.matcher->run(query));
+    } else {
+        st.matcher->start(shared_thread_pool(), query, st.notify[1]);
+    }
+}
+
+// Called from form_run for a hotkey of 'form'.  Up/Down/PgUp/PgDn are
+// hotkeys of a form holding a fuzzy picker, so that they move the listbox
+// cursor while the entry keeps the focus (an entry filter cannot stop the
+// form from moving the focus on them).  Only used while the picker's entry
+// or listbox has the focus.  Returns true if the key was used.
+static bool fuzzy_picker_hotkey(newtComponent form, int key) {
+    newtComponent focus = newtFormGetCurrent(form);
+    for (auto& kv : g_fuzzy_pickers) {
+        FuzzyPickerState& st = *kv.second;
+        if (st.form != form || (focus != st.entry && focus != st.listbox)) continue;
+
+        int step = 0, page = 0, dummy = 0;
+        newtComponentGetSize(st.listbox, &dummy, &page);
+        switch (key) {
+        case NEWT_KEY_UP:   step = -1;                    break;
+        case NEWT_KEY_DOWN: step = 1;                     break;
+        case NEWT_KEY_PGUP: step = -std::max(page, 1);    break;
+        case NEWT_KEY_PGDN: step = std::max(page, 1);     break;
+        default: return false;
+        }
+        int n = static_cast<int>(st.shown.size());
+        if (n == 0) return true;
+        uintptr_t cur = reinterpret_cast<uintptr_t>(newtListboxGetCurrent(st.listbox));
+        int pos = static_cast<int>(std::find(st.shown.begin(), st.shown.end(), cur)
+                                   - st.shown.begin());
+        newtListboxSetCurrent(st.listbox, std::clamp(pos + step, 0, n - 1));
+        fuzzy_picker_preview(st);
+        return true;
+    }
+    return false;
+}
+
+// Called from entry_filter_shim.  Editing keys rescore.
+static void fuzzy_picker_key(newtComponent entry, int ch, int cursor) {
+    auto fe = g_fuzzy_entries.find(entry);
+    if (fe == g_fuzzy_entries.end()) return;
+    auto it = g_fuzzy_pickers.find(fe->second);
+    if (it == g_fuzzy_pickers.end()) return;
+
+    namespace lf = newt_listbox_filter;
+    lf::EditOp op = entry_edit_op(ch);
+    if (op == lf::EditOp::None) return;
+    const char* value = newtEntryGetValue(entry);
+    fuzzy_picker_query(*it->second, lf::predict_edit(value ? value : "", cursor, op, ch));
+}
+
+// Called from form_run when a watched fd is readable.  Returns true if 'fd'
+// is the notify pipe of a fuzzy picker (the latest result is then shown).
+static bool fuzzy_picker_ready(int fd) {
+    for (auto& kv : g_fuzzy_pickers) {
+        FuzzyPickerState& st = *kv.second;
+        if (st.notify[0] != fd) continue;
+        char buf[64];
+        while (::read(fd, buf, sizeof(buf)) > 0) {}
+        newt_fuzzy::Result r;
+        if (st.matcher->take(r) && r.generation == st.matcher->generation())
+            fuzzy_picker_show(st, std::move(r));
+        return true;
+    }
+    return false;
+}
+
+// ─── file picker ──────────────────────────────────────────────────────────────
+// Directory nodes are filled lazily: expanding one (seen in the tree's change
+// callback) asks the scanner for its listing and marks it waiting; the nodes
+// are added from form_run once the scanner's pipe wakes the form, never from
+// inside the tree's own event handler.
+
+// Absolute path of the directory or file at relative path 'rel'.
+static std::string file_picker_path(const FilePickerState& st, const std::string& rel) {
+    return rel.empty() ? st.root : newt_dir_scan::join(st.root, rel);
+}
+
+// Appends a node to the tree and the index.  Returns its data key.
+static std::uintptr_t file_picker_add(newtComponent co, FilePickerState& st,
+                                      std::uintptr_t parent, const std::string& name,
+                                      const std::string& label) {
+    std::uintptr_t key = st.index.add(parent, name, "/");
+    const std::vector<int>& ix = st.index.find(key)->indexes;
+    std::vector<int> idx(ix.begin(), ix.end() - 1);
+    idx.push_back(NEWT_ARG_APPEND);
+    idx.push_back(NEWT_ARG_LAST);
+    newtCheckboxTreeAddArray(co, label.c_str(), reinterpret_cast<void*>(key), 0, idx.data());
+    return key;
+}
+
+// Adds the entries of directory node 'dir' (0 for the root) to the tree.  A
+// directory that cannot be read keeps only its "." child, relabelled with
+// the error.
+static void file_picker_fill(newtComponent co, FilePickerState& st, std::uintptr_t dir,
+                             const newt_dir_scan::Listing& l) {
+    st.unread.erase(dir);
+    if (l.error) {
+        const TreeIndex::Node* n = st.index.find(dir);
+        std::uintptr_t self = st.index.find_path(n ? n->path + "/." : ".");
+        std::string label = std::string(". (") + std::strerror(l.error) + ")";
+        if (self) newtCheckboxTreeSetEntry(co, reinterpret_cast<void*>(self), label.c_str());
+        return;
+    }
+    for (const newt_dir_scan::Entry& e : l.entries) {
+        if (!e.dir) {
+            file_picker_add(co, st, dir, e.name, e.name);
+            continue;
+        }
+        std::uintptr_t key = file_picker_add(co, st, dir, e.name, e.name + "/");
+        file_picker_add(co, st, key, ".", ".");
+        st.dirs.insert(key);
+        st.unread.insert(key);
+    }
+}
+
+// Called from the tree's change callback: notices that the current node is
+// an unread directory that has just been expanded.
+static void file_picker_expanded(newtComponent co, FilePickerState& st) {
+    const void* cur = newtCheckboxTreeGetCurrent(co);
+    std::uintptr_t key = reinterpret_cast<std::uintptr_t>(cur);
+    if (!st.unread.count(key) || st.waiting.count(key) ||
+        newtCheckboxTreeGetEntryValue(co, cur) != NEWT_CHECKBOXTREE_EXPANDED)
+        return;
+    std::string path = file_picker_path(st, st.index.find(key)->path);
+    st.waiting.insert(key);
+    st.scanner->request(path, true);
+    if (st.scanner->find(path)) st.scanner->wake();
+}
+
+// Called from form_run when a watched fd is readable.  Returns true if 'fd'
+// is the scanner pipe of a file picker (waiting directories whose listing
+// has arrived are then filled in).
+static bool file_picker_ready(int fd) {
+    for (auto& kv : g_file_pickers) {
+        FilePickerState& st = *kv.second;
+        if (st.scanner->fd() != fd) continue;
+        st.scanner->drain();
+        newtComponent co  = kv.first;
+        const void*   cur = newtCheckboxTreeGetCurrent(co);
+        bool          filled = false;
+        for (auto it = st.waiting.begin(); it != st.waiting.end(); ) {
+            auto l = st.scanner->find(file_picker_path(st, st.index.find(*it)->path));
+            if (!l) { ++it; continue; }
+            file_picker_fill(co, st, *it, *l);
+            it = st.waiting.erase(it);
+            filled = true;
+        }
+        if (filled) newtCheckboxTreeSetCurrent(co, const_cast<void*>(cur));
+        return true;
+    }
+    return false;
+}
+
 // ─── entry filter C shim ──────────────────────────────────────────────────────
-// Called by libnewt for every keystroke in a filtered entry widget.  Looks up
-// the bash function registered for 'co', sets NEWT_ENTRY / NEWT_CH /
-// NEWT_CURSOR, evaluates the function and returns the (possibly filtered) char.
+// Handles a paste burst starting with text key 'ch' at 'cursor' of an entry
+// that has a paste function: the buffered text keys are collected, run
+// through the native filter, and handed to the paste function as NEWT_PASTE
+// (with NEWT_ENTRY / NEWT_CURSOR).  The function may rewrite NEWT_PASTE; its
+// value is inserted unless the function returns non-zero.
+static void entry_paste(newtComponent co, int ch, int cursor) {
+    std::string text = newt_paste::collect(
+        ch,
+        [] { return SLang_input_pending(0) > 0; },
+        [] { return static_cast<int>(SLang_getkey()); },
+        [](int key) { if (key <= 0xff) SLang_ungetkey(static_cast<unsigned char>(key)); });
+    const char* value = newtEntryGetValue(co);
+    if (!value) value = "";
+    auto nf = g_native_filters.find(co);
+    if (nf != g_native_filters.end()) text = nf->second.filter_text(value, text);
+    if (text.empty()) return;
+
+    std::string co_str = to_bash_string(co);
+    char cur_str[16]; std::snprintf(cur_str, sizeof(cur_str), "%d", cursor);
+
+    builtin_bind_variable(const_cast<char*>("NEWT_ENTRY"),  const_cast<char*>(co_str.c_str()), 0);
+    builtin_bind_variable(const_cast<char*>("NEWT_CURSOR"), cur_str, 0);
+    builtin_bind_variable(const_cast<char*>("NEWT_PASTE"),  const_cast<char*>(text.c_str()), 0);
+
+    const std::string& s = g_paste_filters[co];
+    char* cmd = reinterpret_cast<char*>(xmalloc(s.size() + 1));
+    std::memcpy(cmd, s.c_str(), s.size() + 1);
+    if (evalstring(cmd, nullptr, 0) != 0) return;
+    SHELL_VAR* var = find_variable("NEWT_PASTE");
+    if (!var || array_p(var) || assoc_p(var) || !value_cell(var)) return;
+    text = value_cell(var);
+    if (text.empty()) return;
+
+    // The entry may have changed under the paste function.
+    value = newtEntryGetValue(co);
+    std::string next = newt_paste::splice(value ? value : "", static_cast<std::size_t>(cursor), text);
+    newtEntrySet(co, next.c_str(), 0);
+    newtEntrySetCursorPosition(co, static_cast<int>(std::min(next.size(),
+                                                             cursor + text.size())));
+
+    auto fe = g_filter_entries.find(co);
+    if (fe != g_filter_entries.end()) {
+        auto lf = g_listbox_filters.find(fe->second);
+        if (lf != g_listbox_filters.end()) listbox_filter_apply(fe->second, *lf->second, next);
+    }
+    auto ff = g_fuzzy_entries.find(co);
+    if (ff != g_fuzzy_entries.end()) {
+        auto fp = g_fuzzy_pickers.find(ff->second);
+        if (fp != g_fuzzy_pickers.end()) fuzzy_picker_query(*fp->second, next);
+    }
+}
+
+// Called by libnewt for every keystroke in a filtered entry widget.  Applies
+// the native filter of 'co', if any, then looks up the bash function
+// registered for it, sets NEWT_ENTRY / NEWT_CH / NEWT_CURSOR, evaluates the
+// function and returns the (possibly filtered) char.  Keys that get through
+// also update a listbox bound with ListboxFilterBind and rescore a
+// FuzzyPicker.  A text key with more input already buffered is the start of
+// a paste and goes to the entry's paste function, if it has one.
 static int entry_filter_shim(newtComponent co, void* /*data*/, int ch,
                               int cursor) {
+    if (newt_paste::is_text(ch) && g_paste_filters.count(co) &&
+        SLang_input_pending(0) > 0) {
+        entry_paste(co, ch, cursor);
+        return 0;
+    }
+    auto nf = g_native_filters.find(co);
+    if (nf != g_native_filters.end()) {
+        ch = nf->second.apply(ch, newtEntryGetValue(co));
+        if (!ch) return 0;
+    }
     auto it = g_entry_filters.find(co);
-    if (it == g_entry_filters.end()) return ch;
+    if (it == g_entry_filters.end()) {
+        listbox_filter_key(co, ch, cursor);
+        fuzzy_picker_key(co, ch, cursor);
+        return ch;
+    }
 
     std::string co_str = to_bash_string(co);
     char ch_str[8];   std::snprintf(ch_str,  sizeof(ch_str),  "%d", ch);
@@ -64,7 +735,10 @@ static int entry_filter_shim(newtComponent co, void* /*data*/, int ch,
     char* cmd = reinterpret_cast<char*>(xmalloc(s.size() + 1));
     std::memcpy(cmd, s.c_str(), s.size() + 1);
     int ret = evalstring(cmd, nullptr, 0);
-    return (ret == 0) ? ch : 0;
+    if (ret != 0) return 0;
+    listbox_filter_key(co, ch, cursor);
+    fuzzy_picker_key(co, ch, cursor);
+    return ch;
 }
 
 // Called by libnewt when CTRL+Z is pressed while a form is running.  Looks up
@@ -79,10 +753,26 @@ static void suspend_callback_shim(void* /*data*/) {
 
 // Called by libnewt when a component fires its change/focus callback.
 // Sets NEWT_COMPONENT and NEWT_CB_DATA, then evaluates the registered bash
-// expression.
+// expression (or queues the event, in queued mode).
 static void component_callback_shim(newtComponent co, void* /*data*/) {
+    g_forms.touch(co);
+    auto vl = g_virtual_listboxes.find(co);
+    if (vl != g_virtual_listboxes.end()) {
+        // Our own ListboxClear/SetCurrent calls re-enter the callback.
+        if (vl->second->refilling) return;
+        virtual_listbox_cursor_moved(co, *vl->second);
+    }
+    auto fp = g_fuzzy_pickers.find(co);
+    if (fp != g_fuzzy_pickers.end()) fuzzy_picker_preview(*fp->second);
+    auto fl = g_file_pickers.find(co);
+    if (fl != g_file_pickers.end()) file_picker_expanded(co, *fl->second);
+
     auto it = g_component_callbacks.find(co);
     if (it == g_component_callbacks.end()) return;
+    if (g_events_queued) {
+        g_events.push(EventQueue::Type::Callback, co, it->second.second);
+        return;
+    }
 
     std::string co_str = to_bash_string(co);
     builtin_bind_variable(const_cast<char*>("NEWT_COMPONENT"),
@@ -96,11 +786,49 @@ static void component_callback_shim(newtComponent co, void* /*data*/) {
     evalstring(cmd, nullptr, 0);
 }
 
-// Called by libnewt when a component is destroyed.  Looks up the bash
-// expression registered for 'co' and evaluates it.
+// Called by libnewt when a component is destroyed.  Drops any native state
+// kept for 'co', then looks up the bash expression registered for it and
+// evaluates it (or queues the event, in queued mode).
 static void component_destroy_shim(newtComponent co, void* /*data*/) {
+    g_forms.destroyed(co);
+    g_checkbox_results.erase(co);
+    g_virtual_listboxes.erase(co);
+    g_checkbox_trees.erase(co);
+    if (g_async_loader) g_async_loader->cancel(co);
+    auto lf = g_listbox_filters.find(co);
+    if (lf != g_listbox_filters.end()) {
+        auto fe = g_filter_entries.find(lf->second->entry);
+        if (fe != g_filter_entries.end() && fe->second == co)
+            g_filter_entries.erase(fe);
+        g_listbox_filters.erase(lf);
+    }
+    g_filter_entries.erase(co);
+    if (g_fuzzy_pickers.erase(co)) {
+        for (auto it = g_fuzzy_entries.begin(); it != g_fuzzy_entries.end(); )
+            it = (it->second == co) ? g_fuzzy_entries.erase(it) : std::next(it);
+    }
+    g_fuzzy_entries.erase(co);
+    g_file_pickers.erase(co);
+    g_textbox_commands.erase(co);
+    g_progress_panels.erase(co);
+    g_scale_shm.erase(co);
+    g_native_filters.erase(co);
+    g_paste_filters.erase(co);
+    g_entry_validators.erase(co);
+    g_form_timers.erase(co);
+    g_script_hotkeys.erase(co);
+    if (g_textbox_files.erase(co) + g_textboxes.erase(co)) {
+        for (auto it = g_paged_forms.begin(); it != g_paged_forms.end(); )
+            it = (it->second == co) ? g_paged_forms.erase(it) : std::next(it);
+    }
+
     auto it = g_destroy_callbacks.find(co);
     if (it == g_destroy_callbacks.end()) return;
+    if (g_events_queued) {
+        g_events.push(EventQueue::Type::Destroy, co, "");
+        g_destroy_callbacks.erase(it);
+        return;
+    }
     const std::string& s = it->second;
     char* cmd = reinterpret_cast<char*>(xmalloc(s.size() + 1));
     std::memcpy(cmd, s.c_str(), s.size() + 1);
@@ -108,6 +836,16 @@ static void component_destroy_shim(newtComponent co, void* /*data*/) {
     g_destroy_callbacks.erase(it);
 }
 
+// Records a value-holding component in g_forms, hooks its change callback so
+// FormGetChanged sees edits, and arranges for it to be forgotten when libnewt
+// destroys it.  'prev' is the previous radio button.
+static void track_component(newtComponent co, FormRegistry::Kind kind,
+                            newtComponent prev = nullptr) {
+    g_forms.created(co, kind, prev);
+    newtComponentAddCallback(co, component_callback_shim, nullptr);
+    newtComponentAddDestroyCallback(co, component_destroy_shim, nullptr);
+}
+
 // ─── widget constructors ──────────────────────────────────────────────────────
 
 // Entry left top initialValue width [flags]
@@ -128,6 +866,7 @@ static int wrap_Entry(char* v, WORD_LIST* a) {
 
     {
         newtComponent rv = newtEntry(left, top, initialValue, width, nullptr, flags);
+        track_component(rv, FormRegistry::Kind::Entry);
         if (v) {
             std::string s = to_bash_string(rv);
             builtin_bind_variable(v, const_cast<char*>(s.c_str()), 0);
@@ -192,6 +931,7 @@ static int wrap_Checkbox(char* v, WORD_LIST* a) {
         char* result_ptr = storage.get();
         newtComponent rv = newtCheckbox(left, top, text, defValue, seq, result_ptr);
         g_checkbox_results[rv] = std::move(storage);
+        track_component(rv, FormRegistry::Kind::Checkbox);
         if (v) {
             std::string s = to_bash_string(rv);
             builtin_bind_variable(v, const_cast<char*>(s.c_str()), 0);
@@ -205,18 +945,90 @@ usage:
 
 // Radiobutton left top text isDefault prevButton
 static int wrap_Radiobutton(char* v, WORD_LIST* a) {
-    return call_newt("Radiobutton", "left top text isDefault prevButton",
-                     newtRadiobutton, v, a);
+    int left, top, isDefault;
+    const char* text;
+    newtComponent prev;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, left))      goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, top))       goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, text))      goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, isDefault)) goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, prev))      goto usage;
+    {
+        newtComponent rv = newtRadiobutton(left, top, text, isDefault, prev);
+        track_component(rv, FormRegistry::Kind::Radio, prev);
+        if (v) {
+            std::string s = to_bash_string(rv);
+            builtin_bind_variable(v, const_cast<char*>(s.c_str()), 0);
+        }
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt Radiobutton left top text isDefault prevButton\n");
+    return EXECUTION_FAILURE;
 }
 
 // Scale left top width fullValue
 static int wrap_Scale(char* v, WORD_LIST* a) {
-    return call_newt("Scale", "left top width fullValue", newtScale, v, a);
+    int left, top, width;
+    long long fullValue;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, left))      goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, top))       goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, width))     goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, fullValue)) goto usage;
+    {
+        newtComponent rv = newtScale(left, top, width, fullValue);
+        track_component(rv, FormRegistry::Kind::Scale);
+        g_forms.find(rv)->scale_full = static_cast<unsigned long long>(fullValue);
+        if (v) {
+            std::string s = to_bash_string(rv);
+            builtin_bind_variable(v, const_cast<char*>(s.c_str()), 0);
+        }
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt Scale left top width fullValue\n");
+    return EXECUTION_FAILURE;
 }
 
 // Textbox left top width height flags
+// Recorded in g_textboxes, for TextboxRunCommand.
 static int wrap_Textbox(char* v, WORD_LIST* a) {
-    return call_newt("Textbox", "left top width height flags", newtTextbox, v, a);
+    int left, top, width, height, flags;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, left))   goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, top))    goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, width))  goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, height)) goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, flags))  goto usage;
+    {
+        newtComponent rv = newtTextbox(left, top, width, height, flags);
+        g_textboxes[rv] = TextboxInfo();
+        newtComponentAddDestroyCallback(rv, component_destroy_shim, nullptr);
+        if (v) {
+            std::string s = to_bash_string(rv);
+            builtin_bind_variable(v, const_cast<char*>(s.c_str()), 0);
+        }
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt Textbox left top width height flags\n");
+    return EXECUTION_FAILURE;
 }
 
 // ─── entry helpers ────────────────────────────────────────────────────────────
@@ -226,22 +1038,109 @@ static int wrap_EntrySet(char* v, WORD_LIST* a) {
     return call_newt("EntrySet", "co value cursorAtEnd", newtEntrySet, v, a);
 }
 
-// EntrySetFilter co bashFunctionName
-// Registers a bash function as the C-level entry filter shim.
+// EntrySetFilter co bashFunctionName [pasteFunctionName]
+// Registers a bash function as the C-level entry filter shim.  Text pasted
+// in one burst goes to the paste function once, as NEWT_PASTE, instead of
+// to the filter key by key; an empty name (or none) removes it.
 static int wrap_EntrySetFilter(char* /*v*/, WORD_LIST* a) {
     newtComponent co;
     const char* filter_name;
+    const char* paste_name = "";
 
     if (!a->next) goto usage; a = a->next;
     if (!from_string(a->word->word, co)) goto usage;
     if (!a->next) goto usage; a = a->next;
     if (!from_string(a->word->word, filter_name)) goto usage;
+    if (a->next) {
+        a = a->next;
+        if (!from_string(a->word->word, paste_name)) goto usage;
+    }
 
     g_entry_filters[co] = filter_name;
+    if (*paste_name) {
+        g_paste_filters[co] = paste_name;
+        newtComponentAddDestroyCallback(co, component_destroy_shim, nullptr);
+    } else {
+        g_paste_filters.erase(co);
+    }
     newtEntrySetFilter(co, entry_filter_shim, nullptr);
     return EXECUTION_SUCCESS;
 usage:
-    std::fprintf(stderr, "newt: usage: newt EntrySetFilter co bashFunctionName\n");
+    std::fprintf(stderr, "newt: usage: newt EntrySetFilter co bashFunctionName [pasteFunctionName]\n");
+    return EXECUTION_FAILURE;
+}
+
+// EntrySetNativeFilter co spec
+// Filters keystrokes in C++ by a spec such as "digits,max:5" (see
+// newt_entry_filter.hpp).  A bash filter set with EntrySetFilter still runs
+// for the keys the spec accepts.  An empty spec removes the native filter.
+static int wrap_EntrySetNativeFilter(char* /*v*/, WORD_LIST* a) {
+    newtComponent co;
+    const char* spec;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, co))   goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, spec)) goto usage;
+    {
+        if (!*spec) {
+            g_native_filters.erase(co);
+            return EXECUTION_SUCCESS;
+        }
+        newt_entry_filter::NativeFilter f;
+        std::string error;
+        if (!f.parse(spec, error)) {
+            std::fprintf(stderr, "newt: EntrySetNativeFilter: bad spec item '%s'\n", error.c_str());
+            return EXECUTION_FAILURE;
+        }
+        g_native_filters[co] = f;
+        newtEntrySetFilter(co, entry_filter_shim, nullptr);
+        newtComponentAddDestroyCallback(co, component_destroy_shim, nullptr);
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt EntrySetNativeFilter co spec\n");
+    return EXECUTION_FAILURE;
+}
+
+// EntrySetValidator co regex [message]
+// Sets the rule FormValidate checks the entry against: a POSIX extended
+// regex matched as by [[ value =~ regex ]], compiled here once.  An empty
+// regex removes the rule.
+static int wrap_EntrySetValidator(char* /*v*/, WORD_LIST* a) {
+    newtComponent co;
+    const char* regex;
+    const char* message = "";
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, co))      goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, regex))   goto usage;
+    if (a->next) {
+        a = a->next;
+        if (!from_string(a->word->word, message)) goto usage;
+    }
+    {
+        const FormRegistry::Component* c = g_forms.find(co);
+        if (!c || c->kind != FormRegistry::Kind::Entry) {
+            std::fprintf(stderr, "newt: EntrySetValidator: not an entry\n");
+            return EXECUTION_FAILURE;
+        }
+        if (!*regex) {
+            g_entry_validators.erase(co);
+            return EXECUTION_SUCCESS;
+        }
+        EntryValidator rule;
+        std::string error;
+        if (!rule.compile(regex, message, error)) {
+            std::fprintf(stderr, "newt: EntrySetValidator: %s: %s\n", regex, error.c_str());
+            return EXECUTION_FAILURE;
+        }
+        g_entry_validators[co] = std::move(rule);
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt EntrySetValidator co regex [message]\n");
     return EXECUTION_FAILURE;
 }
 
@@ -260,6 +1159,9 @@ static int wrap_FormAddComponents(char* /*v*/, WORD_LIST* a) {
         newtComponent comp;
         if (!from_string(a->word->word, comp)) goto usage;
         newtFormAddComponent(form, comp);
+        g_forms.added(form, comp);
+        auto tb = g_textboxes.find(comp);
+        if (tb != g_textboxes.end()) tb->second.form = form;
     }
     return EXECUTION_SUCCESS;
 usage:
@@ -267,49 +1169,741 @@ usage:
     return EXECUTION_FAILURE;
 }
 
-// ─── wrappers for zero-/one-arg functions ────────────────────────────────────
+// ─── form values ──────────────────────────────────────────────────────────────
+// Components created by the builtin are recorded in g_forms with their kind,
+// so a form's values can be read (and later restored) in one builtin call.
 
-// wrap_Init: call newtInit() and mark the session as active.
-// Both newtInit and newtFinished return int; we bind the result when -v is
-// given but always return EXECUTION_SUCCESS so callers can use
-//   if newt Init; then ... fi
-static int wrap_Init(char* v, WORD_LIST* /*a*/) {
-    int rc = newtInit();
-    newt_init_guard::set_initialized();
-    if (v) {
-        std::string s = to_bash_string(rc);
-        builtin_bind_variable(v, const_cast<char*>(s.c_str()), 0);
+// Makes 'name' an empty indexed array, or prints an error and returns nullptr.
+static SHELL_VAR* make_indexed_array(const char* cmd, const char* name) {
+    SHELL_VAR* var = find_or_make_array_variable(const_cast<char*>(name), 1);
+    if (!var || !array_p(var)) {
+        std::fprintf(stderr, "newt: %s: %s: cannot assign an indexed array\n", cmd, name);
+        return nullptr;
     }
-    return EXECUTION_SUCCESS;
+    array_flush(array_cell(var));
+    return var;
 }
 
-// wrap_Finished: idempotent — safe to call more than once (e.g. from both an
-// explicit call before printing results AND a trap-on-EXIT safety net).
-// Only the first call after a successful Init actually invokes newtFinished();
-// subsequent calls are silent no-ops.
-static int wrap_Finished(char* v, WORD_LIST* /*a*/) {
-    if (newt_init_guard::is_initialized()) {
-        int rc = newtFinished();
-        newt_init_guard::clear_initialized();
-        if (v) {
-            std::string s = to_bash_string(rc);
-            builtin_bind_variable(v, const_cast<char*>(s.c_str()), 0);
-        }
+// Makes 'name' an empty associative array, or prints an error and returns
+// nullptr.
+static SHELL_VAR* make_assoc_array(const char* cmd, const char* name) {
+    SHELL_VAR* var = find_or_make_array_variable(const_cast<char*>(name), 3);
+    if (!var || !assoc_p(var)) {
+        std::fprintf(stderr, "newt: %s: %s: cannot assign an associative array\n", cmd, name);
+        return nullptr;
     }
-    return EXECUTION_SUCCESS;
+    assoc_flush(assoc_cell(var));
+    return var;
 }
-static int wrap_Cls(char* v, WORD_LIST* a)             { return call_newt("Cls",             "",           newtCls,              v, a); }
-static int wrap_WaitForKey(char* v, WORD_LIST* a)      { return call_newt("WaitForKey",      "",           newtWaitForKey,       v, a); }
-static int wrap_ClearKeyBuffer(char* v, WORD_LIST* a)  { return call_newt("ClearKeyBuffer",  "",           newtClearKeyBuffer,   v, a); }
-static int wrap_Refresh(char* v, WORD_LIST* a)         { return call_newt("Refresh",         "",           newtRefresh,          v, a); }
-static int wrap_Suspend(char* v, WORD_LIST* a)         { return call_newt("Suspend",         "",           newtSuspend,          v, a); }
-static int wrap_Resume(char* v, WORD_LIST* a)          { return call_newt("Resume",          "",           newtResume,           v, a); }
-static int wrap_Bell(char* v, WORD_LIST* a)            { return call_newt("Bell",            "",           newtBell,             v, a); }
-static int wrap_CursorOff(char* v, WORD_LIST* a)       { return call_newt("CursorOff",       "",           newtCursorOff,        v, a); }
-static int wrap_CursorOn(char* v, WORD_LIST* a)        { return call_newt("CursorOn",        "",           newtCursorOn,         v, a); }
-static int wrap_PopWindow(char* v, WORD_LIST* a)       { return call_newt("PopWindow",       "",           newtPopWindow,        v, a); }
-static int wrap_PopWindowNoRefresh(char* v, WORD_LIST* a) { return call_newt("PopWindowNoRefresh", "",      newtPopWindowNoRefresh, v, a); }
-static int wrap_RedrawHelpLine(char* v, WORD_LIST* a)  { return call_newt("RedrawHelpLine",  "",           newtRedrawHelpLine,   v, a); }
+
+// Key of a component in FormCollect output: its id, or else its handle.
+static std::string component_key(const void* co, const FormRegistry::Component& c) {
+    return c.id.empty() ? to_bash_string(static_cast<newtComponent>(const_cast<void*>(co)))
+                        : c.id;
+}
+
+// Current value of a registered component as FormCollect reports it.
+static std::string component_value(const void* p, const FormRegistry::Component& c) {
+    newtComponent co = static_cast<newtComponent>(const_cast<void*>(p));
+    switch (c.kind) {
+    case FormRegistry::Kind::Entry:
+        return to_bash_string(newtEntryGetValue(co));
+    case FormRegistry::Kind::Checkbox: {
+        auto it = g_checkbox_results.find(co);
+        return std::string(1, it != g_checkbox_results.end() ? *it->second
+                                                              : newtCheckboxGetValue(co));
+    }
+    case FormRegistry::Kind::Radio: {
+        newtComponent cur = newtRadioGetCurrent(co);
+        const FormRegistry::Component* rc = g_forms.find(cur);
+        return rc ? component_key(cur, *rc) : to_bash_string(cur);
+    }
+    case FormRegistry::Kind::Listbox:
+        return to_bash_string(newtListboxGetCurrent(co));
+    case FormRegistry::Kind::Scale:
+        return to_bash_string(c.scale);
+    case FormRegistry::Kind::CheckboxTree: {
+        int n = 0;
+        const void** sel = newtCheckboxTreeGetSelection(co, &n);
+        std::string keys;
+        for (int i = 0; i < n; ++i) {
+            if (i) keys += ' ';
+            keys += to_bash_string(sel[i]);
+        }
+        std::free(sel);
+        return keys;
+    }
+    }
+    return std::string();
+}
+
+// ComponentSetId co id
+// Names a component for FormCollect; an empty id reverts to the handle.
+static int wrap_ComponentSetId(char* /*v*/, WORD_LIST* a) {
+    newtComponent co;
+    const char* id;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, co)) goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, id)) goto usage;
+    {
+        FormRegistry::Component* c = g_forms.find(co);
+        if (!c) {
+            std::fprintf(stderr, "newt: ComponentSetId: %s: not a value component "
+                                 "created by newt\n", to_bash_string(co).c_str());
+            return EXECUTION_FAILURE;
+        }
+        c->id = id;
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt ComponentSetId co id\n");
+    return EXECUTION_FAILURE;
+}
+
+// FormCollect form assocVar
+// Fills assocVar with one entry per value component added to 'form', keyed by
+// its id (ComponentSetId) or handle.  A radio group is one entry, keyed by its
+// first button, whose value is the key of the selected button.
+static int wrap_FormCollect(char* /*v*/, WORD_LIST* a) {
+    newtComponent form;
+    const char* name;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, form)) goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, name)) goto usage;
+    {
+        SHELL_VAR* out = make_assoc_array("FormCollect", name);
+        if (!out) return EXECUTION_FAILURE;
+        for (const auto& f : g_forms.fields(form)) {
+            std::string key   = component_key(f.co, *f.info);
+            std::string value = component_value(f.co, *f.info);
+            bind_assoc_variable(out, const_cast<char*>(name), savestring(key.c_str()),
+                                const_cast<char*>(value.c_str()), 0);
+        }
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt FormCollect form assocVar\n");
+    return EXECUTION_FAILURE;
+}
+
+// FormGetChanged form arrayVar
+// Fills arrayVar with the keys (as in FormCollect) of the fields whose value
+// changed during the last FormRun/RunForm of 'form'.
+static int wrap_FormGetChanged(char* /*v*/, WORD_LIST* a) {
+    newtComponent form;
+    const char* name;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, form)) goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, name)) goto usage;
+    {
+        SHELL_VAR* out = make_indexed_array("FormGetChanged", name);
+        if (!out) return EXECUTION_FAILURE;
+        arrayind_t i = 0;
+        for (const void* co : g_forms.changed(form)) {
+            std::string key = component_key(co, *g_forms.find(co));
+            bind_array_element(out, i++, const_cast<char*>(key.c_str()), 0);
+        }
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt FormGetChanged form arrayVar\n");
+    return EXECUTION_FAILURE;
+}
+
+// FormValidate form failedVar [messagesVar]
+// Checks every entry of 'form' that has an EntrySetValidator rule.  Fills
+// failedVar with the keys (as in FormCollect) of the entries that fail, in
+// form order, and messagesVar with their messages; the first of them gets
+// the focus.  Returns non-zero if any entry failed; with -v, the variable
+// receives the number of failures.
+static int wrap_FormValidate(char* v, WORD_LIST* a) {
+    newtComponent form;
+    const char* failed_name;
+    const char* messages_name = nullptr;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, form))        goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, failed_name)) goto usage;
+    if (a->next) {
+        a = a->next;
+        if (!from_string(a->word->word, messages_name)) goto usage;
+    }
+    {
+        SHELL_VAR* failed = make_indexed_array("FormValidate", failed_name);
+        if (!failed) return EXECUTION_FAILURE;
+        SHELL_VAR* messages = nullptr;
+        if (messages_name && !(messages = make_indexed_array("FormValidate", messages_name)))
+            return EXECUTION_FAILURE;
+
+        arrayind_t n = 0;
+        for (const void* p : g_forms.members(form)) {
+            newtComponent co = static_cast<newtComponent>(const_cast<void*>(p));
+            auto it = g_entry_validators.find(co);
+            if (it == g_entry_validators.end()) continue;
+            const char* value = newtEntryGetValue(co);
+            if (it->second.check(value ? value : "")) continue;
+            if (n == 0) newtFormSetCurrent(form, co);
+            std::string key = component_key(p, *g_forms.find(p));
+            bind_array_element(failed, n, const_cast<char*>(key.c_str()), 0);
+            if (messages)
+                bind_array_element(messages, n, const_cast<char*>(it->second.message().c_str()), 0);
+            ++n;
+        }
+        if (v) {
+            std::string s = to_bash_string(static_cast<long long>(n));
+            builtin_bind_variable(v, const_cast<char*>(s.c_str()), 0);
+        }
+        return n ? EXECUTION_FAILURE : EXECUTION_SUCCESS;
+    }
+usage:
+    std::fprintf(stderr, "newt: usage: newt FormValidate form failedVar [messagesVar]\n");
+    return EXECUTION_FAILURE;
+}
+
+// ─── file-backed textbox paging ──────────────────────────────────────────────
+// A textbox loaded with TextboxLoadFile only ever holds one page of the file.
+// Paging keys move 'top' and re-render that page; lines are clipped to what a
+// wrapped page could ever display so a single huge line cannot blow up memory.
+
+static void textbox_file_show(newtComponent co, TextboxFileState& st) {
+    const char* data   = st.file.data();
+    std::size_t maxlen = static_cast<std::size_t>(st.width) * st.height;
+    std::string page;
+    for (int i = 0; i < st.height; ++i) {
+        std::size_t s = st.index.line_start(st.top + i);
+        if (s == LineIndex::npos) break;
+        std::size_t e = st.index.line_end(s);
+        if (i) page += '\n';
+        page.append(data + s, std::min(e - s, maxlen));
+    }
+    newtTextboxSetText(co, page.c_str());
+}
+
+// Maps the file again if it was truncated since it was mapped (reading the
+// lost pages would raise SIGBUS).  The index starts over and the page is
+// clamped to the new end.  Called before anything reads the file.
+static void textbox_file_check(newtComponent co, TextboxFileState& st) {
+    if (!st.file.shrunk()) return;
+    st.file.remap();                            // on failure: an empty file
+    st.index.reset(st.file.data(), st.file.size());
+    if (st.index.line_start(st.top) == LineIndex::npos) {
+        std::size_t n = st.index.line_count();
+        std::size_t h = static_cast<std::size_t>(st.height);
+        st.top = n > h ? n - h : 0;
+    }
+    textbox_file_show(co, st);
+}
+
+// Applies a paging key to a file-backed textbox.  Returns false if 'co' is not
+// file-backed or 'key' is not a paging key.
+static bool textbox_file_scroll(newtComponent co, int key) {
+    auto it = g_textbox_files.find(co);
+    if (it == g_textbox_files.end()) return false;
+    TextboxFileState& st = *it->second;
+    textbox_file_check(co, st);
+
+    std::size_t h   = static_cast<std::size_t>(st.height);
+    std::size_t top = st.top;
+    // Last valid top line; only computed when the end is actually reached.
+    auto last_top = [&]() {
+        std::size_t n = st.index.line_count();
+        return n > h ? n - h : 0;
+    };
+
+    switch (key) {
+    case NEWT_KEY_UP:   top = top > 0 ? top - 1 : 0; break;
+    case NEWT_KEY_PGUP: top = top > h ? top - h : 0; break;
+    case NEWT_KEY_HOME: top = 0;                     break;
+    case NEWT_KEY_END:  top = last_top();            break;
+    case NEWT_KEY_DOWN:
+        if (st.index.line_start(top + h) != LineIndex::npos) ++top;
+        break;
+    case NEWT_KEY_PGDN:
+        top += h;
+        if (st.index.line_start(top + h - 1) == LineIndex::npos)
+            top = std::min(top, last_top());
+        break;
+    default:
+        return false;
+    }
+    if (top != st.top) {
+        st.top = top;
+        textbox_file_show(co, st);
+    }
+    return true;
+}
+
+// ─── background loads ─────────────────────────────────────────────────────────
+// AsyncLoad reads and splits the file on a pool thread; the result is put into
+// its widget here, on the main thread, when form_run sees the loader's pipe
+// become readable or when AsyncLoadWait asks for it.
+
+// True if 'co' can take an AsyncLoad: a listbox (plain or virtual) or a
+// textbox.  Anything else would be handed to newtTextboxSetText, which writes
+// through the component's data as if it were a textbox's.
+static bool async_load_target(newtComponent co, bool& lines) {
+    const FormRegistry::Component* c = g_forms.find(co);
+    lines = c && c->kind == FormRegistry::Kind::Listbox;
+    return lines || g_textboxes.count(co);
+}
+
+// Puts a finished load into its widget: the rows of a virtual or plain
+// listbox (data keys are 1-based line numbers), or the text of a textbox.
+// Returns false (message printed) if the load failed.
+static bool async_load_install(newt_async_load::Result& r, const char* cmd) {
+    newtComponent co = static_cast<newtComponent>(const_cast<void*>(r.target));
+    if (r.error) {
+        std::fprintf(stderr, "newt: %s: %s: %s\n", cmd, r.path.c_str(), std::strerror(r.error));
+        return false;
+    }
+    auto vl = g_virtual_listboxes.find(co);
+    if (vl != g_virtual_listboxes.end()) {
+        vl->second->rows = std::move(r.rows);
+        virtual_listbox_refill(co, *vl->second, 0, true);
+        return true;
+    }
+    bool lines;
+    if (!async_load_target(co, lines)) return true;
+    if (lines) {
+        // newtListboxAppendEntry walks the whole list for every row; inserting
+        // at the head (key NULL) from the last row up is linear.
+        newtListboxClear(co);
+        for (std::size_t i = r.rows.size(); i > 0; --i)
+            newtListboxInsertEntry(co, r.rows[i - 1], reinterpret_cast<void*>(i), nullptr);
+        return true;
+    }
+    newtTextboxSetText(co, r.text.c_str());
+    return true;
+}
+
+// Installs the finished loads whose widget was added to 'form'.  The others
+// stay queued for their own form's run (or AsyncLoadWait): installing one
+// redraws its widget, even under a dialog running on top of it.
+static void async_loads_install(newtComponent form) {
+    auto in_form = [form](const void* target) {
+        newtComponent co = static_cast<newtComponent>(const_cast<void*>(target));
+        if (const FormRegistry::Component* c = g_forms.find(co)) return c->form == form;
+        auto tb = g_textboxes.find(co);
+        return tb != g_textboxes.end() && tb->second.form == form;
+    };
+    for (newt_async_load::Result& r : g_async_loader->take(in_form))
+        async_load_install(r, "AsyncLoad");
+}
+
+// Called from form_run when a watched fd is readable.  Returns true if 'fd'
+// is the loader's pipe (finished loads of 'form' are then installed).
+static bool async_loads_ready(newtComponent form, int fd) {
+    if (!g_async_loader || g_async_owner != ::getpid() || fd != g_async_loader->fd())
+        return false;
+    async_loads_install(form);
+    return true;
+}
+
+// ─── textbox commands ─────────────────────────────────────────────────────────
+// The output of a TextboxRunCommand is read here, from form_run whenever its
+// pipe wakes the form, or from TextboxRunCommandWait.  It goes into a bounded
+// scrollback; the textbox is handed one page of it, normally the last, like
+// `tail -f`.
+
+static void textbox_command_show(newtComponent co, const TextboxCommandState& st) {
+    newtTextboxSetText(co, st.tail.lines(st.height, st.back).c_str());
+}
+
+// Reads what the command of 'co' has written and shows it.  A page scrolled
+// back stays on the same lines.  Returns false once the output has ended.
+static bool textbox_command_pump(newtComponent co, TextboxCommandState& st) {
+    std::string chunk;
+    bool open = st.command.read(chunk);
+    if (!chunk.empty()) {
+        std::size_t completed = st.tail.completed();
+        st.tail.append(chunk.data(), chunk.size());
+        if (st.back) st.back += st.tail.completed() - completed;
+        textbox_command_show(co, st);
+    }
+    return open;
+}
+
+// Pages through the scrollback of a command textbox for a paging key (see
+// TextboxSetScrollback); End, or paging down to the bottom, follows the
+// output again.  Returns false for other keys.
+static bool textbox_command_scroll(newtComponent co, int key) {
+    auto it = g_textbox_commands.find(co);
+    if (it == g_textbox_commands.end()) return false;
+    TextboxCommandState& st = *it->second;
+
+    std::size_t n    = st.tail.line_count();
+    std::size_t h    = st.height;
+    std::size_t most = n > h ? n - h : 0;
+    std::size_t back = std::min(st.back, most);
+    switch (key) {
+    case NEWT_KEY_UP:   back = std::min(back + 1, most);  break;
+    case NEWT_KEY_PGUP: back = std::min(back + h, most);  break;
+    case NEWT_KEY_HOME: back = most;                      break;
+    case NEWT_KEY_DOWN: back = back > 0 ? back - 1 : 0;   break;
+    case NEWT_KEY_PGDN: back = back > h ? back - h : 0;   break;
+    case NEWT_KEY_END:  back = 0;                         break;
+    default:
+        return false;
+    }
+    if (back != st.back) {
+        st.back = back;
+        textbox_command_show(co, st);
+    }
+    return true;
+}
+
+// Collects the exit status of a command whose output has ended and binds it
+// to the -v variable given at start.  The scrollback is kept.
+static int textbox_command_finish(newtComponent co) {
+    TextboxCommandState& st = *g_textbox_commands.find(co)->second;
+    int status = st.command.status();
+    if (!st.status_var.empty()) {
+        std::string s = to_bash_string(status);
+        builtin_bind_variable(const_cast<char*>(st.status_var.c_str()),
+                              const_cast<char*>(s.c_str()), 0);
+    }
+    st.running = false;
+    return status;
+}
+
+// Called from form_run when a watched fd is readable.  Returns true if 'fd'
+// is the output of a textbox command (read and shown; when it has ended the
+// form stops watching it and the command is finished).
+static bool textbox_command_ready(newtComponent form, int fd) {
+    for (auto& kv : g_textbox_commands) {
+        if (!kv.second->running || kv.second->command.fd() != fd) continue;
+        if (!textbox_command_pump(kv.first, *kv.second)) {
+            newtFormWatchFd(form, fd, 0);
+            textbox_command_finish(kv.first);
+        }
+        return true;
+    }
+    return false;
+}
+
+// ─── progress panels ──────────────────────────────────────────────────────────
+// Update lines are applied to the model as they are read; the widgets are
+// brought up to date at most once per frame budget.  When a panel fd wakes
+// the form sooner than that, progress_panel_ready keeps reading until the
+// frame is due (or a key is pressed) before letting the form redraw.
+
+// Brings the widgets of the jobs changed since the last frame up to date.
+static void progress_panel_show(ProgressPanelState& p) {
+    for (std::size_t i : p.model.take_dirty()) {
+        const newt_progress::ProgressModel::Job& j = p.model[i];
+        newtScaleSet(p.scales[i], static_cast<unsigned long long>(j.permille));
+        if (!p.messages.empty()) {
+            std::string text = newt_progress::fit_columns(j.message, p.layout.message_width);
+            newtLabelSetText(p.messages[i], text.c_str());
+        }
+    }
+    p.last_frame = std::chrono::steady_clock::now();
+}
+
+// Reads whatever the panel's fds have without blocking.  An fd at end of
+// input is no longer watched.
+static void progress_panel_read(ProgressPanelState& p) {
+    std::vector<struct pollfd> pfds;
+    for (const auto& kv : p.fds) pfds.push_back({ kv.first, POLLIN, 0 });
+    if (::poll(pfds.data(), pfds.size(), 0) <= 0) return;
+
+    char buf[65536];
+    newt_progress::Update u;
+    for (const struct pollfd& pfd : pfds) {
+        if (!pfd.revents) continue;
+        ssize_t n = ::read(pfd.fd, buf, sizeof(buf));
+        if (n < 0 && (errno == EINTR || errno == EAGAIN)) continue;
+        if (n <= 0) {
+            newtFormWatchFd(p.form, pfd.fd, 0);
+            p.fds.erase(pfd.fd);
+            continue;
+        }
+        p.fds[pfd.fd].feed(buf, static_cast<std::size_t>(n), [&](const std::string& line) {
+            if (newt_progress::parse_update(line, u)) p.model.apply(u);
+        });
+    }
+}
+
+// Called from form_run when a watched fd is readable.  Returns true if 'fd'
+// feeds a progress panel.
+static bool progress_panel_ready(int fd) {
+    using clock = std::chrono::steady_clock;
+    for (auto& kv : g_progress_panels) {
+        ProgressPanelState& p = *kv.second;
+        if (!p.fds.count(fd)) continue;
+        clock::time_point due = p.last_frame + std::chrono::milliseconds(p.budget_ms);
+        progress_panel_read(p);
+        for (;;) {
+            clock::time_point now = clock::now();
+            if (now >= due || p.fds.empty() || SLang_input_pending(0) > 0) break;
+            std::vector<struct pollfd> pfds = { { SLang_TT_Read_FD, POLLIN, 0 } };
+            for (const auto& f : p.fds) pfds.push_back({ f.first, POLLIN, 0 });
+            auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(due - now).count() + 1;
+            if (::poll(pfds.data(), pfds.size(), static_cast<int>(ms)) <= 0 || pfds[0].revents)
+                break;
+            progress_panel_read(p);
+        }
+        progress_panel_show(p);
+        return true;
+    }
+    return false;
+}
+
+// ─── terminal output accounting ───────────────────────────────────────────────
+
+// True if the counting pipe is running and its forwarder is in this process.
+static bool output_pipe_owned() {
+    return g_output_pipe->active() && g_output_owner == ::getpid();
+}
+
+static std::uint64_t output_total() {
+    return g_output_carried + (output_pipe_owned() ? g_output_pipe->total() : 0);
+}
+
+// Routes S-Lang's output through the counting pipe if accounting is on and
+// newt is initialised.
+static void output_stats_attach() {
+    if (!g_output_stats || !newt_init_guard::is_initialized() || g_output_pipe->active())
+        return;
+    if (!g_output_pipe->start(SLang_TT_Write_FD)) {
+        std::fprintf(stderr, "newt: OutputStats: %s\n", std::strerror(errno));
+        return;
+    }
+    g_output_owner    = ::getpid();
+    g_output_saved_fd = SLang_TT_Write_FD;
+    SLang_TT_Write_FD = g_output_pipe->fd();
+}
+
+// Points S-Lang back at the terminal once everything queued has reached it.
+static void output_stats_detach() {
+    if (!g_output_pipe->active()) return;
+    SLang_TT_Write_FD = g_output_saved_fd;
+    if (!output_pipe_owned()) return;
+    g_output_carried += g_output_pipe->total();
+    g_output_pipe->stop();
+}
+
+// Brackets one frame (Refresh, DrawForm, a form run) for g_output_frames.
+class OutputFrame {
+public:
+    OutputFrame(const char* label, newtComponent co = nullptr)
+        : counting_(output_pipe_owned()) {
+        if (!counting_) return;
+        std::string l(label);
+        if (co) l += ' ' + to_bash_string(co);
+        g_output_frames.begin(l, output_total());
+    }
+    ~OutputFrame() {
+        if (counting_) g_output_frames.end(output_total());
+    }
+    OutputFrame(const OutputFrame&) = delete;
+    OutputFrame& operator=(const OutputFrame&) = delete;
+
+private:
+    bool counting_;
+};
+
+// ─── shared-memory scales ─────────────────────────────────────────────────────
+
+// Sets a bound scale from its counter file, if the amount has changed.
+static void scale_shm_sample(newtComponent co, const ScaleShmState& st) {
+    FormRegistry::Component* c = g_forms.find(co);
+    if (!c) return;
+    unsigned long long amount = st.counter.sample().amount(c->scale_full);
+    if (amount == c->scale) return;
+    newtScaleSet(co, amount);
+    c->scale = amount;
+}
+
+// Called from form_run when a watched fd is readable.  Returns true if 'fd'
+// is the sample timer of a bound scale.
+static bool scale_shm_ready(int fd) {
+    for (auto& kv : g_scale_shm) {
+        if (kv.second->timer.fd() != fd) continue;
+        kv.second->timer.drain();
+        scale_shm_sample(kv.first, *kv.second);
+        return true;
+    }
+    return false;
+}
+
+// Called from form_run when a watched fd is readable.  Returns true if it
+// belongs to one of the builtin's own widgets and has been dealt with.
+static bool builtin_fd_ready(newtComponent form, int fd) {
+    return fuzzy_picker_ready(fd) || file_picker_ready(fd) || async_loads_ready(form, fd) ||
+           textbox_command_ready(form, fd) || progress_panel_ready(fd) || scale_shm_ready(fd);
+}
+
+// Called from form_run for a hotkey of 'form' that none of the builtin's
+// widgets used.  libnewt offers no way to hand a key to a component, so what
+// it would have done is redone here: a focused listbox moves its cursor, and
+// any other component loses the focus to the previous/next one on Up/Down,
+// as with Shift-Tab/Tab.  A focused textbox or checkbox tree, which would
+// scroll by itself, gets nothing.  Returns false for other keys and for keys
+// the script registered itself, which end the run.
+static bool form_key_fallback(newtComponent form, int key) {
+    auto sk = g_script_hotkeys.find(form);
+    if (sk != g_script_hotkeys.end() && sk->second.count(key)) return false;
+    if (key != NEWT_KEY_UP && key != NEWT_KEY_DOWN &&
+        key != NEWT_KEY_PGUP && key != NEWT_KEY_PGDN)
+        return false;
+
+    newtComponent co = newtFormGetCurrent(form);
+    const FormRegistry::Component* c = g_forms.find(co);
+    if (c && c->kind == FormRegistry::Kind::Listbox) {
+        int n = newtListboxItemCount(co);
+        if (n == 0) return true;
+        void* cur = newtListboxGetCurrent(co);
+        int pos = 0;
+        for (int i = 0; i < n; ++i) {
+            char* text;
+            void* data;
+            newtListboxGetEntry(co, i, &text, &data);
+            if (data == cur) { pos = i; break; }
+        }
+        int page = 0, dummy = 0;
+        newtComponentGetSize(co, &dummy, &page);
+        int step = key == NEWT_KEY_UP   ? -1 : key == NEWT_KEY_DOWN ? 1
+                 : key == NEWT_KEY_PGUP ? -std::max(page, 1) : std::max(page, 1);
+        newtListboxSetCurrent(co, std::clamp(pos + step, 0, n - 1));
+        return true;
+    }
+    if ((c && c->kind == FormRegistry::Kind::CheckboxTree) || g_textboxes.count(co))
+        return true;
+    // The key parser turns ESC [ Z back into Shift-Tab.
+    if (key == NEWT_KEY_UP) {
+        for (unsigned char ch : { 'Z', '[', '\033' }) SLang_ungetkey(ch);
+    } else if (key == NEWT_KEY_DOWN) {
+        SLang_ungetkey('\t');
+    }
+    return true;
+}
+
+// newtFormRun, except that paging hotkeys for a file-backed or command
+// textbox bound to the form, the result-moving hotkeys of a fuzzy picker,
+// results from background fuzzy-picker runs, directory listings for file
+// pickers, finished AsyncLoads, the output of textbox commands, progress
+// panel updates and the timers of shared-memory scales are handled here and
+// the form keeps running.  With 'events', the run also ends (with
+// the event queue's fd as FDREADY) once queued callback events are pending.
+// Records which fields changed for FormGetChanged; the whole run is one
+// OutputStats frame.
+static void form_run(newtComponent form, struct newtExitStruct* es, bool events = false) {
+    OutputFrame frame("FormRun", form);
+    g_forms.run_started(form, component_value);
+    // Loads of this form's widgets that finished since its last run go in
+    // before it is drawn; the loader is watched while any are still running.
+    bool loads = g_async_loader && g_async_owner == ::getpid();
+    if (loads) async_loads_install(form);
+    loads = loads && g_async_loader->pending();
+    if (loads) newtFormWatchFd(form, g_async_loader->fd(), NEWT_FD_READ);
+    // Command pipes are only watched while the form runs, since one may be
+    // closed (finished by TextboxRunCommandWait) before the form runs again,
+    // and only for this form's textboxes: newtTextboxSetText redraws a
+    // textbox even in a covered window.
+    std::vector<int> command_fds;
+    for (auto& kv : g_textbox_commands) {
+        auto tb = g_textboxes.find(kv.first);
+        if (!kv.second->running || tb == g_textboxes.end() || tb->second.form != form)
+            continue;
+        newtFormWatchFd(form, kv.second->command.fd(), NEWT_FD_READ);
+        command_fds.push_back(kv.second->command.fd());
+    }
+    // Scale timers likewise, for the scales of this form only: setting a
+    // scale redraws it even when its window is covered by this form's.  A
+    // scale is brought up to date before the form is first drawn.
+    std::vector<int> scale_fds;
+    for (auto& kv : g_scale_shm) {
+        const FormRegistry::Component* c = g_forms.find(kv.first);
+        if (!c || c->form != form) continue;
+        scale_shm_sample(kv.first, *kv.second);
+        newtFormWatchFd(form, kv.second->timer.fd(), NEWT_FD_READ);
+        scale_fds.push_back(kv.second->timer.fd());
+    }
+    events = events && g_events_queued && g_events.fd() >= 0;
+    if (events) newtFormWatchFd(form, g_events.fd(), NEWT_FD_READ);
+    for (;;) {
+        newtFormRun(form, es);
+        if (es->reason == newtExitStruct::NEWT_EXIT_FDREADY && builtin_fd_ready(form, es->u.watch))
+            continue;
+        if (es->reason != newtExitStruct::NEWT_EXIT_HOTKEY) break;
+        if (fuzzy_picker_hotkey(form, es->u.key)) continue;
+        auto it = g_paged_forms.find(form);
+        if (it != g_paged_forms.end() && (textbox_file_scroll(it->second, es->u.key) ||
+                                          textbox_command_scroll(it->second, es->u.key)))
+            continue;
+        if (!form_key_fallback(form, es->u.key)) break;
+    }
+    for (int fd : command_fds)
+        newtFormWatchFd(form, fd, 0);
+    for (int fd : scale_fds)
+        newtFormWatchFd(form, fd, 0);
+    if (loads) newtFormWatchFd(form, g_async_loader->fd(), 0);
+    if (events) newtFormWatchFd(form, g_events.fd(), 0);
+    g_forms.run_finished(form, newtFormGetCurrent(form), component_value);
+}
+
+// ─── wrappers for zero-/one-arg functions ────────────────────────────────────
+
+// wrap_Init: call newtInit() and mark the session as active.
+// Both newtInit and newtFinished return int; we bind the result when -v is
+// given but always return EXECUTION_SUCCESS so callers can use
+//   if newt Init; then ... fi
+static int wrap_Init(char* v, WORD_LIST* /*a*/) {
+    int rc = newtInit();
+    newt_init_guard::set_initialized();
+    output_stats_attach();
+    if (v) {
+        std::string s = to_bash_string(rc);
+        builtin_bind_variable(v, const_cast<char*>(s.c_str()), 0);
+    }
+    return EXECUTION_SUCCESS;
+}
+
+// wrap_Finished: idempotent — safe to call more than once (e.g. from both an
+// explicit call before printing results AND a trap-on-EXIT safety net).
+// Only the first call after a successful Init actually invokes newtFinished();
+// subsequent calls are silent no-ops.
+static int wrap_Finished(char* v, WORD_LIST* /*a*/) {
+    if (newt_init_guard::is_initialized()) {
+        int rc = newtFinished();
+        newt_init_guard::clear_initialized();
+        output_stats_detach();
+        if (v) {
+            std::string s = to_bash_string(rc);
+            builtin_bind_variable(v, const_cast<char*>(s.c_str()), 0);
+        }
+    }
+    return EXECUTION_SUCCESS;
+}
+static int wrap_Cls(char* v, WORD_LIST* a)             { return call_newt("Cls",             "",           newtCls,              v, a); }
+static int wrap_WaitForKey(char* v, WORD_LIST* a)      { return call_newt("WaitForKey",      "",           newtWaitForKey,       v, a); }
+static int wrap_ClearKeyBuffer(char* v, WORD_LIST* a)  { return call_newt("ClearKeyBuffer",  "",           newtClearKeyBuffer,   v, a); }
+static int wrap_Refresh(char* v, WORD_LIST* a) {
+    OutputFrame frame("Refresh");
+    return call_newt("Refresh", "", newtRefresh, v, a);
+}
+// The terminal is the shell's again afterwards, so the reset sequences must
+// have reached it.
+static int wrap_Suspend(char* v, WORD_LIST* a) {
+    int rc = call_newt("Suspend", "", newtSuspend, v, a);
+    if (output_pipe_owned()) g_output_pipe->drain();
+    return rc;
+}
+static int wrap_Resume(char* v, WORD_LIST* a)          { return call_newt("Resume",          "",           newtResume,           v, a); }
+static int wrap_Bell(char* v, WORD_LIST* a)            { return call_newt("Bell",            "",           newtBell,             v, a); }
+static int wrap_CursorOff(char* v, WORD_LIST* a)       { return call_newt("CursorOff",       "",           newtCursorOff,        v, a); }
+static int wrap_CursorOn(char* v, WORD_LIST* a)        { return call_newt("CursorOn",        "",           newtCursorOn,         v, a); }
+static int wrap_PopWindow(char* v, WORD_LIST* a)       { return call_newt("PopWindow",       "",           newtPopWindow,        v, a); }
+static int wrap_PopWindowNoRefresh(char* v, WORD_LIST* a) { return call_newt("PopWindowNoRefresh", "",      newtPopWindowNoRefresh, v, a); }
+static int wrap_RedrawHelpLine(char* v, WORD_LIST* a)  { return call_newt("RedrawHelpLine",  "",           newtRedrawHelpLine,   v, a); }
 static int wrap_PopHelpLine(char* v, WORD_LIST* a)     { return call_newt("PopHelpLine",     "",           newtPopHelpLine,      v, a); }
 static int wrap_ResizeScreen(char* v, WORD_LIST* a)    { return call_newt("ResizeScreen",    "redraw",     newtResizeScreen,     v, a); }
 static int wrap_Delay(char* v, WORD_LIST* a)           { return call_newt("Delay",           "usecs",      newtDelay,            v, a); }
@@ -354,7 +1948,31 @@ static int wrap_LabelSetColors(char* v, WORD_LIST* a)  { return call_newt("Label
 static int wrap_VerticalScrollbar(char* v, WORD_LIST* a) { return call_newt("VerticalScrollbar", "left top height normalColorset thumbColorset", newtVerticalScrollbar, v, a); }
 static int wrap_ScrollbarSet(char* v, WORD_LIST* a)    { return call_newt("ScrollbarSet",    "co where total", newtScrollbarSet, v, a); }
 static int wrap_ScrollbarSetColors(char* v, WORD_LIST* a) { return call_newt("ScrollbarSetColors", "co normal thumb", newtScrollbarSetColors, v, a); }
-static int wrap_Listbox(char* v, WORD_LIST* a)         { return call_newt("Listbox",         "left top height flags", newtListbox, v, a); }
+// Listbox left top height flags
+static int wrap_Listbox(char* v, WORD_LIST* a) {
+    int left, top, height, flags;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, left))   goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, top))    goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, height)) goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, flags))  goto usage;
+    {
+        newtComponent rv = newtListbox(left, top, height, flags);
+        track_component(rv, FormRegistry::Kind::Listbox);
+        if (v) {
+            std::string s = to_bash_string(rv);
+            builtin_bind_variable(v, const_cast<char*>(s.c_str()), 0);
+        }
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt Listbox left top height flags\n");
+    return EXECUTION_FAILURE;
+}
 static int wrap_ListboxGetCurrent(char* v, WORD_LIST* a){ return call_newt("ListboxGetCurrent", "co",        newtListboxGetCurrent, v, a); }
 static int wrap_ListboxSetCurrent(char* v, WORD_LIST* a){ return call_newt("ListboxSetCurrent", "co num",    newtListboxSetCurrent, v, a); }
 static int wrap_ListboxSetWidth(char* v, WORD_LIST* a) { return call_newt("ListboxSetWidth", "co width",   newtListboxSetWidth,   v, a); }
@@ -483,77 +2101,289 @@ usage:
     return EXECUTION_FAILURE;
 }
 
-// SetSuspendCallback bashFunctionName
-// Registers a bash function as the C-level suspend callback shim.
-static int wrap_SetSuspendCallback(char* /*v*/, WORD_LIST* a) {
-    const char* fn_name;
-    if (!a->next) goto usage; a = a->next;
-    if (!from_string(a->word->word, fn_name)) goto usage;
-
-    g_suspend_callback_fn = fn_name;
-    newtSetSuspendCallback(suspend_callback_shim, nullptr);
-    return EXECUTION_SUCCESS;
-usage:
-    std::fprintf(stderr, "newt: usage: newt SetSuspendCallback bashFunctionName\n");
-    return EXECUTION_FAILURE;
+// Reads a whole file into 'out'.  Returns false (errno set) on failure.
+static bool read_file(const char* path, std::string& out) {
+    FILE* fp = std::fopen(path, "rb");
+    if (!fp) return false;
+    out.clear();
+    char buf[65536];
+    std::size_t n;
+    while ((n = std::fread(buf, 1, sizeof(buf), fp)) > 0)
+        out.append(buf, n);
+    bool ok = !std::ferror(fp);
+    std::fclose(fp);
+    return ok;
 }
 
-// ─── existing wrappers (generated) ───────────────────────────────────────────
+// ─── palettes ─────────────────────────────────────────────────────────────────
+// A palette's strings are parsed once and kept next to the newtColors that
+// points at them, so PaletteApply is one newtSetColors call.
 
-static int wrap_FormWatchFd(char* v, WORD_LIST* a) {
-    return call_newt("FormWatchFd", "form fd fdFlags", newtFormWatchFd, v, a);
+static char* newtColors::* const kColorFields[newt_palette::kFields] = {
+    &newtColors::rootFg,          &newtColors::rootBg,
+    &newtColors::borderFg,        &newtColors::borderBg,
+    &newtColors::windowFg,        &newtColors::windowBg,
+    &newtColors::shadowFg,        &newtColors::shadowBg,
+    &newtColors::titleFg,         &newtColors::titleBg,
+    &newtColors::buttonFg,        &newtColors::buttonBg,
+    &newtColors::actButtonFg,     &newtColors::actButtonBg,
+    &newtColors::checkboxFg,      &newtColors::checkboxBg,
+    &newtColors::actCheckboxFg,   &newtColors::actCheckboxBg,
+    &newtColors::entryFg,         &newtColors::entryBg,
+    &newtColors::labelFg,         &newtColors::labelBg,
+    &newtColors::listboxFg,       &newtColors::listboxBg,
+    &newtColors::actListboxFg,    &newtColors::actListboxBg,
+    &newtColors::textboxFg,       &newtColors::textboxBg,
+    &newtColors::actTextboxFg,    &newtColors::actTextboxBg,
+    &newtColors::helpLineFg,      &newtColors::helpLineBg,
+    &newtColors::rootTextFg,      &newtColors::rootTextBg,
+    &newtColors::emptyScale,      &newtColors::fullScale,
+    &newtColors::disabledEntryFg, &newtColors::disabledEntryBg,
+    &newtColors::compactButtonFg, &newtColors::compactButtonBg,
+    &newtColors::actSelListboxFg, &newtColors::actSelListboxBg,
+    &newtColors::selListboxFg,    &newtColors::selListboxBg,
+};
+
+// Stores 'p' as palette 'name', replacing any previous definition.  Unset
+// fields come from newtDefaultColorPalette.
+static void palette_store(const char* name, newt_palette::Palette&& p) {
+    auto st = std::make_unique<PaletteState>();
+    st->palette = std::move(p);
+    st->colors  = newtDefaultColorPalette;
+    for (int i = 0; i < newt_palette::kFields; ++i)
+        if (!st->palette.fields[i].empty())
+            st->colors.*kColorFields[i] = &st->palette.fields[i][0];
+    g_palettes[name] = std::move(st);
 }
-// FormRun co reasonVar valueVar
-// Calls newtFormRun and reports the exit condition via two shell variables.
-//   reasonVar: HOTKEY | COMPONENT | FDREADY | TIMER | ERROR
-//   valueVar:  key code (HOTKEY), component ptr (COMPONENT), fd index
-//              (FDREADY), or 0 (TIMER / ERROR).
-static int wrap_FormRun(char* /*v*/, WORD_LIST* a) {
-    newtComponent co;
-    const char* reason_var;
-    const char* value_var;
+
+// PaletteDefine name assocArray
+// Keys are colorset names (ROOT, BUTTON, …), values "fg,bg".
+static int wrap_PaletteDefine(char* /*v*/, WORD_LIST* a) {
+    const char* name;
+    const char* array;
 
     if (!a->next) goto usage; a = a->next;
-    if (!from_string(a->word->word, co)) goto usage;
-    if (!a->next) goto usage; a = a->next;
-    if (!from_string(a->word->word, reason_var)) goto usage;
+    if (!from_string(a->word->word, name))  goto usage;
     if (!a->next) goto usage; a = a->next;
-    if (!from_string(a->word->word, value_var)) goto usage;
+    if (!from_string(a->word->word, array)) goto usage;
     {
-        struct newtExitStruct es;
-        newtFormRun(co, &es);
-        const char* reason_str = "ERROR";
-        std::string value_str = "0";
-        switch (es.reason) {
-            case newtExitStruct::NEWT_EXIT_HOTKEY:
-                reason_str = "HOTKEY";
-                value_str = to_bash_string(es.u.key);
-                break;
-            case newtExitStruct::NEWT_EXIT_COMPONENT:
-                reason_str = "COMPONENT";
-                value_str = to_bash_string(es.u.co);
-                break;
-            case newtExitStruct::NEWT_EXIT_FDREADY:
-                reason_str = "FDREADY";
-                value_str = to_bash_string(es.u.watch);
-                break;
-            case newtExitStruct::NEWT_EXIT_TIMER:
-                reason_str = "TIMER";
-                break;
-            case newtExitStruct::NEWT_EXIT_ERROR:
-                reason_str = "ERROR";
-                break;
+        SHELL_VAR* var = find_variable(array);
+        if (!var || !assoc_p(var)) {
+            std::fprintf(stderr, "newt: PaletteDefine: %s: not an associative array\n", array);
+            return EXECUTION_FAILURE;
+        }
+        newt_palette::Palette p;
+        HASH_TABLE* h = assoc_cell(var);
+        for (int i = 0; h && i < h->nbuckets; ++i) {
+            for (BUCKET_CONTENTS* b = hash_items(i, h); b; b = b->next) {
+                const char* value = b->data ? static_cast<const char*>(b->data) : "";
+                if (!newt_palette::set_colorset(p, b->key, value)) {
+                    std::fprintf(stderr, "newt: PaletteDefine: %s=%s: unknown colorset or not fg,bg\n",
+                                 b->key, value);
+                    return EXECUTION_FAILURE;
+                }
+            }
+        }
+        palette_store(name, std::move(p));
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt PaletteDefine name assocArray\n");
+    return EXECUTION_FAILURE;
+}
+
+// PaletteLoad name file
+// Defines palette 'name' from a file in NEWT_COLORS format.
+static int wrap_PaletteLoad(char* /*v*/, WORD_LIST* a) {
+    const char* name;
+    const char* path;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, name)) goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, path)) goto usage;
+    {
+        std::string text, bad;
+        if (!read_file(path, text)) {
+            std::fprintf(stderr, "newt: PaletteLoad: %s: %s\n", path, std::strerror(errno));
+            return EXECUTION_FAILURE;
+        }
+        newt_palette::Palette p;
+        if (!newt_palette::parse_colors(text, p, bad)) {
+            std::fprintf(stderr, "newt: PaletteLoad: %s: bad item '%s'\n", path, bad.c_str());
+            return EXECUTION_FAILURE;
+        }
+        palette_store(name, std::move(p));
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt PaletteLoad name file\n");
+    return EXECUTION_FAILURE;
+}
+
+// PaletteApply name
+static int wrap_PaletteApply(char* /*v*/, WORD_LIST* a) {
+    const char* name;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, name)) goto usage;
+    {
+        auto it = g_palettes.find(name);
+        if (it == g_palettes.end()) {
+            std::fprintf(stderr, "newt: PaletteApply: %s: no such palette\n", name);
+            return EXECUTION_FAILURE;
         }
-        builtin_bind_variable(const_cast<char*>(reason_var),
-                      const_cast<char*>(reason_str), 0);
-        builtin_bind_variable(const_cast<char*>(value_var),
-                      const_cast<char*>(value_str.c_str()), 0);
+        newtSetColors(it->second->colors);
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt PaletteApply name\n");
+    return EXECUTION_FAILURE;
+}
+
+// SetSuspendCallback bashFunctionName
+// Registers a bash function as the C-level suspend callback shim.
+static int wrap_SetSuspendCallback(char* /*v*/, WORD_LIST* a) {
+    const char* fn_name;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, fn_name)) goto usage;
+
+    g_suspend_callback_fn = fn_name;
+    newtSetSuspendCallback(suspend_callback_shim, nullptr);
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt SetSuspendCallback bashFunctionName\n");
+    return EXECUTION_FAILURE;
+}
+
+// ─── existing wrappers (generated) ───────────────────────────────────────────
+
+static int wrap_FormWatchFd(char* v, WORD_LIST* a) {
+    return call_newt("FormWatchFd", "form fd fdFlags", newtFormWatchFd, v, a);
+}
+// Binds the exit condition of a form run to two shell variables (see
+// FormRun).  'timer' is the reason reported for NEWT_EXIT_TIMER; a wake-up
+// by the event queue is reported as CALLBACKS with the number of events.
+static void bind_exit_reason(const struct newtExitStruct& es, const char* timer,
+                             const char* reason_var, const char* value_var) {
+    const char* reason_str = "ERROR";
+    std::string value_str = "0";
+    switch (es.reason) {
+        case newtExitStruct::NEWT_EXIT_HOTKEY:
+            reason_str = "HOTKEY";
+            value_str = to_bash_string(es.u.key);
+            break;
+        case newtExitStruct::NEWT_EXIT_COMPONENT:
+            reason_str = "COMPONENT";
+            value_str = to_bash_string(es.u.co);
+            break;
+        case newtExitStruct::NEWT_EXIT_FDREADY:
+            if (es.u.watch >= 0 && es.u.watch == g_events.fd()) {
+                reason_str = "CALLBACKS";
+                value_str = to_bash_string(static_cast<unsigned long long>(g_events.size()));
+                break;
+            }
+            reason_str = "FDREADY";
+            value_str = to_bash_string(es.u.watch);
+            break;
+        case newtExitStruct::NEWT_EXIT_TIMER:
+            reason_str = timer;
+            break;
+        case newtExitStruct::NEWT_EXIT_ERROR:
+            reason_str = "ERROR";
+            break;
+    }
+    builtin_bind_variable(const_cast<char*>(reason_var),
+                  const_cast<char*>(reason_str), 0);
+    builtin_bind_variable(const_cast<char*>(value_var),
+                  const_cast<char*>(value_str.c_str()), 0);
+}
+
+// Runs 'form' for at most 'timeout' ms (-1: no bound) or until its
+// FormSetTimer timer is due, whichever comes first, then puts the interval
+// back.  Returns the reason for a NEWT_EXIT_TIMER exit: TIMER if the
+// script's interval has elapsed (it then starts over), TIMEOUT otherwise.
+static const char* form_run_timed(newtComponent form, struct newtExitStruct* es,
+                                  long timeout) {
+    using namespace std::chrono;
+    long wait = timeout;
+    auto t = g_form_timers.find(form);
+    if (t != g_form_timers.end()) {
+        long left = t->second.interval -
+            duration_cast<milliseconds>(steady_clock::now() - t->second.last).count();
+        left = std::max(left, 0L);
+        if (wait < 0 || left < wait) wait = left;
+    }
+    if (wait >= 0) newtFormSetTimer(form, static_cast<int>(std::max(wait, 1L)));
+    form_run(form, es, true);
+    t = g_form_timers.find(form);               // callbacks may have changed it
+    if (wait >= 0) newtFormSetTimer(form, t == g_form_timers.end() ? 0 : t->second.interval);
+    if (es->reason != newtExitStruct::NEWT_EXIT_TIMER) return "TIMER";
+    if (t == g_form_timers.end()) return timeout < 0 ? "TIMER" : "TIMEOUT";
+    auto now = steady_clock::now();
+    // libnewt counts in whole milliseconds; allow for its rounding.
+    if (now - t->second.last + milliseconds(2) < milliseconds(t->second.interval))
+        return "TIMEOUT";
+    t->second.last = now;
+    return "TIMER";
+}
+
+// FormRun co reasonVar valueVar
+// Calls newtFormRun and reports the exit condition via two shell variables.
+//   reasonVar: HOTKEY | COMPONENT | FDREADY | TIMER | CALLBACKS | ERROR
+//   valueVar:  key code (HOTKEY), component ptr (COMPONENT), fd index
+//              (FDREADY), queued events (CALLBACKS), or 0 (TIMER / ERROR).
+static int wrap_FormRun(char* /*v*/, WORD_LIST* a) {
+    newtComponent co;
+    const char* reason_var;
+    const char* value_var;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, co)) goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, reason_var)) goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, value_var)) goto usage;
+    {
+        struct newtExitStruct es;
+        const char* timer = form_run_timed(co, &es, -1);
+        bind_exit_reason(es, timer, reason_var, value_var);
     }
     return EXECUTION_SUCCESS;
 usage:
     std::fprintf(stderr, "newt: usage: newt FormRun form reasonVar valueVar\n");
     return EXECUTION_FAILURE;
 }
+
+// FormPoll form timeoutMs reasonVar valueVar
+// Like FormRun, but waits at most timeoutMs for something to happen and
+// reports TIMEOUT if nothing did, so a script can run its own loop around
+// the form.  The form's FormSetTimer timer keeps its schedule across polls:
+// a poll waits at most until it is due and then reports TIMER.
+static int wrap_FormPoll(char* /*v*/, WORD_LIST* a) {
+    newtComponent co;
+    int timeout;
+    const char* reason_var;
+    const char* value_var;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, co))         goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, timeout) || timeout < 0) goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, reason_var)) goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, value_var))  goto usage;
+    {
+        struct newtExitStruct es;
+        const char* timer = form_run_timed(co, &es, timeout);
+        bind_exit_reason(es, timer, reason_var, value_var);
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt FormPoll form timeoutMs reasonVar valueVar\n");
+    return EXECUTION_FAILURE;
+}
 // ComponentAddCallback co bashExpr [data]
 // Registers a bash expression as the component callback.  Before the
 // expression is evaluated, NEWT_COMPONENT is set to the component pointer and
@@ -631,8 +2461,29 @@ usage:
                  "newt: usage: newt ComponentGetSize co widthVar heightVar\n");
     return EXECUTION_FAILURE;
 }
-static int wrap_FormSetTimer(char* v, WORD_LIST* a) {
-    return call_newt("FormSetTimer", "form milliseconds", newtFormSetTimer, v, a);
+// FormSetTimer form milliseconds
+// The interval is remembered so that FormRun and FormPoll keep its schedule.
+// The destroy shim forgets it when the form goes away through
+// ComponentDestroy or with its parent form (FormDestroy does it itself).
+static int wrap_FormSetTimer(char* /*v*/, WORD_LIST* a) {
+    newtComponent form;
+    int ms;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, form)) goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, ms))   goto usage;
+    newtFormSetTimer(form, ms);
+    if (ms) {
+        g_form_timers[form] = FormTimer{ms, std::chrono::steady_clock::now()};
+        newtComponentAddDestroyCallback(form, component_destroy_shim, nullptr);
+    } else {
+        g_form_timers.erase(form);
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt FormSetTimer form milliseconds\n");
+    return EXECUTION_FAILURE;
 }
 static int wrap_FormSetSize(char* v, WORD_LIST* a) {
     return call_newt("FormSetSize", "form", newtFormSetSize, v, a);
@@ -646,8 +2497,23 @@ static int wrap_FormSetBackground(char* v, WORD_LIST* a) {
 static int wrap_FormSetCurrent(char* v, WORD_LIST* a) {
     return call_newt("FormSetCurrent", "form comp", newtFormSetCurrent, v, a);
 }
-static int wrap_FormAddComponent(char* v, WORD_LIST* a) {
-    return call_newt("FormAddComponent", "form comp", newtFormAddComponent, v, a);
+static int wrap_FormAddComponent(char* /*v*/, WORD_LIST* a) {
+    newtComponent form, comp;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, form)) goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, comp)) goto usage;
+    newtFormAddComponent(form, comp);
+    g_forms.added(form, comp);
+    {
+        auto tb = g_textboxes.find(comp);
+        if (tb != g_textboxes.end()) tb->second.form = form;
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt FormAddComponent form comp\n");
+    return EXECUTION_FAILURE;
 }
 static int wrap_FormSetHeight(char* v, WORD_LIST* a) {
     return call_newt("FormSetHeight", "form height", newtFormSetHeight, v, a);
@@ -655,14 +2521,57 @@ static int wrap_FormSetHeight(char* v, WORD_LIST* a) {
 static int wrap_FormSetWidth(char* v, WORD_LIST* a) {
     return call_newt("FormSetWidth", "form width", newtFormSetWidth, v, a);
 }
+// RunForm form
+// Same result as newtRunForm (F12 returns the form, other hotkeys and errors
+// return NULL), but runs through form_run so paging hotkeys stay internal.
 static int wrap_RunForm(char* v, WORD_LIST* a) {
-    return call_newt("RunForm", "form", newtRunForm, v, a);
+    newtComponent form;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, form)) goto usage;
+    if (a->next)
+        std::fprintf(stderr, "newt: warning: RunForm: extra arguments ignored\n");
+    {
+        struct newtExitStruct es;
+        form_run(form, &es);
+        newtComponent rv = nullptr;
+        if (es.reason == newtExitStruct::NEWT_EXIT_COMPONENT)
+            rv = es.u.co;
+        else if (es.reason == newtExitStruct::NEWT_EXIT_HOTKEY && es.u.key == NEWT_KEY_F12)
+            rv = form;
+        if (v) {
+            std::string s = to_bash_string(rv);
+            builtin_bind_variable(v, const_cast<char*>(s.c_str()), 0);
+        }
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt RunForm form\n");
+    return EXECUTION_FAILURE;
 }
 static int wrap_DrawForm(char* v, WORD_LIST* a) {
+    newtComponent form = nullptr;
+    if (a->next) from_string(a->next->word->word, form);
+    OutputFrame frame("DrawForm", form);
     return call_newt("DrawForm", "form", newtDrawForm, v, a);
 }
-static int wrap_FormAddHotKey(char* v, WORD_LIST* a) {
-    return call_newt("FormAddHotKey", "form key", newtFormAddHotKey, v, a);
+// FormAddHotKey form key
+// The key is remembered so that form_run reports it even when it is also one
+// of the builtin's paging hotkeys.
+static int wrap_FormAddHotKey(char* /*v*/, WORD_LIST* a) {
+    newtComponent form;
+    int key;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, form)) goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, key))  goto usage;
+    newtFormAddHotKey(form, key);
+    g_script_hotkeys[form].insert(key);
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt FormAddHotKey form key\n");
+    return EXECUTION_FAILURE;
 }
 static int wrap_FormGetScrollPosition(char* v, WORD_LIST* a) {
     return call_newt("FormGetScrollPosition", "form", newtFormGetScrollPosition, v, a);
@@ -671,8 +2580,21 @@ static int wrap_FormSetScrollPosition(char* v, WORD_LIST* a) {
     return call_newt("FormSetScrollPosition", "form position",
                      newtFormSetScrollPosition, v, a);
 }
-static int wrap_FormDestroy(char* v, WORD_LIST* a) {
-    return call_newt("FormDestroy", "form", newtFormDestroy, v, a);
+// FormDestroy form
+// libnewt does not run a form's own destroy callback, so the form's entries
+// in the builtin's maps are dropped here.
+static int wrap_FormDestroy(char* /*v*/, WORD_LIST* a) {
+    newtComponent form;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, form)) goto usage;
+    newtFormDestroy(form);
+    g_form_timers.erase(form);
+    g_script_hotkeys.erase(form);
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt FormDestroy form\n");
+    return EXECUTION_FAILURE;
 }
 static int wrap_ComponentDestroy(char* v, WORD_LIST* a) {
     return call_newt("ComponentDestroy", "co", newtComponentDestroy, v, a);
@@ -684,16 +2606,83 @@ static int wrap_ComponentTakesFocus(char* v, WORD_LIST* a) {
 static int wrap_GridPlace(char* v, WORD_LIST* a) {
     return call_newt("GridPlace", "grid left top", newtGridPlace, v, a);
 }
+// Drops what g_grid_fields holds for 'grid' (and its subgrids, as
+// newtGridFree frees them with 'recurse').
+static void grid_forget(newtGrid grid, bool recurse) {
+    auto it = g_grid_fields.find(grid);
+    if (it == g_grid_fields.end()) return;
+    GridFields fields = std::move(it->second);
+    g_grid_fields.erase(it);
+    if (!recurse) return;
+    for (const auto& cell : fields)
+        if (cell.second.first == NEWT_GRID_SUBGRID)
+            grid_forget(static_cast<newtGrid>(cell.second.second), true);
+}
 static int wrap_GridFree(char* v, WORD_LIST* a) {
-    return call_newt("GridFree", "grid recurse", newtGridFree, v, a);
+    int rc = call_newt("GridFree", "grid recurse", newtGridFree, v, a);
+    if (rc != EXECUTION_SUCCESS) return rc;
+    newtGrid grid;
+    int recurse;
+    a = a->next; from_string(a->word->word, grid);
+    a = a->next; from_string(a->word->word, recurse);
+    grid_forget(grid, recurse != 0);
+    return rc;
 }
+// GridBasicWindow and GridSimpleWindow stack text, middle and buttons in
+// column 0 of a new grid; the cells are recorded in g_grid_fields.
 static int wrap_GridBasicWindow(char* v, WORD_LIST* a) {
-    return call_newt("GridBasicWindow", "text buttons entryField",
-                     newtGridBasicWindow, v, a);
+    newtComponent text;
+    newtGrid      middle, buttons;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, text))    goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, middle))  goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, buttons)) goto usage;
+    {
+        newtGrid rv = newtGridBasicWindow(text, middle, buttons);
+        g_grid_fields[rv] = GridFields{
+            { { 0, 0 }, { NEWT_GRID_COMPONENT, text } },
+            { { 0, 1 }, { NEWT_GRID_SUBGRID,   middle } },
+            { { 0, 2 }, { NEWT_GRID_SUBGRID,   buttons } },
+        };
+        if (v) {
+            std::string s = to_bash_string(rv);
+            builtin_bind_variable(v, const_cast<char*>(s.c_str()), 0);
+        }
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt GridBasicWindow text middle buttons\n");
+    return EXECUTION_FAILURE;
 }
 static int wrap_GridSimpleWindow(char* v, WORD_LIST* a) {
-    return call_newt("GridSimpleWindow", "text buttons entryField",
-                     newtGridSimpleWindow, v, a);
+    newtComponent text, middle;
+    newtGrid      buttons;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, text))    goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, middle))  goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, buttons)) goto usage;
+    {
+        newtGrid rv = newtGridSimpleWindow(text, middle, buttons);
+        g_grid_fields[rv] = GridFields{
+            { { 0, 0 }, { NEWT_GRID_COMPONENT, text } },
+            { { 0, 1 }, { NEWT_GRID_COMPONENT, middle } },
+            { { 0, 2 }, { NEWT_GRID_SUBGRID,   buttons } },
+        };
+        if (v) {
+            std::string s = to_bash_string(rv);
+            builtin_bind_variable(v, const_cast<char*>(s.c_str()), 0);
+        }
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt GridSimpleWindow text middle buttons\n");
+    return EXECUTION_FAILURE;
 }
 static int wrap_EntryGetValue(char* v, WORD_LIST* a) {
     return call_newt("EntryGetValue", "co", newtEntryGetValue, v, a);
@@ -713,268 +2702,2265 @@ static int wrap_EntrySetCursorPosition(char* v, WORD_LIST* a) {
     return call_newt("EntrySetCursorPosition", "co position",
                      newtEntrySetCursorPosition, v, a);
 }
-static int wrap_ScaleSet(char* v, WORD_LIST* a) {
-    return call_newt("ScaleSet", "co amount", newtScaleSet, v, a);
+// ScaleSet co amount
+// libnewt has no getter for a scale, so the amount is remembered for
+// FormCollect.
+static int wrap_ScaleSet(char* /*v*/, WORD_LIST* a) {
+    newtComponent co;
+    unsigned long long amount;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, co))     goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, amount)) goto usage;
+    newtScaleSet(co, amount);
+    if (FormRegistry::Component* c = g_forms.find(co)) c->scale = amount;
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt ScaleSet co amount\n");
+    return EXECUTION_FAILURE;
 }
 static int wrap_ScaleSetColors(char* v, WORD_LIST* a) {
     return call_newt("ScaleSetColors", "co empty full",
                      newtScaleSetColors, v, a);
 }
 
-// GetScreenSize colsVar rowsVar
-// Calls newtGetScreenSize and binds the results to the named variables.
-static int wrap_GetScreenSize(char* /*v*/, WORD_LIST* a) {
-    const char* cols_var;
-    const char* rows_var;
+// ScaleBindShm co path [intervalMs]
+// Drives the scale from the done/total pair a producer stores in 'path' (see
+// newt_shm_counter.hpp), sampled every intervalMs (default 100) while a form
+// runs.  An empty path unbinds the scale.
+static int wrap_ScaleBindShm(char* /*v*/, WORD_LIST* a) {
+    newtComponent co;
+    const char* path;
+    int interval = 100;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, co))   goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, path)) goto usage;
+    if (a->next) {
+        a = a->next;
+        if (!from_string(a->word->word, interval) || interval <= 0) goto usage;
+    }
+    {
+        const FormRegistry::Component* c = g_forms.find(co);
+        if (!c || c->kind != FormRegistry::Kind::Scale) {
+            std::fprintf(stderr, "newt: ScaleBindShm: not a scale\n");
+            return EXECUTION_FAILURE;
+        }
+        if (!*path) {
+            g_scale_shm.erase(co);
+            return EXECUTION_SUCCESS;
+        }
+        auto st = std::make_unique<ScaleShmState>();
+        if (!st->counter.open(path)) {
+            std::fprintf(stderr, "newt: ScaleBindShm: %s: %s\n", path, std::strerror(errno));
+            return EXECUTION_FAILURE;
+        }
+        if (!st->timer.start(interval)) {
+            std::fprintf(stderr, "newt: ScaleBindShm: timerfd: %s\n", std::strerror(errno));
+            return EXECUTION_FAILURE;
+        }
+        scale_shm_sample(co, *st);
+        g_scale_shm[co] = std::move(st);
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt ScaleBindShm co path [intervalMs]\n");
+    return EXECUTION_FAILURE;
+}
+
+// GetScreenSize colsVar rowsVar
+// Calls newtGetScreenSize and binds the results to the named variables.
+static int wrap_GetScreenSize(char* /*v*/, WORD_LIST* a) {
+    const char* cols_var;
+    const char* rows_var;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, cols_var)) goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, rows_var)) goto usage;
+
+    {
+        int cols = 0, rows = 0;
+        newtGetScreenSize(&cols, &rows);
+        std::string cols_s = to_bash_string(cols);
+        std::string rows_s = to_bash_string(rows);
+        builtin_bind_variable(const_cast<char*>(cols_var), const_cast<char*>(cols_s.c_str()), 0);
+        builtin_bind_variable(const_cast<char*>(rows_var), const_cast<char*>(rows_s.c_str()), 0);
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt GetScreenSize colsVar rowsVar\n");
+    return EXECUTION_FAILURE;
+}
+
+// ScreenDump var [colorsVar]
+// Reads S-Lang's screen buffer — what libnewt has drawn, as the next Refresh
+// shows it — into indexed array 'var', one element per screen row (see
+// newt_screen_dump.hpp).  colorsVar receives each row's colorset runs.
+static int wrap_ScreenDump(char* /*v*/, WORD_LIST* a) {
+    const char* name;
+    const char* colors_name = nullptr;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, name)) goto usage;
+    if (a->next) {
+        a = a->next;
+        if (!from_string(a->word->word, colors_name)) goto usage;
+    }
+    {
+        if (!newt_init_guard::is_initialized()) {
+            std::fprintf(stderr, "newt: ScreenDump: newt Init has not been called\n");
+            return EXECUTION_FAILURE;
+        }
+        SHELL_VAR* text = make_indexed_array("ScreenDump", name);
+        if (!text) return EXECUTION_FAILURE;
+        SHELL_VAR* colors = nullptr;
+        if (colors_name && !(colors = make_indexed_array("ScreenDump", colors_name)))
+            return EXECUTION_FAILURE;
+
+        int cols = 0, rows = 0;
+        newtGetScreenSize(&cols, &rows);
+        int row0 = SLsmg_get_row(), col0 = SLsmg_get_column();
+        std::vector<SLsmg_Char_Type> cells(cols > 0 ? cols : 0);
+        newt_screen_dump::RowBuilder row;
+        for (int r = 0; r < rows; ++r) {
+            SLsmg_gotorc(r, 0);
+            unsigned int n = SLsmg_read_raw(cells.data(), static_cast<unsigned int>(cells.size()));
+            row.clear();
+            for (unsigned int i = 0; i < n; ++i) {
+                const SLsmg_Char_Type& c = cells[i];
+                std::uint32_t chars[SLSMG_MAX_CHARS_PER_CELL];
+                std::size_t nchars = std::min<std::size_t>(c.nchars, SLSMG_MAX_CHARS_PER_CELL);
+                for (std::size_t k = 0; k < nchars; ++k) chars[k] = c.wchars[k];
+                row.cell(chars, nchars, c.color & SLSMG_COLOR_MASK, (c.color & SLSMG_ACS_MASK) != 0);
+            }
+            bind_array_element(text, r, const_cast<char*>(row.text().c_str()), 0);
+            if (colors)
+                bind_array_element(colors, r, const_cast<char*>(row.runs().c_str()), 0);
+        }
+        SLsmg_gotorc(row0, col0);
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt ScreenDump var [colorsVar]\n");
+    return EXECUTION_FAILURE;
+}
+
+// OutputStatsStart
+// Counts the bytes written to the terminal from now on (from the next Init if
+// newt is not initialised), per frame: each Refresh, DrawForm and form run.
+static int wrap_OutputStatsStart(char* /*v*/, WORD_LIST* /*a*/) {
+    g_output_stats = true;
+    g_output_frames.reset(output_total());
+    output_stats_attach();
+    return EXECUTION_SUCCESS;
+}
+
+// OutputStatsStop
+// Stops counting; the figures so far stay readable with OutputStats.
+static int wrap_OutputStatsStop(char* /*v*/, WORD_LIST* /*a*/) {
+    g_output_stats = false;
+    output_stats_detach();
+    return EXECUTION_SUCCESS;
+}
+
+// OutputStatsReset
+static int wrap_OutputStatsReset(char* /*v*/, WORD_LIST* /*a*/) {
+    g_output_frames.reset(output_total());
+    return EXECUTION_SUCCESS;
+}
+
+// OutputStats assocVar
+// Fills assocVar with bytes, idle, frames, last, last_frame, max and
+// max_frame since OutputStatsStart / OutputStatsReset (see the tutorial).
+static int wrap_OutputStats(char* /*v*/, WORD_LIST* a) {
+    const char* name;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, name)) goto usage;
+    {
+        SHELL_VAR* out = make_assoc_array("OutputStats", name);
+        if (!out) return EXECUTION_FAILURE;
+        std::uint64_t total = output_total();
+        const std::pair<const char*, std::string> items[] = {
+            { "bytes",      std::to_string(g_output_frames.bytes(total)) },
+            { "idle",       std::to_string(g_output_frames.idle(total))  },
+            { "frames",     std::to_string(g_output_frames.frames())     },
+            { "last",       std::to_string(g_output_frames.last())       },
+            { "last_frame", g_output_frames.last_label()                 },
+            { "max",        std::to_string(g_output_frames.max())        },
+            { "max_frame",  g_output_frames.max_label()                  },
+        };
+        for (const auto& it : items)
+            bind_assoc_variable(out, const_cast<char*>(name), savestring(it.first),
+                                const_cast<char*>(it.second.c_str()), 0);
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt OutputStats assocVar\n");
+    return EXECUTION_FAILURE;
+}
+
+// ComponentAddDestroyCallback co bashExpression
+// Registers a bash expression to be evaluated when the component is destroyed.
+static int wrap_ComponentAddDestroyCallback(char* /*v*/, WORD_LIST* a) {
+    newtComponent co;
+    const char* expr;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, co)) goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, expr)) goto usage;
+
+    g_destroy_callbacks[co] = expr;
+    newtComponentAddDestroyCallback(co, component_destroy_shim, nullptr);
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt ComponentAddDestroyCallback co bashExpression\n");
+    return EXECUTION_FAILURE;
+}
+
+// ─── Queued callback events ───────────────────────────────────────────────────
+// Instead of evaluating bash code from inside libnewt for every callback,
+// the shims queue events that the script drains in batches.
+
+// EventsSetQueued on
+// 1: component and destroy callbacks are queued for EventsDrain, and
+// FormRun/FormPoll return with reason CALLBACKS when events are pending.
+// 0: callbacks are evaluated as they fire again (queued events stay until
+// drained).
+static int wrap_EventsSetQueued(char* /*v*/, WORD_LIST* a) {
+    int on;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, on)) goto usage;
+    if (on && !g_events.open()) {
+        std::fprintf(stderr, "newt: EventsSetQueued: pipe: %s\n", std::strerror(errno));
+        return EXECUTION_FAILURE;
+    }
+    g_events_queued = on != 0;
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt EventsSetQueued on\n");
+    return EXECUTION_FAILURE;
+}
+
+// EventsDrain arrayName
+// Moves the queued events into arrayName, oldest first, one element each:
+//   CALLBACK co data     a component callback, with its data string
+//   DESTROY co           a destroy callback
+// preceded by "OVERFLOW n" if n events were dropped because the queue was
+// full.  With -v, the variable receives the number of events.
+static int wrap_EventsDrain(char* v, WORD_LIST* a) {
+    const char* name;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, name)) goto usage;
+    {
+        SHELL_VAR* out = make_indexed_array("EventsDrain", name);
+        if (!out) return EXECUTION_FAILURE;
+        std::size_t dropped = g_events.take_dropped();
+        std::vector<EventQueue::Event> events = g_events.take();
+        arrayind_t i = 0;
+        std::string s;
+        if (dropped) {
+            s = "OVERFLOW " + std::to_string(dropped);
+            bind_array_element(out, i++, const_cast<char*>(s.c_str()), 0);
+        }
+        for (const EventQueue::Event& e : events) {
+            newtComponent co = static_cast<newtComponent>(const_cast<void*>(e.co));
+            if (e.type == EventQueue::Type::Callback)
+                s = "CALLBACK " + to_bash_string(co) + " " + e.data;
+            else
+                s = "DESTROY " + to_bash_string(co);
+            bind_array_element(out, i++, const_cast<char*>(s.c_str()), 0);
+        }
+        if (v) {
+            s = to_bash_string(static_cast<unsigned long long>(events.size()));
+            builtin_bind_variable(v, const_cast<char*>(s.c_str()), 0);
+        }
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt EventsDrain arrayName\n");
+    return EXECUTION_FAILURE;
+}
+
+// ─── CheckboxTree ─────────────────────────────────────────────────────────────
+
+// Registers the native state of a new checkbox tree and binds its handle.
+static void checkbox_tree_created(char* v, newtComponent co, const char* seq) {
+    auto st = std::make_unique<CheckboxTreeState>();
+    if (seq && *seq) st->seq = seq;
+    g_checkbox_trees[co] = std::move(st);
+    track_component(co, FormRegistry::Kind::CheckboxTree);
+    if (v) {
+        std::string s = to_bash_string(co);
+        builtin_bind_variable(v, const_cast<char*>(s.c_str()), 0);
+    }
+}
+
+// CheckboxTree left top height flags
+static int wrap_CheckboxTree(char* v, WORD_LIST* a) {
+    int left, top, height, flags;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, left))   goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, top))    goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, height)) goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, flags))  goto usage;
+    checkbox_tree_created(v, newtCheckboxTree(left, top, height, flags), nullptr);
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt CheckboxTree left top height flags\n");
+    return EXECUTION_FAILURE;
+}
+
+// CheckboxTreeMulti left top height seq flags
+static int wrap_CheckboxTreeMulti(char* v, WORD_LIST* a) {
+    int left, top, height, flags;
+    const char* seq;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, left))   goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, top))    goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, height)) goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, seq))    goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, flags))  goto usage;
+    checkbox_tree_created(v, newtCheckboxTreeMulti(left, top, height,
+                                                   const_cast<char*>(seq), flags), seq);
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt CheckboxTreeMulti left top height seq flags\n");
+    return EXECUTION_FAILURE;
+}
+
+static int wrap_CheckboxTreeSetCurrent(char* v, WORD_LIST* a) {
+    return call_newt("CheckboxTreeSetCurrent", "co item",
+                     newtCheckboxTreeSetCurrent, v, a);
+}
+
+static int wrap_CheckboxTreeGetCurrent(char* v, WORD_LIST* a) {
+    return call_newt("CheckboxTreeGetCurrent", "co",
+                     newtCheckboxTreeGetCurrent, v, a);
+}
+
+static int wrap_CheckboxTreeSetEntry(char* v, WORD_LIST* a) {
+    return call_newt("CheckboxTreeSetEntry", "co data text",
+                     newtCheckboxTreeSetEntry, v, a);
+}
+
+static int wrap_CheckboxTreeSetWidth(char* v, WORD_LIST* a) {
+    return call_newt("CheckboxTreeSetWidth", "co width",
+                     newtCheckboxTreeSetWidth, v, a);
+}
+
+static int wrap_CheckboxTreeGetEntryValue(char* v, WORD_LIST* a) {
+    return call_newt("CheckboxTreeGetEntryValue", "co data",
+                     newtCheckboxTreeGetEntryValue, v, a);
+}
+
+static int wrap_CheckboxTreeSetEntryValue(char* v, WORD_LIST* a) {
+    return call_newt("CheckboxTreeSetEntryValue", "co data value",
+                     newtCheckboxTreeSetEntryValue, v, a);
+}
+
+// CheckboxTreeGetSelection co numitemsVar
+// Binds itemsVar[0], itemsVar[1], ... and numitemsVar.
+static int wrap_CheckboxTreeGetSelection(char* /*v*/, WORD_LIST* a) {
+    newtComponent co;
+    const char* varname;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, co)) goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, varname)) goto usage;
+    {
+        int n = 0;
+        const void** sel = newtCheckboxTreeGetSelection(co, &n);
+        for (int i = 0; i < n; ++i) {
+            std::string idx_var = std::string(varname) + "_" + std::to_string(i);
+            std::string val     = to_bash_string(sel[i]);
+            builtin_bind_variable(const_cast<char*>(idx_var.c_str()),
+                                  const_cast<char*>(val.c_str()), 0);
+        }
+        std::string cnt = to_bash_string(n);
+        builtin_bind_variable(const_cast<char*>(varname),
+                              const_cast<char*>(cnt.c_str()), 0);
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt CheckboxTreeGetSelection co numVar\n");
+    return EXECUTION_FAILURE;
+}
+
+// CheckboxTreeGetMultiSelection co numitemsVar seqnum
+static int wrap_CheckboxTreeGetMultiSelection(char* /*v*/, WORD_LIST* a) {
+    newtComponent co;
+    const char* varname;
+    char seqnum;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, co)) goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, varname)) goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, seqnum)) goto usage;
+    {
+        int n = 0;
+        const void** sel = newtCheckboxTreeGetMultiSelection(co, &n, seqnum);
+        for (int i = 0; i < n; ++i) {
+            std::string idx_var = std::string(varname) + "_" + std::to_string(i);
+            std::string val     = to_bash_string(sel[i]);
+            builtin_bind_variable(const_cast<char*>(idx_var.c_str()),
+                                  const_cast<char*>(val.c_str()), 0);
+        }
+        std::string cnt = to_bash_string(n);
+        builtin_bind_variable(const_cast<char*>(varname),
+                              const_cast<char*>(cnt.c_str()), 0);
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr,
+        "newt: usage: newt CheckboxTreeGetMultiSelection co numVar seqnum\n");
+    return EXECUTION_FAILURE;
+}
+
+// Keeps the index of 'co' in step with a node added by CheckboxTreeAddItem.
+// Appends are recorded; any other insert shifts the index paths of existing
+// nodes, so the tree falls back to libnewt lookups from then on.
+static void checkbox_tree_item_added(newtComponent co, const char* text, void* data,
+                                     const std::vector<int>& indexes) {
+    auto it = g_checkbox_trees.find(co);
+    if (it == g_checkbox_trees.end() || !it->second->indexed) return;
+    CheckboxTreeState& st = *it->second;
+
+    auto key = reinterpret_cast<std::uintptr_t>(data);
+    std::size_t n = indexes.size() - 1;   // without NEWT_ARG_LAST
+    std::vector<int> parent_path(indexes.begin(), indexes.begin() + (n ? n - 1 : 0));
+    std::uintptr_t parent = parent_path.empty() ? 0 : st.index.find_indexes(parent_path);
+
+    bool append = n > 0 && indexes[n - 1] == NEWT_ARG_APPEND;
+    if (!append || key == 0 || st.index.find(key) ||
+        (!parent_path.empty() && parent == 0)) {
+        st.indexed = false;
+        return;
+    }
+    st.index.add(parent, text, st.sep, key);
+}
+
+// CheckboxTreeAddItem co text data flags index [index2 ...]
+// Extra integer indices build the variadic list terminated by NEWT_ARG_LAST.
+static int wrap_CheckboxTreeAddItem(char* v, WORD_LIST* a) {
+    newtComponent co;
+    const char* text;
+    void*       data;
+    int         flags;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, co))   goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, text)) goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, data)) goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, flags)) goto usage;
+    {
+        // Collect remaining ints into a vector; append NEWT_ARG_LAST sentinel.
+        std::vector<int> indexes;
+        while (a->next) {
+            a = a->next;
+            int idx;
+            if (!from_string(a->word->word, idx)) goto usage;
+            indexes.push_back(idx);
+        }
+        // Build a null-terminated int array with NEWT_ARG_LAST sentinel.
+        // newtCheckboxTreeAddArray expects a plain int* terminated by
+        // NEWT_ARG_LAST, which is exactly what we build here.
+        indexes.push_back(NEWT_ARG_LAST);
+        int rc = newtCheckboxTreeAddArray(co, text, data, flags, indexes.data());
+        if (rc >= 0) checkbox_tree_item_added(co, text, data, indexes);
+        if (v) {
+            std::string s = to_bash_string(rc);
+            builtin_bind_variable(v, const_cast<char*>(s.c_str()), 0);
+        }
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr,
+        "newt: usage: newt CheckboxTreeAddItem co text data flags index ...\n");
+    return EXECUTION_FAILURE;
+}
+
+// CheckboxTreeFindItem co data — binds varname to space-separated index list
+static int wrap_CheckboxTreeFindItem(char* v, WORD_LIST* a) {
+    newtComponent co;
+    void* data;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, co))   goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, data)) goto usage;
+    {
+        // Trees indexed by the builtin answer without walking libnewt's tree.
+        auto st = g_checkbox_trees.find(co);
+        if (st != g_checkbox_trees.end() && st->second->indexed) {
+            const TreeIndex::Node* node =
+                st->second->index.find(reinterpret_cast<std::uintptr_t>(data));
+            if (node) {
+                std::string result;
+                for (std::size_t i = 0; i < node->indexes.size(); ++i) {
+                    if (i) result += ' ';
+                    result += to_bash_string(node->indexes[i]);
+                }
+                if (v) builtin_bind_variable(v, const_cast<char*>(result.c_str()), 0);
+                return EXECUTION_SUCCESS;
+            }
+        }
+        int* idxs = newtCheckboxTreeFindItem(co, data);
+        std::string result;
+        if (idxs) {
+            for (int i = 0; idxs[i] != NEWT_ARG_LAST; ++i) {
+                if (i) result += ' ';
+                result += to_bash_string(idxs[i]);
+            }
+            // libnewt allocates this with malloc; free it.
+            free(idxs);
+        }
+        if (v)
+            builtin_bind_variable(v, const_cast<char*>(result.c_str()), 0);
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt CheckboxTreeFindItem co data\n");
+    return EXECUTION_FAILURE;
+}
+
+// ─── CheckboxTreeLoad co fd|arrayName [sep] ───────────────────────────────────
+// Builds a whole tree in one builtin call from "a/b/c" paths or an indented
+// outline (see newt_tree_index.hpp).  Data keys 1, 2, 3, … are assigned in
+// creation order; with -v, the named indexed array receives key → path for
+// every node loaded into the tree so far.  libnewt has no bulk insert, so
+// each node is still one newtCheckboxTreeAddArray call, but its index path
+// comes from the TreeIndex hash maps instead of a script-side computation.
+
+// Reads everything from 'fd' into 'out'.  Returns false (errno set) on error.
+static bool read_fd(int fd, std::string& out) {
+    char buf[65536];
+    for (;;) {
+        ssize_t n = ::read(fd, buf, sizeof(buf));
+        if (n == 0) return true;
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        out.append(buf, static_cast<std::size_t>(n));
+    }
+}
+
+static int wrap_CheckboxTreeLoad(char* v, WORD_LIST* a) {
+    newtComponent co;
+    const char* source;
+    const char* sep = "/";
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, co))     goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, source)) goto usage;
+    if (a->next) { a = a->next; if (!from_string(a->word->word, sep)) goto usage; }
+    {
+        std::vector<std::string> lines;
+        int fd;
+        if (source[std::strspn(source, "0123456789")] == '\0' && from_string(source, fd)) {
+            std::string text;
+            if (!read_fd(fd, text)) {
+                std::fprintf(stderr, "newt: CheckboxTreeLoad: fd %d: %s\n", fd, std::strerror(errno));
+                return EXECUTION_FAILURE;
+            }
+            std::size_t pos = 0;
+            while (pos < text.size()) {
+                std::size_t nl = text.find('\n', pos);
+                if (nl == std::string::npos) nl = text.size();
+                lines.emplace_back(text, pos, nl - pos);
+                pos = nl + 1;
+            }
+        } else {
+            SHELL_VAR* var = find_variable(source);
+            if (!var || !array_p(var)) {
+                std::fprintf(stderr, "newt: CheckboxTreeLoad: %s: not an indexed array\n", source);
+                return EXECUTION_FAILURE;
+            }
+            ARRAY* arr = array_cell(var);
+            lines.reserve(static_cast<std::size_t>(array_num_elements(arr)));
+            for (ARRAY_ELEMENT* ae = element_forw(arr->head); ae != arr->head;
+                 ae = element_forw(ae))
+                lines.emplace_back(element_value(ae) ? element_value(ae) : "");
+        }
+
+        auto& st = g_checkbox_trees[co];
+        if (!st) {
+            st = std::make_unique<CheckboxTreeState>();
+            newtComponentAddDestroyCallback(co, component_destroy_shim, nullptr);
+        }
+        if (!st->indexed) {
+            std::fprintf(stderr, "newt: CheckboxTreeLoad: tree has nodes inserted out of order\n");
+            return EXECUTION_FAILURE;
+        }
+        TreeIndex* index = &st->index;
+        st->sep = sep;
+        std::vector<TreeIndex::Added> added;
+        index->load_lines(lines, sep, added);
+
+        std::vector<int> idx;
+        for (const auto& n : added) {
+            idx.assign(n.node->indexes.begin(), n.node->indexes.end() - 1);
+            idx.push_back(NEWT_ARG_APPEND);
+            idx.push_back(NEWT_ARG_LAST);
+            if (newtCheckboxTreeAddArray(co, n.node->text.c_str(),
+                                         reinterpret_cast<void*>(n.key), 0, idx.data()) < 0) {
+                std::fprintf(stderr, "newt: CheckboxTreeLoad: cannot add %s\n",
+                             n.node->path.c_str());
+                st->indexed = false;
+                return EXECUTION_FAILURE;
+            }
+        }
+
+        if (v) {
+            SHELL_VAR* out = make_indexed_array("CheckboxTreeLoad", v);
+            if (!out) return EXECUTION_FAILURE;
+            for (std::uintptr_t key : index->keys())
+                bind_array_element(out, static_cast<arrayind_t>(key),
+                                   const_cast<char*>(index->find(key)->path.c_str()), 0);
+        }
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt CheckboxTreeLoad co fd|arrayName [sep]\n");
+    return EXECUTION_FAILURE;
+}
+
+// Value character of every node of an indexed tree, keyed by data key.  One
+// newtCheckboxTreeGetMultiSelection pass per selected state; nodes not
+// reported are in the unselected state seq[0].
+static std::unordered_map<std::uintptr_t, char>
+checkbox_tree_values(newtComponent co, const CheckboxTreeState& st) {
+    std::unordered_map<std::uintptr_t, char> values;
+    values.reserve(st.index.size());
+    for (std::size_t s = 1; s < st.seq.size(); ++s) {
+        int n = 0;
+        const void** sel = newtCheckboxTreeGetMultiSelection(co, &n, st.seq[s]);
+        for (int i = 0; i < n; ++i)
+            values[reinterpret_cast<std::uintptr_t>(sel[i])] = st.seq[s];
+        std::free(sel);
+    }
+    return values;
+}
+
+// Indexed state of 'co', or nullptr after printing why there is none.
+static CheckboxTreeState* indexed_checkbox_tree(const char* cmd, newtComponent co) {
+    auto it = g_checkbox_trees.find(co);
+    if (it == g_checkbox_trees.end() || !it->second->indexed) {
+        std::fprintf(stderr, "newt: %s: tree was not built with CheckboxTreeLoad "
+                             "or appending CheckboxTreeAddItem\n", cmd);
+        return nullptr;
+    }
+    return it->second.get();
+}
+
+// CheckboxTreeSetEntryValues co assocArray
+// Keys are paths as given to CheckboxTreeLoad or decimal data keys; values
+// are one character of the tree's sequence.  Everything is validated before
+// the tree is touched, and entries already holding their value are skipped.
+static int wrap_CheckboxTreeSetEntryValues(char* /*v*/, WORD_LIST* a) {
+    newtComponent co;
+    const char* name;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, co))   goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, name)) goto usage;
+    {
+        CheckboxTreeState* st = indexed_checkbox_tree("CheckboxTreeSetEntryValues", co);
+        if (!st) return EXECUTION_FAILURE;
+        SHELL_VAR* var = find_variable(name);
+        if (!var || !assoc_p(var)) {
+            std::fprintf(stderr, "newt: CheckboxTreeSetEntryValues: %s: not an associative array\n",
+                         name);
+            return EXECUTION_FAILURE;
+        }
+
+        std::vector<std::pair<std::uintptr_t, char>> wanted;
+        HASH_TABLE* h = assoc_cell(var);
+        for (int i = 0; h && i < h->nbuckets; ++i) {
+            for (BUCKET_CONTENTS* b = hash_items(i, h); b; b = b->next) {
+                const char* value = static_cast<const char*>(b->data);
+                std::uintptr_t key = st->index.find_path(b->key);
+                if (!key) {
+                    void* data;
+                    if (from_string(b->key, data) && st->index.find(reinterpret_cast<std::uintptr_t>(data)))
+                        key = reinterpret_cast<std::uintptr_t>(data);
+                }
+                if (!key) {
+                    std::fprintf(stderr, "newt: CheckboxTreeSetEntryValues: %s: no such item\n", b->key);
+                    return EXECUTION_FAILURE;
+                }
+                if (!value || std::strlen(value) != 1 || st->seq.find(value[0]) == std::string::npos) {
+                    std::fprintf(stderr, "newt: CheckboxTreeSetEntryValues: %s: value must be one of \"%s\"\n",
+                                 b->key, st->seq.c_str());
+                    return EXECUTION_FAILURE;
+                }
+                wanted.emplace_back(key, value[0]);
+            }
+        }
+
+        auto current = checkbox_tree_values(co, *st);
+        for (const auto& w : wanted) {
+            auto it = current.find(w.first);
+            char have = it == current.end() ? st->seq[0] : it->second;
+            if (have != w.second)
+                newtCheckboxTreeSetEntryValue(co, reinterpret_cast<void*>(w.first), w.second);
+        }
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt CheckboxTreeSetEntryValues co assocArray\n");
+    return EXECUTION_FAILURE;
+}
+
+// CheckboxTreeGetEntryValues co assocVar
+// Fills assocVar with data key → value character for every node.
+static int wrap_CheckboxTreeGetEntryValues(char* /*v*/, WORD_LIST* a) {
+    newtComponent co;
+    const char* name;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, co))   goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, name)) goto usage;
+    {
+        CheckboxTreeState* st = indexed_checkbox_tree("CheckboxTreeGetEntryValues", co);
+        if (!st) return EXECUTION_FAILURE;
+        auto values = checkbox_tree_values(co, *st);
+        SHELL_VAR* out = make_assoc_array("CheckboxTreeGetEntryValues", name);
+        if (!out) return EXECUTION_FAILURE;
+        char value[2] = { 0, 0 };
+        for (std::uintptr_t key : st->index.keys()) {
+            auto it = values.find(key);
+            value[0] = it == values.end() ? st->seq[0] : it->second;
+            std::string k = std::to_string(key);
+            bind_assoc_variable(out, const_cast<char*>(name), savestring(k.c_str()), value, 0);
+        }
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt CheckboxTreeGetEntryValues co assocVar\n");
+    return EXECUTION_FAILURE;
+}
+
+// ─── FormSnapshot / FormRestore ───────────────────────────────────────────────
+// The state of every field of a form (see FormCollect) plus its focus and
+// scroll position, as one string; see newt_form_snapshot.hpp for the format.
+
+// Position of 'co' among the registered members of 'form', or -1.
+static int form_member_position(newtComponent form, const void* co) {
+    const auto& m = g_forms.members(form);
+    auto it = std::find(m.begin(), m.end(), co);
+    return it == m.end() ? -1 : static_cast<int>(it - m.begin());
+}
+
+static std::vector<newt_form_snapshot::Record> form_snapshot(newtComponent form) {
+    using newt_form_snapshot::Record;
+    std::vector<Record> out;
+    out.push_back({ 'F', { to_bash_string(form_member_position(form, newtFormGetCurrent(form))),
+                           to_bash_string(newtFormGetScrollPosition(form)) } });
+    for (const auto& f : g_forms.fields(form)) {
+        newtComponent co = static_cast<newtComponent>(const_cast<void*>(f.co));
+        switch (f.info->kind) {
+        case FormRegistry::Kind::Entry:
+            out.push_back({ 'E', { to_bash_string(newtEntryGetValue(co)),
+                                   to_bash_string(newtEntryGetCursorPosition(co)) } });
+            break;
+        case FormRegistry::Kind::Checkbox:
+            out.push_back({ 'C', { component_value(co, *f.info) } });
+            break;
+        case FormRegistry::Kind::Radio:
+            out.push_back({ 'R', { to_bash_string(form_member_position(form, newtRadioGetCurrent(co))) } });
+            break;
+        case FormRegistry::Kind::Listbox: {
+            auto vl = g_virtual_listboxes.find(co);
+            if (vl != g_virtual_listboxes.end()) {
+                out.push_back({ 'L', { to_bash_string(static_cast<unsigned long long>(vl->second->cursor)), "" } });
+                break;
+            }
+            int n = 0;
+            void** sel = newtListboxGetSelection(co, &n);
+            std::string keys;
+            for (int i = 0; i < n; ++i) {
+                if (i) keys += ' ';
+                keys += to_bash_string(sel[i]);
+            }
+            std::free(sel);
+            out.push_back({ 'L', { to_bash_string(newtListboxGetCurrent(co)), keys } });
+            break;
+        }
+        case FormRegistry::Kind::Scale:
+            out.push_back({ 'S', { to_bash_string(f.info->scale) } });
+            break;
+        case FormRegistry::Kind::CheckboxTree: {
+            std::string values;
+            auto st = g_checkbox_trees.find(co);
+            if (st != g_checkbox_trees.end()) {
+                for (const auto& kv : checkbox_tree_values(co, *st->second)) {
+                    if (!values.empty()) values += ' ';
+                    values += std::to_string(kv.first) + '=' + kv.second;
+                }
+            }
+            out.push_back({ 'T', { to_bash_string(newtCheckboxTreeGetCurrent(co)), values } });
+            break;
+        }
+        }
+    }
+    return out;
+}
+
+// Tag and value count FormSnapshot writes for a field of kind 'k'.
+static bool snapshot_record_fits(const newt_form_snapshot::Record& r, FormRegistry::Kind k) {
+    switch (k) {
+    case FormRegistry::Kind::Entry:        return r.tag == 'E' && r.values.size() == 2;
+    case FormRegistry::Kind::Checkbox:     return r.tag == 'C' && r.values.size() == 1 &&
+                                                  r.values[0].size() == 1;
+    case FormRegistry::Kind::Radio:        return r.tag == 'R' && r.values.size() == 1;
+    case FormRegistry::Kind::Listbox:      return r.tag == 'L' && r.values.size() == 2;
+    case FormRegistry::Kind::Scale:        return r.tag == 'S' && r.values.size() == 1;
+    case FormRegistry::Kind::CheckboxTree: return r.tag == 'T' && r.values.size() == 2;
+    }
+    return false;
+}
+
+// Calls 'fn' with each data key in a space-separated list.  Returns false on
+// a word that is not a data key.
+template <class Fn>
+static bool for_each_key(const std::string& list, Fn fn) {
+    std::size_t pos = 0;
+    while (pos < list.size()) {
+        std::size_t end = list.find(' ', pos);
+        if (end == std::string::npos) end = list.size();
+        std::string word = list.substr(pos, end - pos);
+        void* key;
+        if (!word.empty()) {
+            if (!from_string(word.c_str(), key)) return false;
+            fn(key, word);
+        }
+        pos = end + 1;
+    }
+    return true;
+}
+
+// FormSnapshot form var
+static int wrap_FormSnapshot(char* /*v*/, WORD_LIST* a) {
+    newtComponent form;
+    const char* name;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, form)) goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, name)) goto usage;
+    {
+        std::string s = newt_form_snapshot::encode(form_snapshot(form));
+        builtin_bind_variable(const_cast<char*>(name), const_cast<char*>(s.c_str()), 0);
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt FormSnapshot form var\n");
+    return EXECUTION_FAILURE;
+}
+
+// FormRestore form var
+// Applies a FormSnapshot of the same form.  The whole snapshot is checked
+// against the form's fields before anything is changed.
+static int wrap_FormRestore(char* /*v*/, WORD_LIST* a) {
+    newtComponent form;
+    const char* name;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, form)) goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, name)) goto usage;
+    {
+        SHELL_VAR* var = find_variable(name);
+        std::vector<newt_form_snapshot::Record> recs;
+        if (!var || array_p(var) || assoc_p(var) || !value_cell(var) ||
+            !newt_form_snapshot::decode(value_cell(var), recs)) {
+            std::fprintf(stderr, "newt: FormRestore: %s: not a form snapshot\n", name);
+            return EXECUTION_FAILURE;
+        }
+        auto fields = g_forms.fields(form);
+        bool fits = recs.size() == fields.size() + 1 &&
+                    recs[0].tag == 'F' && recs[0].values.size() == 2;
+        for (std::size_t i = 0; fits && i < fields.size(); ++i)
+            fits = snapshot_record_fits(recs[i + 1], fields[i].info->kind);
+        if (!fits) {
+            std::fprintf(stderr, "newt: FormRestore: %s: snapshot does not match the form\n", name);
+            return EXECUTION_FAILURE;
+        }
+
+        const auto& members = g_forms.members(form);
+        for (std::size_t i = 0; i < fields.size(); ++i) {
+            const auto& r = recs[i + 1];
+            newtComponent co = static_cast<newtComponent>(const_cast<void*>(fields[i].co));
+            switch (fields[i].info->kind) {
+            case FormRegistry::Kind::Entry: {
+                int cursor = 0;
+                newtEntrySet(co, r.values[0].c_str(), 0);
+                if (from_string(r.values[1].c_str(), cursor))
+                    newtEntrySetCursorPosition(co, cursor);
+                break;
+            }
+            case FormRegistry::Kind::Checkbox:
+                newtCheckboxSetValue(co, r.values[0][0]);
+                break;
+            case FormRegistry::Kind::Radio: {
+                int pos = -1;
+                if (from_string(r.values[0].c_str(), pos) && pos >= 0 &&
+                    static_cast<std::size_t>(pos) < members.size()) {
+                    const FormRegistry::Component* c = g_forms.find(members[pos]);
+                    if (c && c->kind == FormRegistry::Kind::Radio)
+                        newtRadioSetCurrent(static_cast<newtComponent>(const_cast<void*>(members[pos])));
+                }
+                break;
+            }
+            case FormRegistry::Kind::Listbox: {
+                void* cur;
+                if (!from_string(r.values[0].c_str(), cur)) break;
+                auto vl = g_virtual_listboxes.find(co);
+                if (vl != g_virtual_listboxes.end()) {
+                    auto idx = reinterpret_cast<std::uintptr_t>(cur);
+                    if (idx < vl->second->rows.size())
+                        virtual_listbox_refill(co, *vl->second, idx, false);
+                    break;
+                }
+                newtListboxClearSelection(co);
+                for_each_key(r.values[1], [co](void* key, const std::string&) {
+                    newtListboxSelectItem(co, key, NEWT_FLAGS_SET);
+                });
+                newtListboxSetCurrentByKey(co, cur);
+                break;
+            }
+            case FormRegistry::Kind::Scale: {
+                unsigned long long amount;
+                if (!from_string(r.values[0].c_str(), amount)) break;
+                newtScaleSet(co, amount);
+                if (FormRegistry::Component* c = g_forms.find(co)) c->scale = amount;
+                break;
+            }
+            case FormRegistry::Kind::CheckboxTree: {
+                auto st = g_checkbox_trees.find(co);
+                if (st == g_checkbox_trees.end()) break;
+                const std::string& seq = st->second->seq;
+                auto have = checkbox_tree_values(co, *st->second);
+                std::unordered_map<std::uintptr_t, char> want;
+                for_each_key(r.values[1], [&want](void*, const std::string& word) {
+                    std::size_t eq = word.find('=');
+                    void* key;
+                    if (eq != std::string::npos && eq + 2 == word.size() &&
+                        from_string(word.substr(0, eq).c_str(), key))
+                        want[reinterpret_cast<std::uintptr_t>(key)] = word[eq + 1];
+                });
+                for (const auto& h : have)
+                    if (!want.count(h.first))
+                        newtCheckboxTreeSetEntryValue(co, reinterpret_cast<void*>(h.first), seq[0]);
+                for (const auto& w : want) {
+                    auto h = have.find(w.first);
+                    if (h == have.end() || h->second != w.second)
+                        newtCheckboxTreeSetEntryValue(co, reinterpret_cast<void*>(w.first), w.second);
+                }
+                void* cur;
+                if (from_string(r.values[0].c_str(), cur)) newtCheckboxTreeSetCurrent(co, cur);
+                break;
+            }
+            }
+        }
+
+        int focus = -1, scroll;
+        if (from_string(recs[0].values[0].c_str(), focus) && focus >= 0 &&
+            static_cast<std::size_t>(focus) < members.size())
+            newtFormSetCurrent(form, static_cast<newtComponent>(const_cast<void*>(members[focus])));
+        if (from_string(recs[0].values[1].c_str(), scroll))
+            newtFormSetScrollPosition(form, scroll);
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt FormRestore form var\n");
+    return EXECUTION_FAILURE;
+}
+
+// ─── ListboxGetSelection co numVar ────────────────────────────────────────────
+// Binds numVar_0 … numVar_{n-1} to the void* data keys (as decimal integers)
+// and numVar to the count.
+static int wrap_ListboxGetSelection(char* /*v*/, WORD_LIST* a) {
+    newtComponent co;
+    const char* varname;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, co))     goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, varname)) goto usage;
+    {
+        int n = 0;
+        void** sel = newtListboxGetSelection(co, &n);
+        for (int i = 0; i < n; ++i) {
+            std::string idx_var = std::string(varname) + "_" + std::to_string(i);
+            std::string val     = to_bash_string(sel[i]);
+            builtin_bind_variable(const_cast<char*>(idx_var.c_str()),
+                                  const_cast<char*>(val.c_str()), 0);
+        }
+        if (sel) free(sel);
+        std::string cnt = to_bash_string(n);
+        builtin_bind_variable(const_cast<char*>(varname),
+                              const_cast<char*>(cnt.c_str()), 0);
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt ListboxGetSelection co numVar\n");
+    return EXECUTION_FAILURE;
+}
+
+// ─── ListboxSort co [text|textNumeric|data] [asc|desc] ────────────────────────
+// Sorts the rows in C++ (stable; parallel for large listboxes) and rebuilds the
+// listbox in one pass.  Selected rows stay selected and the current row stays
+// current.  Listboxes whose rows are managed natively (VirtualListbox,
+// ListboxFilterBind, FuzzyPicker) are refused.
+static int wrap_ListboxSort(char* /*v*/, WORD_LIST* a) {
+    namespace ls = newt_listbox_sort;
+    newtComponent co;
+    ls::Key key = ls::Key::Text;
+    bool descending = false;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, co)) goto usage;
+    if (a->next) {
+        a = a->next;
+        const char* k = a->word->word;
+        if      (std::strcmp(k, "text") == 0)        key = ls::Key::Text;
+        else if (std::strcmp(k, "textNumeric") == 0) key = ls::Key::TextNumeric;
+        else if (std::strcmp(k, "data") == 0)        key = ls::Key::Data;
+        else goto usage;
+    }
+    if (a->next) {
+        a = a->next;
+        const char* d = a->word->word;
+        if      (std::strcmp(d, "asc") == 0)  descending = false;
+        else if (std::strcmp(d, "desc") == 0) descending = true;
+        else goto usage;
+    }
+    {
+        if (g_virtual_listboxes.count(co) || g_listbox_filters.count(co) ||
+            g_fuzzy_pickers.count(co)) {
+            std::fprintf(stderr, "newt: ListboxSort: listbox rows are managed natively\n");
+            return EXECUTION_FAILURE;
+        }
+        int n = newtListboxItemCount(co);
+        if (n < 2) return EXECUTION_SUCCESS;
+
+        // Copy the rows out: ListboxClear frees libnewt's strings.
+        RowStore           rows;
+        std::vector<void*> data(static_cast<std::size_t>(n));
+        for (int i = 0; i < n; ++i) {
+            char* text = nullptr;
+            newtListboxGetEntry(co, i, &text, &data[i]);
+            rows.push_back(text ? text : "");
+        }
+        std::vector<const char*> texts(static_cast<std::size_t>(n));
+        for (int i = 0; i < n; ++i) texts[i] = rows[i];
+
+        int nsel = 0;
+        void** sel = newtListboxGetSelection(co, &nsel);
+        std::vector<void*> selected(sel, sel + nsel);
+        if (sel) free(sel);
+        void* cur = newtListboxGetCurrent(co);
+
+        std::vector<std::uint32_t> order =
+            ls::sorted_order(texts, data, key, descending, shared_thread_pool());
+
+        newtListboxClear(co);
+        for (std::uint32_t i : order) newtListboxAppendEntry(co, texts[i], data[i]);
+        for (void* k : selected) newtListboxSelectItem(co, k, NEWT_FLAGS_SET);
+        newtListboxSetCurrentByKey(co, cur);
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt ListboxSort co [text|textNumeric|data] [asc|desc]\n");
+    return EXECUTION_FAILURE;
+}
+
+// ─── VirtualListbox ───────────────────────────────────────────────────────────
+// A listbox whose rows live in a RowStore inside the builtin.  Only a window
+// of a few pages is copied into the real libnewt listbox; the window slides
+// as the cursor approaches its edges (see virtual_listbox_cursor_moved), so
+// first paint costs the same for ten rows or ten million.
+
+// Returns the virtual listbox state for 'co', or prints an error and returns
+// nullptr if 'co' was not created by VirtualListbox.
+static VirtualListboxState* find_virtual_listbox(newtComponent co, const char* cmd) {
+    auto it = g_virtual_listboxes.find(co);
+    if (it == g_virtual_listboxes.end()) {
+        std::fprintf(stderr, "newt: %s: not a virtual listbox\n", cmd);
+        return nullptr;
+    }
+    return it->second.get();
+}
+
+// VirtualListbox left top height flags
+static int wrap_VirtualListbox(char* v, WORD_LIST* a) {
+    int left, top, height, flags;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, left))   goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, top))    goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, height)) goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, flags))  goto usage;
+    {
+        newtComponent co = newtListbox(left, top, height, flags);
+        auto st = std::make_unique<VirtualListboxState>();
+        st->height = height;
+        g_virtual_listboxes[co] = std::move(st);
+        newtComponentAddCallback(co, component_callback_shim, nullptr);
+        track_component(co, FormRegistry::Kind::Listbox);
+        if (v) {
+            std::string s = to_bash_string(co);
+            builtin_bind_variable(v, const_cast<char*>(s.c_str()), 0);
+        }
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt VirtualListbox left top height flags\n");
+    return EXECUTION_FAILURE;
+}
+
+// VirtualListboxSetRows co arrayName
+// Copies every element of the indexed array into the listbox's row store.
+static int wrap_VirtualListboxSetRows(char* /*v*/, WORD_LIST* a) {
+    newtComponent co;
+    const char* array_name;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, co))         goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, array_name)) goto usage;
+    {
+        VirtualListboxState* st = find_virtual_listbox(co, "VirtualListboxSetRows");
+        if (!st) return EXECUTION_FAILURE;
+
+        SHELL_VAR* var = find_variable(array_name);
+        if (!var || !array_p(var)) {
+            std::fprintf(stderr, "newt: VirtualListboxSetRows: %s: not an indexed array\n",
+                         array_name);
+            return EXECUTION_FAILURE;
+        }
+        ARRAY* arr = array_cell(var);
+        st->rows.clear();
+        st->rows.reserve(static_cast<std::size_t>(array_num_elements(arr)), 0);
+        for (ARRAY_ELEMENT* ae = element_forw(arr->head); ae != arr->head;
+             ae = element_forw(ae))
+            st->rows.push_back(element_value(ae));
+        virtual_listbox_refill(co, *st, 0, true);
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt VirtualListboxSetRows co arrayName\n");
+    return EXECUTION_FAILURE;
+}
+
+// VirtualListboxLoadFile co path
+// Loads one row per line of 'path' without passing the text through bash.
+static int wrap_VirtualListboxLoadFile(char* /*v*/, WORD_LIST* a) {
+    newtComponent co;
+    const char* path;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, co))   goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, path)) goto usage;
+    {
+        VirtualListboxState* st = find_virtual_listbox(co, "VirtualListboxLoadFile");
+        if (!st) return EXECUTION_FAILURE;
+
+        std::string text;
+        if (!read_file(path, text)) {
+            std::fprintf(stderr, "newt: VirtualListboxLoadFile: %s: %s\n",
+                         path, std::strerror(errno));
+            return EXECUTION_FAILURE;
+        }
+        st->rows.assign_lines(std::move(text));
+        virtual_listbox_refill(co, *st, 0, true);
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt VirtualListboxLoadFile co path\n");
+    return EXECUTION_FAILURE;
+}
+
+// VirtualListboxGetCurrent co  → global row index, or -1 when empty
+static int wrap_VirtualListboxGetCurrent(char* v, WORD_LIST* a) {
+    newtComponent co;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, co)) goto usage;
+    {
+        VirtualListboxState* st = find_virtual_listbox(co, "VirtualListboxGetCurrent");
+        if (!st) return EXECUTION_FAILURE;
+        long long cur = st->rows.empty() ? -1 : static_cast<long long>(st->cursor);
+        if (v) {
+            std::string s = to_bash_string(cur);
+            builtin_bind_variable(v, const_cast<char*>(s.c_str()), 0);
+        }
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt VirtualListboxGetCurrent co\n");
+    return EXECUTION_FAILURE;
+}
+
+// VirtualListboxSetCurrent co index   (negative index counts from the end)
+static int wrap_VirtualListboxSetCurrent(char* /*v*/, WORD_LIST* a) {
+    newtComponent co;
+    long long index;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, co))    goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, index)) goto usage;
+    {
+        VirtualListboxState* st = find_virtual_listbox(co, "VirtualListboxSetCurrent");
+        if (!st) return EXECUTION_FAILURE;
+        long long total = static_cast<long long>(st->rows.size());
+        if (total == 0) return EXECUTION_SUCCESS;
+        if (index < 0) index += total;
+        index = std::max(0LL, std::min(index, total - 1));
+
+        std::size_t cur = static_cast<std::size_t>(index);
+        const auto& w   = st->window;
+        if (cur >= w.base && cur < w.base + w.count &&
+            !newt_virtual_listbox::needs_refill(w, cur, st->rows.size(),
+                                                newt_virtual_listbox::edge_margin(st->height))) {
+            st->refilling = true;
+            newtListboxSetCurrent(co, static_cast<int>(cur - w.base));
+            st->refilling = false;
+            st->cursor = cur;
+        } else {
+            virtual_listbox_refill(co, *st, cur, cur < st->cursor);
+        }
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt VirtualListboxSetCurrent co index\n");
+    return EXECUTION_FAILURE;
+}
+
+// VirtualListboxGetRow co index  → text of global row 'index'
+static int wrap_VirtualListboxGetRow(char* v, WORD_LIST* a) {
+    newtComponent co;
+    long long index;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, co))    goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, index)) goto usage;
+    {
+        VirtualListboxState* st = find_virtual_listbox(co, "VirtualListboxGetRow");
+        if (!st) return EXECUTION_FAILURE;
+        if (index < 0 || index >= static_cast<long long>(st->rows.size())) {
+            std::fprintf(stderr, "newt: VirtualListboxGetRow: %lld: index out of range\n",
+                         index);
+            return EXECUTION_FAILURE;
+        }
+        if (v)
+            builtin_bind_variable(v, const_cast<char*>(st->rows[index]), 0);
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt VirtualListboxGetRow co index\n");
+    return EXECUTION_FAILURE;
+}
+
+// VirtualListboxItemCount co  → total number of rows (not just the window)
+static int wrap_VirtualListboxItemCount(char* v, WORD_LIST* a) {
+    newtComponent co;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, co)) goto usage;
+    {
+        VirtualListboxState* st = find_virtual_listbox(co, "VirtualListboxItemCount");
+        if (!st) return EXECUTION_FAILURE;
+        if (v) {
+            std::string s = to_bash_string(static_cast<long long>(st->rows.size()));
+            builtin_bind_variable(v, const_cast<char*>(s.c_str()), 0);
+        }
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt VirtualListboxItemCount co\n");
+    return EXECUTION_FAILURE;
+}
+
+// ─── ListboxFilterBind ────────────────────────────────────────────────────────
+// Type-to-filter: the rows of a listbox are copied into the builtin and every
+// keystroke in the bound entry narrows the listbox to the rows containing the
+// entry text (see listbox_filter_apply) without running any bash code.
+
+// ListboxFilterBind listbox entry [foldCase]
+// Snapshots the listbox's current rows; foldCase (default 1) ignores ASCII case.
+static int wrap_ListboxFilterBind(char* /*v*/, WORD_LIST* a) {
+    newtComponent co, entry;
+    int fold = 1;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, co))    goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, entry)) goto usage;
+    if (a->next) { a = a->next; if (!from_string(a->word->word, fold)) goto usage; }
+    {
+        if (g_virtual_listboxes.count(co)) {
+            std::fprintf(stderr, "newt: ListboxFilterBind: virtual listboxes cannot be filtered\n");
+            return EXECUTION_FAILURE;
+        }
+        // Rebinding starts again from the full, unfiltered row set.
+        auto old = g_listbox_filters.find(co);
+        if (old != g_listbox_filters.end()) {
+            listbox_filter_restore(co, *old->second);
+            auto fe = g_filter_entries.find(old->second->entry);
+            if (fe != g_filter_entries.end() && fe->second == co)
+                g_filter_entries.erase(fe);
+            g_listbox_filters.erase(old);
+        }
+
+        auto st = std::make_unique<ListboxFilterState>();
+        st->entry = entry;
+        st->fold  = fold != 0;
+        int n = newtListboxItemCount(co);
+        st->keys.reserve(static_cast<std::size_t>(n));
+        st->shown.reserve(static_cast<std::size_t>(n));
+        for (int i = 0; i < n; ++i) {
+            char* text = nullptr;
+            void* data = nullptr;
+            newtListboxGetEntry(co, i, &text, &data);
+            st->rows.push_back(text ? text : "");
+            st->keys.push_back(data);
+            st->shown.push_back(static_cast<std::uint32_t>(i));
+        }
+        std::vector<void*> sorted(st->keys);
+        std::sort(sorted.begin(), sorted.end());
+        st->unique_keys = std::adjacent_find(sorted.begin(), sorted.end()) == sorted.end();
+
+        const char* value = newtEntryGetValue(entry);
+        listbox_filter_apply(co, *st, value ? value : "");
+
+        g_filter_entries[entry] = co;
+        g_listbox_filters[co] = std::move(st);
+        newtEntrySetFilter(entry, entry_filter_shim, nullptr);
+        newtComponentAddDestroyCallback(co, component_destroy_shim, nullptr);
+        newtComponentAddDestroyCallback(entry, component_destroy_shim, nullptr);
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt ListboxFilterBind listbox entry [foldCase]\n");
+    return EXECUTION_FAILURE;
+}
+
+// ListboxFilterUnbind listbox  — restores every row and drops the binding
+static int wrap_ListboxFilterUnbind(char* /*v*/, WORD_LIST* a) {
+    newtComponent co;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, co)) goto usage;
+    {
+        auto it = g_listbox_filters.find(co);
+        if (it == g_listbox_filters.end()) {
+            std::fprintf(stderr, "newt: ListboxFilterUnbind: listbox is not filtered\n");
+            return EXECUTION_FAILURE;
+        }
+        listbox_filter_restore(co, *it->second);
+        auto fe = g_filter_entries.find(it->second->entry);
+        if (fe != g_filter_entries.end() && fe->second == co)
+            g_filter_entries.erase(fe);
+        g_listbox_filters.erase(it);
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt ListboxFilterUnbind listbox\n");
+    return EXECUTION_FAILURE;
+}
+
+// ─── FuzzyPicker ──────────────────────────────────────────────────────────────
+// An entry over a listbox (plus an optional preview textbox on the right) for
+// picking one of a large set of candidates by fuzzy search.  Scoring happens
+// in C++ on every keystroke; large candidate sets are scored on the shared
+// thread pool and the results shown when the form next wakes up, so typing is
+// never blocked.  The picker is addressed by its listbox handle, and Enter in
+// the entry or listbox exits the form.
+
+static FuzzyPickerState* find_fuzzy_picker(newtComponent co, const char* cmd) {
+    auto it = g_fuzzy_pickers.find(co);
+    if (it == g_fuzzy_pickers.end()) {
+        std::fprintf(stderr, "newt: %s: not a fuzzy picker\n", cmd);
+        return nullptr;
+    }
+    return it->second.get();
+}
+
+// FuzzyPicker form left top width height [previewWidth]
+// Creates the components, adds them to 'form' and returns the listbox.
+static int wrap_FuzzyPicker(char* v, WORD_LIST* a) {
+    newtComponent form;
+    int left, top, width, height, preview_width = 0;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, form))   goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, left))   goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, top))    goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, width))  goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, height)) goto usage;
+    if (a->next) { a = a->next; if (!from_string(a->word->word, preview_width)) goto usage; }
+    {
+        int list_width = preview_width > 0 ? width - preview_width - 1 : width;
+        if (height < 2 || list_width < 1) {
+            std::fprintf(stderr, "newt: FuzzyPicker: %dx%d is too small\n", width, height);
+            return EXECUTION_FAILURE;
+        }
+
+        auto st = std::make_unique<FuzzyPickerState>();
+        if (::pipe2(st->notify, O_CLOEXEC | O_NONBLOCK) < 0) {
+            std::fprintf(stderr, "newt: FuzzyPicker: pipe: %s\n", std::strerror(errno));
+            return EXECUTION_FAILURE;
+        }
+        st->matcher = std::make_unique<newt_fuzzy::FuzzyMatcher>(st->rows, kFuzzyTopK);
+        st->form    = form;
+        st->entry   = newtEntry(left, top, "", width, nullptr,
+                                NEWT_FLAG_SCROLL | NEWT_FLAG_RETURNEXIT);
+        st->listbox = newtListbox(left, top + 1, height - 1, NEWT_FLAG_RETURNEXIT);
+        newtListboxSetWidth(st->listbox, list_width);
+        newtFormAddComponent(form, st->entry);
+        newtFormAddComponent(form, st->listbox);
+        if (preview_width > 0) {
+            st->preview = newtTextbox(left + list_width + 1, top + 1, preview_width,
+                                      height - 1, NEWT_FLAG_WRAP);
+            newtFormAddComponent(form, st->preview);
+        }
+        newtFormWatchFd(form, st->notify[0], NEWT_FD_READ);
+        for (int key : { NEWT_KEY_UP, NEWT_KEY_DOWN, NEWT_KEY_PGUP, NEWT_KEY_PGDN })
+            newtFormAddHotKey(form, key);
+
+        newtComponent co = st->listbox;
+        newtEntrySetFilter(st->entry, entry_filter_shim, nullptr);
+        newtComponentAddCallback(co, component_callback_shim, nullptr);
+        track_component(co, FormRegistry::Kind::Listbox);
+        g_forms.added(form, co);
+        newtComponentAddDestroyCallback(st->entry, component_destroy_shim, nullptr);
+        g_fuzzy_entries[st->entry] = co;
+        g_fuzzy_pickers[co] = std::move(st);
+        if (v) {
+            std::string s = to_bash_string(co);
+            builtin_bind_variable(v, const_cast<char*>(s.c_str()), 0);
+        }
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt FuzzyPicker form left top width height [previewWidth]\n");
+    return EXECUTION_FAILURE;
+}
+
+// FuzzyPickerSetRows fp arrayName
+static int wrap_FuzzyPickerSetRows(char* /*v*/, WORD_LIST* a) {
+    newtComponent co;
+    const char* array_name;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, co))         goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, array_name)) goto usage;
+    {
+        FuzzyPickerState* st = find_fuzzy_picker(co, "FuzzyPickerSetRows");
+        if (!st) return EXECUTION_FAILURE;
+
+        SHELL_VAR* var = find_variable(array_name);
+        if (!var || !array_p(var)) {
+            std::fprintf(stderr, "newt: FuzzyPickerSetRows: %s: not an indexed array\n",
+                         array_name);
+            return EXECUTION_FAILURE;
+        }
+        // Workers read the row store; let them finish before replacing it.
+        st->matcher->cancel();
+        st->matcher->wait();
+        ARRAY* arr = array_cell(var);
+        st->rows.clear();
+        st->rows.reserve(static_cast<std::size_t>(array_num_elements(arr)), 0);
+        for (ARRAY_ELEMENT* ae = element_forw(arr->head); ae != arr->head;
+             ae = element_forw(ae))
+            st->rows.push_back(element_value(ae) ? element_value(ae) : "");
+        fuzzy_picker_query(*st, st->query, true);
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt FuzzyPickerSetRows fp arrayName\n");
+    return EXECUTION_FAILURE;
+}
+
+// FuzzyPickerLoadFile fp path  — one candidate per line
+static int wrap_FuzzyPickerLoadFile(char* /*v*/, WORD_LIST* a) {
+    newtComponent co;
+    const char* path;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, co))   goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, path)) goto usage;
+    {
+        FuzzyPickerState* st = find_fuzzy_picker(co, "FuzzyPickerLoadFile");
+        if (!st) return EXECUTION_FAILURE;
+        std::string text;
+        if (!read_file(path, text)) {
+            std::fprintf(stderr, "newt: FuzzyPickerLoadFile: %s: %s\n",
+                         path, std::strerror(errno));
+            return EXECUTION_FAILURE;
+        }
+        st->matcher->cancel();
+        st->matcher->wait();
+        st->rows.assign_lines(std::move(text));
+        fuzzy_picker_query(*st, st->query, true);
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt FuzzyPickerLoadFile fp path\n");
+    return EXECUTION_FAILURE;
+}
+
+// FuzzyPickerGetCurrent fp  → candidate index of the current row, -1 if none
+static int wrap_FuzzyPickerGetCurrent(char* v, WORD_LIST* a) {
+    newtComponent co;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, co)) goto usage;
+    {
+        FuzzyPickerState* st = find_fuzzy_picker(co, "FuzzyPickerGetCurrent");
+        if (!st) return EXECUTION_FAILURE;
+        long long idx = -1;
+        if (newtListboxItemCount(co) > 0)
+            idx = static_cast<long long>(reinterpret_cast<uintptr_t>(newtListboxGetCurrent(co)));
+        if (v) {
+            std::string s = to_bash_string(idx);
+            builtin_bind_variable(v, const_cast<char*>(s.c_str()), 0);
+        }
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt FuzzyPickerGetCurrent fp\n");
+    return EXECUTION_FAILURE;
+}
+
+// FuzzyPickerGetRow fp index  → text of candidate 'index'
+static int wrap_FuzzyPickerGetRow(char* v, WORD_LIST* a) {
+    newtComponent co;
+    long long index;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, co))    goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, index)) goto usage;
+    {
+        FuzzyPickerState* st = find_fuzzy_picker(co, "FuzzyPickerGetRow");
+        if (!st) return EXECUTION_FAILURE;
+        if (index < 0 || static_cast<std::size_t>(index) >= st->rows.size()) {
+            std::fprintf(stderr, "newt: FuzzyPickerGetRow: %lld: index out of range\n", index);
+            return EXECUTION_FAILURE;
+        }
+        if (v) builtin_bind_variable(v, const_cast<char*>(st->rows[index]), 0);
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt FuzzyPickerGetRow fp index\n");
+    return EXECUTION_FAILURE;
+}
+
+// FuzzyPickerMatchCount fp  → number of candidates matching the query (the
+// listbox shows at most the best 1000 of them)
+static int wrap_FuzzyPickerMatchCount(char* v, WORD_LIST* a) {
+    newtComponent co;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, co)) goto usage;
+    {
+        FuzzyPickerState* st = find_fuzzy_picker(co, "FuzzyPickerMatchCount");
+        if (!st) return EXECUTION_FAILURE;
+        if (v) {
+            std::string s = to_bash_string(static_cast<long long>(st->matches));
+            builtin_bind_variable(v, const_cast<char*>(s.c_str()), 0);
+        }
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt FuzzyPickerMatchCount fp\n");
+    return EXECUTION_FAILURE;
+}
+
+// FuzzyPickerGetQuery fp  → text typed into the picker's entry
+static int wrap_FuzzyPickerGetQuery(char* v, WORD_LIST* a) {
+    newtComponent co;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, co)) goto usage;
+    {
+        FuzzyPickerState* st = find_fuzzy_picker(co, "FuzzyPickerGetQuery");
+        if (!st) return EXECUTION_FAILURE;
+        if (v) builtin_bind_variable(v, newtEntryGetValue(st->entry), 0);
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt FuzzyPickerGetQuery fp\n");
+    return EXECUTION_FAILURE;
+}
+
+// ─── FilePicker ───────────────────────────────────────────────────────────────
+// A CheckboxTreeMulti browsing a directory tree.  Directories are read on the
+// shared thread pool one level ahead of what is shown and filled into the
+// tree when expanded (see "file picker" above); the selection comes back as
+// paths.
+
+static FilePickerState* find_file_picker(newtComponent co, const char* cmd) {
+    auto it = g_file_pickers.find(co);
+    if (it == g_file_pickers.end()) {
+        std::fprintf(stderr, "newt: %s: not a file picker\n", cmd);
+        return nullptr;
+    }
+    return it->second.get();
+}
+
+// Absolute path of the node with data key 'key': a file, or a directory
+// (with a trailing '/') for its "." node.  Empty for directory nodes
+// themselves.
+static std::string file_picker_key_path(const FilePickerState& st, std::uintptr_t key) {
+    const TreeIndex::Node* n = st.index.find(key);
+    if (!n || st.dirs.count(key)) return "";
+    if (n->text != ".") return file_picker_path(st, n->path);
+    std::string rel = n->path.substr(0, n->path.size() - 1);   // "dir/" or ""
+    return newt_dir_scan::join(st.root, rel);
+}
+
+// FilePicker form left top width height root
+// Creates the tree, adds it to 'form' and returns it.
+static int wrap_FilePicker(char* v, WORD_LIST* a) {
+    newtComponent form;
+    int left, top, width, height;
+    const char* root;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, form))   goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, left))   goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, top))    goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, width))  goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, height)) goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, root))   goto usage;
+    {
+        auto st = std::make_unique<FilePickerState>();
+        st->root = root;
+        while (st->root.size() > 1 && st->root.back() == '/') st->root.pop_back();
+        st->scanner = std::make_unique<newt_dir_scan::DirScanner>(shared_thread_pool());
+        if (!st->scanner->open()) {
+            std::fprintf(stderr, "newt: FilePicker: pipe: %s\n", std::strerror(errno));
+            return EXECUTION_FAILURE;
+        }
+        auto listing = st->scanner->wait(st->root, true);
+        if (listing->error) {
+            std::fprintf(stderr, "newt: FilePicker: %s: %s\n", root, std::strerror(listing->error));
+            return EXECUTION_FAILURE;
+        }
+
+        newtComponent co = newtCheckboxTreeMulti(left, top, height, const_cast<char*>(" *"),
+                                                 NEWT_FLAG_SCROLL);
+        newtCheckboxTreeSetWidth(co, width);
+        file_picker_add(co, *st, 0, ".", "./");
+        file_picker_fill(co, *st, 0, *listing);
+        newtFormAddComponent(form, co);
+        newtFormWatchFd(form, st->scanner->fd(), NEWT_FD_READ);
+
+        track_component(co, FormRegistry::Kind::CheckboxTree);
+        g_forms.added(form, co);
+        g_file_pickers[co] = std::move(st);
+        if (v) {
+            std::string s = to_bash_string(co);
+            builtin_bind_variable(v, const_cast<char*>(s.c_str()), 0);
+        }
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt FilePicker form left top width height root\n");
+    return EXECUTION_FAILURE;
+}
+
+// FilePickerGetSelection fp arrayName
+// Fills arrayName with the selected paths, directories ending in '/'.
+static int wrap_FilePickerGetSelection(char* /*v*/, WORD_LIST* a) {
+    newtComponent co;
+    const char* name;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, co))   goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, name)) goto usage;
+    {
+        FilePickerState* st = find_file_picker(co, "FilePickerGetSelection");
+        if (!st) return EXECUTION_FAILURE;
+        SHELL_VAR* out = make_indexed_array("FilePickerGetSelection", name);
+        if (!out) return EXECUTION_FAILURE;
+
+        int n = 0;
+        const void** sel = newtCheckboxTreeGetSelection(co, &n);
+        arrayind_t i = 0;
+        for (int k = 0; k < n; ++k) {
+            std::string path = file_picker_key_path(*st, reinterpret_cast<std::uintptr_t>(sel[k]));
+            if (!path.empty())
+                bind_array_element(out, i++, const_cast<char*>(path.c_str()), 0);
+        }
+        std::free(sel);
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt FilePickerGetSelection fp arrayName\n");
+    return EXECUTION_FAILURE;
+}
+
+// FilePickerGetCurrent fp  → path of the current node ("" on a directory node)
+static int wrap_FilePickerGetCurrent(char* v, WORD_LIST* a) {
+    newtComponent co;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, co)) goto usage;
+    {
+        FilePickerState* st = find_file_picker(co, "FilePickerGetCurrent");
+        if (!st) return EXECUTION_FAILURE;
+        if (v) {
+            auto key = reinterpret_cast<std::uintptr_t>(newtCheckboxTreeGetCurrent(co));
+            const TreeIndex::Node* n = st->index.find(key);
+            std::string s = !n ? "" : st->dirs.count(key) ? file_picker_path(*st, n->path) + "/"
+                                                          : file_picker_key_path(*st, key);
+            builtin_bind_variable(v, const_cast<char*>(s.c_str()), 0);
+        }
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt FilePickerGetCurrent fp\n");
+    return EXECUTION_FAILURE;
+}
+
+// ─── TextboxLoadFile ──────────────────────────────────────────────────────────
+// Shows a file of any size in a textbox by mmap'ing it and feeding libnewt only
+// the page being viewed.  When a form is given, the paging keys (Up, Down,
+// PgUp, PgDn, Home, End) are registered as hotkeys on it and handled inside
+// RunForm / FormRun; other scripts can drive TextboxFileScroll themselves.
+
+static TextboxFileState* find_textbox_file(newtComponent co, const char* cmd) {
+    auto it = g_textbox_files.find(co);
+    if (it == g_textbox_files.end()) {
+        std::fprintf(stderr, "newt: %s: textbox has no file loaded\n", cmd);
+        return nullptr;
+    }
+    textbox_file_check(co, *it->second);
+    return it->second.get();
+}
+
+// TextboxLoadFile co path [form]
+static int wrap_TextboxLoadFile(char* /*v*/, WORD_LIST* a) {
+    newtComponent co;
+    const char* path;
+    newtComponent form = nullptr;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, co))   goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, path)) goto usage;
+    if (a->next) { a = a->next; if (!from_string(a->word->word, form)) goto usage; }
+    {
+        auto st = std::make_unique<TextboxFileState>();
+        if (!st->file.open(path)) {
+            std::fprintf(stderr, "newt: TextboxLoadFile: %s: %s\n",
+                         path, std::strerror(errno));
+            return EXECUTION_FAILURE;
+        }
+        st->index.reset(st->file.data(), st->file.size());
+        newtComponentGetSize(co, &st->width, &st->height);
+        st->width  = std::max(st->width, 1);
+        st->height = std::max(st->height, 1);
+        textbox_file_show(co, *st);
+
+        g_textbox_files[co] = std::move(st);
+        newtComponentAddDestroyCallback(co, component_destroy_shim, nullptr);
+
+        if (form) {
+            g_paged_forms[form] = co;
+            for (int key : { NEWT_KEY_UP, NEWT_KEY_DOWN, NEWT_KEY_PGUP,
+                             NEWT_KEY_PGDN, NEWT_KEY_HOME, NEWT_KEY_END })
+                newtFormAddHotKey(form, key);
+        }
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt TextboxLoadFile co path [form]\n");
+    return EXECUTION_FAILURE;
+}
+
+// TextboxFileScroll co key
+// Returns EXECUTION_FAILURE (silently) if 'key' is not a paging key.
+static int wrap_TextboxFileScroll(char* /*v*/, WORD_LIST* a) {
+    newtComponent co;
+    int key;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, co))  goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, key)) goto usage;
+    if (!find_textbox_file(co, "TextboxFileScroll")) return EXECUTION_FAILURE;
+    return textbox_file_scroll(co, key) ? EXECUTION_SUCCESS : EXECUTION_FAILURE;
+usage:
+    std::fprintf(stderr, "newt: usage: newt TextboxFileScroll co key\n");
+    return EXECUTION_FAILURE;
+}
+
+// TextboxFileSetTop co line  — show the page starting at file line 'line'
+static int wrap_TextboxFileSetTop(char* /*v*/, WORD_LIST* a) {
+    newtComponent co;
+    long long line;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, co))   goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, line)) goto usage;
+    {
+        TextboxFileState* st = find_textbox_file(co, "TextboxFileSetTop");
+        if (!st) return EXECUTION_FAILURE;
+        std::size_t top = line > 0 ? static_cast<std::size_t>(line) : 0;
+        if (st->index.line_start(top) == LineIndex::npos) {
+            std::size_t n = st->index.line_count();
+            top = n > 0 ? n - 1 : 0;
+        }
+        st->top = top;
+        textbox_file_show(co, *st);
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt TextboxFileSetTop co line\n");
+    return EXECUTION_FAILURE;
+}
+
+// TextboxFileGetTop co  → first file line currently shown (0-based)
+static int wrap_TextboxFileGetTop(char* v, WORD_LIST* a) {
+    newtComponent co;
 
     if (!a->next) goto usage; a = a->next;
-    if (!from_string(a->word->word, cols_var)) goto usage;
-    if (!a->next) goto usage; a = a->next;
-    if (!from_string(a->word->word, rows_var)) goto usage;
-
+    if (!from_string(a->word->word, co)) goto usage;
     {
-        int cols = 0, rows = 0;
-        newtGetScreenSize(&cols, &rows);
-        std::string cols_s = to_bash_string(cols);
-        std::string rows_s = to_bash_string(rows);
-        builtin_bind_variable(const_cast<char*>(cols_var), const_cast<char*>(cols_s.c_str()), 0);
-        builtin_bind_variable(const_cast<char*>(rows_var), const_cast<char*>(rows_s.c_str()), 0);
+        TextboxFileState* st = find_textbox_file(co, "TextboxFileGetTop");
+        if (!st) return EXECUTION_FAILURE;
+        if (v) {
+            std::string s = to_bash_string(static_cast<long long>(st->top));
+            builtin_bind_variable(v, const_cast<char*>(s.c_str()), 0);
+        }
     }
     return EXECUTION_SUCCESS;
 usage:
-    std::fprintf(stderr, "newt: usage: newt GetScreenSize colsVar rowsVar\n");
+    std::fprintf(stderr, "newt: usage: newt TextboxFileGetTop co\n");
     return EXECUTION_FAILURE;
 }
 
-// ComponentAddDestroyCallback co bashExpression
-// Registers a bash expression to be evaluated when the component is destroyed.
-static int wrap_ComponentAddDestroyCallback(char* /*v*/, WORD_LIST* a) {
+// TextboxFileLineCount co  → number of lines in the file (scans it fully)
+static int wrap_TextboxFileLineCount(char* v, WORD_LIST* a) {
     newtComponent co;
-    const char* expr;
 
     if (!a->next) goto usage; a = a->next;
     if (!from_string(a->word->word, co)) goto usage;
-    if (!a->next) goto usage; a = a->next;
-    if (!from_string(a->word->word, expr)) goto usage;
-
-    g_destroy_callbacks[co] = expr;
-    newtComponentAddDestroyCallback(co, component_destroy_shim, nullptr);
+    {
+        TextboxFileState* st = find_textbox_file(co, "TextboxFileLineCount");
+        if (!st) return EXECUTION_FAILURE;
+        if (v) {
+            std::string s = to_bash_string(static_cast<long long>(st->index.line_count()));
+            builtin_bind_variable(v, const_cast<char*>(s.c_str()), 0);
+        }
+    }
     return EXECUTION_SUCCESS;
 usage:
-    std::fprintf(stderr, "newt: usage: newt ComponentAddDestroyCallback co bashExpression\n");
+    std::fprintf(stderr, "newt: usage: newt TextboxFileLineCount co\n");
     return EXECUTION_FAILURE;
 }
 
-// ─── CheckboxTree ─────────────────────────────────────────────────────────────
+// ─── TextboxRunCommand ────────────────────────────────────────────────────────
+// Runs a command with its stdout and stderr streamed into a textbox (see
+// "textbox commands" above and newt_child_command.hpp).
 
-static int wrap_CheckboxTree(char* v, WORD_LIST* a) {
-    return call_newt("CheckboxTree", "left top height flags",
-                     newtCheckboxTree, v, a);
-}
+// TextboxRunCommand co cmd [args...]
+// One argument is run by /bin/sh -c; more are executed directly.  With -v,
+// the variable receives the exit status when the command finishes.
+static int wrap_TextboxRunCommand(char* v, WORD_LIST* a) {
+    newtComponent co;
 
-static int wrap_CheckboxTreeMulti(char* v, WORD_LIST* a) {
-    return call_newt("CheckboxTreeMulti", "left top height seq flags",
-                     newtCheckboxTreeMulti, v, a);
-}
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, co)) goto usage;
+    if (!a->next) goto usage;
+    {
+        if (!g_textboxes.count(co)) {
+            std::fprintf(stderr, "newt: TextboxRunCommand: not a textbox\n");
+            return EXECUTION_FAILURE;
+        }
+        auto old = g_textbox_commands.find(co);
+        if (old != g_textbox_commands.end() && old->second->running) {
+            std::fprintf(stderr, "newt: TextboxRunCommand: a command is already running in this textbox\n");
+            return EXECUTION_FAILURE;
+        }
+        std::vector<std::string> argv;
+        for (WORD_LIST* w = a->next; w; w = w->next) argv.push_back(w->word->word);
 
-static int wrap_CheckboxTreeSetCurrent(char* v, WORD_LIST* a) {
-    return call_newt("CheckboxTreeSetCurrent", "co item",
-                     newtCheckboxTreeSetCurrent, v, a);
+        int width = 1, height = 1;
+        newtComponentGetSize(co, &width, &height);
+        std::size_t scrollback = g_textboxes[co].scrollback;
+        auto st = std::make_unique<TextboxCommandState>(scrollback, std::max(width, 1),
+                                                        std::max(height, 1));
+        if (!st->command.start(argv)) {
+            std::fprintf(stderr, "newt: TextboxRunCommand: %s: %s\n",
+                         argv[0].c_str(), std::strerror(errno));
+            return EXECUTION_FAILURE;
+        }
+        if (v) st->status_var = v;
+        newtTextboxSetText(co, "");
+        g_textbox_commands[co] = std::move(st);
+        newtComponentAddDestroyCallback(co, component_destroy_shim, nullptr);
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt TextboxRunCommand co cmd [args...]\n");
+    return EXECUTION_FAILURE;
 }
 
-static int wrap_CheckboxTreeGetCurrent(char* v, WORD_LIST* a) {
-    return call_newt("CheckboxTreeGetCurrent", "co",
-                     newtCheckboxTreeGetCurrent, v, a);
-}
+// TextboxRunCommandWait co
+// Shows the output of the command running in 'co' until it exits, and
+// returns its exit status (0 if no command is running).
+static int wrap_TextboxRunCommandWait(char* /*v*/, WORD_LIST* a) {
+    newtComponent co;
 
-static int wrap_CheckboxTreeSetEntry(char* v, WORD_LIST* a) {
-    return call_newt("CheckboxTreeSetEntry", "co data text",
-                     newtCheckboxTreeSetEntry, v, a);
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, co)) goto usage;
+    {
+        auto it = g_textbox_commands.find(co);
+        if (it == g_textbox_commands.end() || !it->second->running) return EXECUTION_SUCCESS;
+        TextboxCommandState& st = *it->second;
+        for (;;) {
+            struct pollfd pfd = { st.command.fd(), POLLIN, 0 };
+            if (::poll(&pfd, 1, -1) < 0 && errno != EINTR) break;
+            bool open = textbox_command_pump(co, st);
+            newtRefresh();
+            if (!open) break;
+        }
+        return textbox_command_finish(co);
+    }
+usage:
+    std::fprintf(stderr, "newt: usage: newt TextboxRunCommandWait co\n");
+    return EXECUTION_FAILURE;
 }
 
-static int wrap_CheckboxTreeSetWidth(char* v, WORD_LIST* a) {
-    return call_newt("CheckboxTreeSetWidth", "co width",
-                     newtCheckboxTreeSetWidth, v, a);
-}
+// TextboxSetScrollback co lines [form]
+// Lines of output the next TextboxRunCommand in 'co' keeps (default 2000).
+// With 'form', the arrow keys, PgUp/PgDn and Home/End page through them
+// while that form runs, as for TextboxLoadFile.
+static int wrap_TextboxSetScrollback(char* /*v*/, WORD_LIST* a) {
+    newtComponent co;
+    int lines;
+    newtComponent form = nullptr;
 
-static int wrap_CheckboxTreeGetEntryValue(char* v, WORD_LIST* a) {
-    return call_newt("CheckboxTreeGetEntryValue", "co data",
-                     newtCheckboxTreeGetEntryValue, v, a);
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, co))    goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, lines)) goto usage;
+    if (a->next) { a = a->next; if (!from_string(a->word->word, form)) goto usage; }
+    {
+        auto it = g_textboxes.find(co);
+        if (it == g_textboxes.end()) {
+            std::fprintf(stderr, "newt: TextboxSetScrollback: not a textbox\n");
+            return EXECUTION_FAILURE;
+        }
+        if (lines < 1) {
+            std::fprintf(stderr, "newt: TextboxSetScrollback: lines must be at least 1\n");
+            return EXECUTION_FAILURE;
+        }
+        it->second.scrollback = static_cast<std::size_t>(lines);
+        if (form) {
+            g_paged_forms[form] = co;
+            for (int key : { NEWT_KEY_UP, NEWT_KEY_DOWN, NEWT_KEY_PGUP,
+                             NEWT_KEY_PGDN, NEWT_KEY_HOME, NEWT_KEY_END })
+                newtFormAddHotKey(form, key);
+        }
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt TextboxSetScrollback co lines [form]\n");
+    return EXECUTION_FAILURE;
 }
 
-static int wrap_CheckboxTreeSetEntryValue(char* v, WORD_LIST* a) {
-    return call_newt("CheckboxTreeSetEntryValue", "co data value",
-                     newtCheckboxTreeSetEntryValue, v, a);
-}
+// ─── AsyncLoad ────────────────────────────────────────────────────────────────
+// Loads a file or directory listing into a widget without blocking the UI.
+// The result is installed when a form run wakes up for it, or by
+// AsyncLoadWait.
 
-// CheckboxTreeGetSelection co numitemsVar
-// Binds itemsVar[0], itemsVar[1], ... and numitemsVar.
-static int wrap_CheckboxTreeGetSelection(char* /*v*/, WORD_LIST* a) {
+// AsyncLoad target path
+static int wrap_AsyncLoad(char* /*v*/, WORD_LIST* a) {
     newtComponent co;
-    const char* varname;
+    const char* path;
 
     if (!a->next) goto usage; a = a->next;
-    if (!from_string(a->word->word, co)) goto usage;
+    if (!from_string(a->word->word, co))   goto usage;
     if (!a->next) goto usage; a = a->next;
-    if (!from_string(a->word->word, varname)) goto usage;
+    if (!from_string(a->word->word, path)) goto usage;
     {
-        int n = 0;
-        const void** sel = newtCheckboxTreeGetSelection(co, &n);
-        for (int i = 0; i < n; ++i) {
-            std::string idx_var = std::string(varname) + "_" + std::to_string(i);
-            std::string val     = to_bash_string(sel[i]);
-            builtin_bind_variable(const_cast<char*>(idx_var.c_str()),
-                                  const_cast<char*>(val.c_str()), 0);
+        if (g_textbox_files.count(co) || g_listbox_filters.count(co) || g_fuzzy_pickers.count(co)) {
+            std::fprintf(stderr, "newt: AsyncLoad: widget is managed by "
+                                 "TextboxLoadFile, ListboxFilterBind or FuzzyPicker\n");
+            return EXECUTION_FAILURE;
         }
-        std::string cnt = to_bash_string(n);
-        builtin_bind_variable(const_cast<char*>(varname),
-                              const_cast<char*>(cnt.c_str()), 0);
+        bool lines;
+        if (!async_load_target(co, lines)) {
+            std::fprintf(stderr, "newt: AsyncLoad: not a listbox or textbox\n");
+            return EXECUTION_FAILURE;
+        }
+        if (!async_loader().start(co, path, lines, shared_thread_pool())) {
+            std::fprintf(stderr, "newt: AsyncLoad: %s\n", std::strerror(errno));
+            return EXECUTION_FAILURE;
+        }
+        newtComponentAddDestroyCallback(co, component_destroy_shim, nullptr);
     }
     return EXECUTION_SUCCESS;
 usage:
-    std::fprintf(stderr, "newt: usage: newt CheckboxTreeGetSelection co numVar\n");
+    std::fprintf(stderr, "newt: usage: newt AsyncLoad target path\n");
     return EXECUTION_FAILURE;
 }
 
-// CheckboxTreeGetMultiSelection co numitemsVar seqnum
-static int wrap_CheckboxTreeGetMultiSelection(char* /*v*/, WORD_LIST* a) {
+// AsyncLoadWait target
+// Blocks until the pending load for 'target' (if any) has finished and
+// installs it.
+static int wrap_AsyncLoadWait(char* /*v*/, WORD_LIST* a) {
     newtComponent co;
-    const char* varname;
-    char seqnum;
 
     if (!a->next) goto usage; a = a->next;
     if (!from_string(a->word->word, co)) goto usage;
-    if (!a->next) goto usage; a = a->next;
-    if (!from_string(a->word->word, varname)) goto usage;
-    if (!a->next) goto usage; a = a->next;
-    if (!from_string(a->word->word, seqnum)) goto usage;
     {
-        int n = 0;
-        const void** sel = newtCheckboxTreeGetMultiSelection(co, &n, seqnum);
-        for (int i = 0; i < n; ++i) {
-            std::string idx_var = std::string(varname) + "_" + std::to_string(i);
-            std::string val     = to_bash_string(sel[i]);
-            builtin_bind_variable(const_cast<char*>(idx_var.c_str()),
-                                  const_cast<char*>(val.c_str()), 0);
-        }
-        std::string cnt = to_bash_string(n);
-        builtin_bind_variable(const_cast<char*>(varname),
-                              const_cast<char*>(cnt.c_str()), 0);
+        newt_async_load::Result r;
+        if (async_loader().wait(co, r) && !async_load_install(r, "AsyncLoadWait"))
+            return EXECUTION_FAILURE;
     }
     return EXECUTION_SUCCESS;
 usage:
-    std::fprintf(stderr,
-        "newt: usage: newt CheckboxTreeGetMultiSelection co numVar seqnum\n");
+    std::fprintf(stderr, "newt: usage: newt AsyncLoadWait target\n");
     return EXECUTION_FAILURE;
 }
 
-// CheckboxTreeAddItem co text data flags index [index2 ...]
-// Extra integer indices build the variadic list terminated by NEWT_ARG_LAST.
-static int wrap_CheckboxTreeAddItem(char* v, WORD_LIST* a) {
-    newtComponent co;
-    const char* text;
-    void*       data;
-    int         flags;
+// ─── ProgressPanel ────────────────────────────────────────────────────────────
+// A column of labelled scales, one per job, fed by "jobId pct [message]"
+// lines from watched fds or ProgressPanelUpdate (see "progress panels"
+// above and newt_progress_panel.hpp).
+
+static ProgressPanelState* find_progress_panel(newtComponent co, const char* cmd) {
+    auto it = g_progress_panels.find(co);
+    if (it == g_progress_panels.end()) {
+        std::fprintf(stderr, "newt: %s: not a progress panel\n", cmd);
+        return nullptr;
+    }
+    return it->second.get();
+}
+
+// ProgressPanel form left top width jobId...
+// Adds one row per job to 'form' and returns the panel (the scale of its
+// first row).
+static int wrap_ProgressPanel(char* v, WORD_LIST* a) {
+    newtComponent form;
+    int left, top, width;
 
     if (!a->next) goto usage; a = a->next;
-    if (!from_string(a->word->word, co))   goto usage;
+    if (!from_string(a->word->word, form))  goto usage;
     if (!a->next) goto usage; a = a->next;
-    if (!from_string(a->word->word, text)) goto usage;
+    if (!from_string(a->word->word, left))  goto usage;
     if (!a->next) goto usage; a = a->next;
-    if (!from_string(a->word->word, data)) goto usage;
+    if (!from_string(a->word->word, top))   goto usage;
     if (!a->next) goto usage; a = a->next;
-    if (!from_string(a->word->word, flags)) goto usage;
+    if (!from_string(a->word->word, width)) goto usage;
+    if (!a->next) goto usage;
     {
-        // Collect remaining ints into a vector; append NEWT_ARG_LAST sentinel.
-        std::vector<int> indexes;
-        while (a->next) {
-            a = a->next;
-            int idx;
-            if (!from_string(a->word->word, idx)) goto usage;
-            indexes.push_back(idx);
+        std::vector<std::string> ids;
+        for (WORD_LIST* w = a->next; w; w = w->next) ids.push_back(w->word->word);
+        if (std::set<std::string>(ids.begin(), ids.end()).size() != ids.size()) {
+            std::fprintf(stderr, "newt: ProgressPanel: duplicate jobId\n");
+            return EXECUTION_FAILURE;
         }
-        // Build a null-terminated int array with NEWT_ARG_LAST sentinel.
-        // newtCheckboxTreeAddArray expects a plain int* terminated by
-        // NEWT_ARG_LAST, which is exactly what we build here.
-        indexes.push_back(NEWT_ARG_LAST);
-        int rc = newtCheckboxTreeAddArray(co, text, data, flags, indexes.data());
+        newt_progress::Layout l = newt_progress::panel_layout(width, ids);
+        auto st = std::make_unique<ProgressPanelState>(ids, l);
+        st->form = form;
+        for (std::size_t i = 0; i < ids.size(); ++i) {
+            int row = top + static_cast<int>(i);
+            std::string id = newt_progress::fit_columns(ids[i], l.id_width);
+            newtComponent label = newtLabel(left, row, id.c_str());
+            newtComponent scale = newtScale(left + l.id_width + 1, row, l.scale_width, 1000);
+            newtFormAddComponents(form, label, scale, NULL);
+            st->scales.push_back(scale);
+            if (l.message_width > 0) {
+                std::string blank = newt_progress::fit_columns("", l.message_width);
+                newtComponent msg = newtLabel(left + l.id_width + l.scale_width + 2, row,
+                                              blank.c_str());
+                newtFormAddComponent(form, msg);
+                st->messages.push_back(msg);
+            }
+        }
+        newtComponent co = st->scales.front();
+        g_progress_panels[co] = std::move(st);
+        newtComponentAddDestroyCallback(co, component_destroy_shim, nullptr);
         if (v) {
-            std::string s = to_bash_string(rc);
+            std::string s = to_bash_string(co);
             builtin_bind_variable(v, const_cast<char*>(s.c_str()), 0);
         }
     }
     return EXECUTION_SUCCESS;
 usage:
-    std::fprintf(stderr,
-        "newt: usage: newt CheckboxTreeAddItem co text data flags index ...\n");
+    std::fprintf(stderr, "newt: usage: newt ProgressPanel form left top width jobId...\n");
     return EXECUTION_FAILURE;
 }
 
-// CheckboxTreeFindItem co data — binds varname to space-separated index list
-static int wrap_CheckboxTreeFindItem(char* v, WORD_LIST* a) {
+// ProgressPanelWatch panel fd
+// Reads update lines from 'fd' while the panel's form runs, until end of
+// input.  The fd stays open; closing it is up to the script.
+static int wrap_ProgressPanelWatch(char* /*v*/, WORD_LIST* a) {
     newtComponent co;
-    void* data;
+    int fd;
 
     if (!a->next) goto usage; a = a->next;
-    if (!from_string(a->word->word, co))   goto usage;
+    if (!from_string(a->word->word, co)) goto usage;
     if (!a->next) goto usage; a = a->next;
-    if (!from_string(a->word->word, data)) goto usage;
+    if (!from_string(a->word->word, fd)) goto usage;
     {
-        int* idxs = newtCheckboxTreeFindItem(co, data);
-        std::string result;
-        if (idxs) {
-            for (int i = 0; idxs[i] != NEWT_ARG_LAST; ++i) {
-                if (i) result += ' ';
-                result += to_bash_string(idxs[i]);
-            }
-            // libnewt allocates this with malloc; free it.
-            free(idxs);
+        ProgressPanelState* p = find_progress_panel(co, "ProgressPanelWatch");
+        if (!p) return EXECUTION_FAILURE;
+        if (::fcntl(fd, F_GETFD) < 0) {
+            std::fprintf(stderr, "newt: ProgressPanelWatch: %d: %s\n", fd, std::strerror(errno));
+            return EXECUTION_FAILURE;
         }
-        if (v)
-            builtin_bind_variable(v, const_cast<char*>(result.c_str()), 0);
+        p->fds.emplace(fd, newt_progress::LineBuffer());
+        newtFormWatchFd(p->form, fd, NEWT_FD_READ);
     }
     return EXECUTION_SUCCESS;
 usage:
-    std::fprintf(stderr, "newt: usage: newt CheckboxTreeFindItem co data\n");
+    std::fprintf(stderr, "newt: usage: newt ProgressPanelWatch panel fd\n");
     return EXECUTION_FAILURE;
 }
 
-// ─── ListboxGetSelection co numVar ────────────────────────────────────────────
-// Binds numVar_0 … numVar_{n-1} to the void* data keys (as decimal integers)
-// and numVar to the count.
-static int wrap_ListboxGetSelection(char* /*v*/, WORD_LIST* a) {
+// ProgressPanelUpdate panel jobId pct [message]
+// Applies one update and brings the panel up to date at once.
+static int wrap_ProgressPanelUpdate(char* /*v*/, WORD_LIST* a) {
     newtComponent co;
-    const char* varname;
 
     if (!a->next) goto usage; a = a->next;
-    if (!from_string(a->word->word, co))     goto usage;
-    if (!a->next) goto usage; a = a->next;
-    if (!from_string(a->word->word, varname)) goto usage;
+    if (!from_string(a->word->word, co)) goto usage;
+    if (!a->next || !a->next->next) goto usage;
     {
-        int n = 0;
-        void** sel = newtListboxGetSelection(co, &n);
-        for (int i = 0; i < n; ++i) {
-            std::string idx_var = std::string(varname) + "_" + std::to_string(i);
-            std::string val     = to_bash_string(sel[i]);
-            builtin_bind_variable(const_cast<char*>(idx_var.c_str()),
-                                  const_cast<char*>(val.c_str()), 0);
+        ProgressPanelState* p = find_progress_panel(co, "ProgressPanelUpdate");
+        if (!p) return EXECUTION_FAILURE;
+        std::string line;
+        for (WORD_LIST* w = a->next; w; w = w->next) {
+            if (!line.empty()) line += ' ';
+            line += w->word->word;
         }
-        if (sel) free(sel);
-        std::string cnt = to_bash_string(n);
-        builtin_bind_variable(const_cast<char*>(varname),
-                              const_cast<char*>(cnt.c_str()), 0);
+        newt_progress::Update u;
+        if (!newt_progress::parse_update(line, u)) goto usage;
+        if (!p->model.apply(u)) {
+            std::fprintf(stderr, "newt: ProgressPanelUpdate: %s: no such job\n", u.job.c_str());
+            return EXECUTION_FAILURE;
+        }
+        progress_panel_show(*p);
     }
     return EXECUTION_SUCCESS;
 usage:
-    std::fprintf(stderr, "newt: usage: newt ListboxGetSelection co numVar\n");
+    std::fprintf(stderr, "newt: usage: newt ProgressPanelUpdate panel jobId pct [message]\n");
+    return EXECUTION_FAILURE;
+}
+
+// ProgressPanelSetFrameBudget panel ms
+// Sets how often updates read from watched fds reach the screen (default
+// 50 ms; 0 shows every wake-up).
+static int wrap_ProgressPanelSetFrameBudget(char* /*v*/, WORD_LIST* a) {
+    newtComponent co;
+    int ms;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, co)) goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, ms) || ms < 0) goto usage;
+    {
+        ProgressPanelState* p = find_progress_panel(co, "ProgressPanelSetFrameBudget");
+        if (!p) return EXECUTION_FAILURE;
+        p->budget_ms = ms;
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt ProgressPanelSetFrameBudget panel ms\n");
     return EXECUTION_FAILURE;
 }
 
 // ─── TextboxReflowed left top text width flexDown flexUp flags ────────────────
+// Recorded in g_textboxes, as for Textbox.
 static int wrap_TextboxReflowed(char* v, WORD_LIST* a) {
-    return call_newt("TextboxReflowed",
-                     "left top text width flexDown flexUp flags",
-                     newtTextboxReflowed, v, a);
+    int   left, top, width, flex_down, flex_up, flags;
+    char* text;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, left))      goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, top))       goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, text))      goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, width))     goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, flex_down)) goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, flex_up))   goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, flags))     goto usage;
+    {
+        newtComponent rv = newtTextboxReflowed(left, top, text, width,
+                                               flex_down, flex_up, flags);
+        g_textboxes[rv] = TextboxInfo();
+        newtComponentAddDestroyCallback(rv, component_destroy_shim, nullptr);
+        if (v) {
+            std::string s = to_bash_string(rv);
+            builtin_bind_variable(v, const_cast<char*>(s.c_str()), 0);
+        }
+    }
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr,
+        "newt: usage: newt TextboxReflowed left top text width flexDown flexUp flags\n");
+    return EXECUTION_FAILURE;
 }
 
 // ─── ReflowText text width flexDown flexUp actualWidthVar actualHeightVar ──────
@@ -1025,10 +5011,23 @@ static int wrap_CreateGrid(char* v, WORD_LIST* a) {
 }
 
 // GridSetField grid col row type val padLeft padTop padRight padBottom anchor flags
+// The field is recorded in g_grid_fields.
 static int wrap_GridSetField(char* v, WORD_LIST* a) {
-    return call_newt("GridSetField",
-                     "grid col row type val padLeft padTop padRight padBottom anchor flags",
-                     newtGridSetField, v, a);
+    int rc = call_newt("GridSetField",
+                       "grid col row type val padLeft padTop padRight padBottom anchor flags",
+                       newtGridSetField, v, a);
+    if (rc != EXECUTION_SUCCESS) return rc;
+    newtGrid grid;
+    int col, row;
+    enum newtGridElement type;
+    void* val;
+    a = a->next; from_string(a->word->word, grid);
+    a = a->next; from_string(a->word->word, col);
+    a = a->next; from_string(a->word->word, row);
+    a = a->next; from_string(a->word->word, type);
+    a = a->next; from_string(a->word->word, val);
+    g_grid_fields[grid][{ col, row }] = { type, val };
+    return rc;
 }
 
 // GridWrappedWindow grid title
@@ -1070,10 +5069,42 @@ usage:
     return EXECUTION_FAILURE;
 }
 
+// Records what newtGridAddComponentsToForm added to 'form' from 'grid', as
+// FormAddComponent(s) do, walking the cells in the same order.
+static void grid_added_to_form(newtGrid grid, newtComponent form, bool recurse) {
+    auto it = g_grid_fields.find(grid);
+    if (it == g_grid_fields.end()) return;
+    for (const auto& cell : it->second) {
+        const auto& field = cell.second;
+        if (field.first == NEWT_GRID_SUBGRID && recurse) {
+            grid_added_to_form(static_cast<newtGrid>(field.second), form, true);
+        } else if (field.first == NEWT_GRID_COMPONENT) {
+            newtComponent comp = static_cast<newtComponent>(field.second);
+            g_forms.added(form, comp);
+            auto tb = g_textboxes.find(comp);
+            if (tb != g_textboxes.end()) tb->second.form = form;
+        }
+    }
+}
+
 // GridAddComponentsToForm grid form recurse
-static int wrap_GridAddComponentsToForm(char* v, WORD_LIST* a) {
-    return call_newt("GridAddComponentsToForm", "grid form recurse",
-                     newtGridAddComponentsToForm, v, a);
+static int wrap_GridAddComponentsToForm(char* /*v*/, WORD_LIST* a) {
+    newtGrid      grid;
+    newtComponent form;
+    int           recurse;
+
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, grid))    goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, form))    goto usage;
+    if (!a->next) goto usage; a = a->next;
+    if (!from_string(a->word->word, recurse)) goto usage;
+    newtGridAddComponentsToForm(grid, form, recurse);
+    grid_added_to_form(grid, form, recurse != 0);
+    return EXECUTION_SUCCESS;
+usage:
+    std::fprintf(stderr, "newt: usage: newt GridAddComponentsToForm grid form recurse\n");
+    return EXECUTION_FAILURE;
 }
 
 // GridVStacked / GridHStacked / GridVCloseStacked / GridHCloseStacked
@@ -1086,9 +5117,11 @@ static int wrap_GridAddComponentsToForm(char* v, WORD_LIST* a) {
 // Simpler strategy: support up to 16 pairs and build explicit calls.
 // Even simpler: wrap the non-variadic alternative newtCreateGrid + newtGridSetField.
 // Providing direct wrappers for the variadic grid stackers via manual parsing:
+// The pairs go down column 0 of the new grid, or with 'horizontal' along
+// row 0; they are recorded in g_grid_fields.
 static newtGrid grid_stacked_helper(
         newtGrid (*fn_one)(enum newtGridElement, void*,...),
-        WORD_LIST* a) {
+        WORD_LIST* a, bool horizontal) {
     // Collect (type, val) pairs; stop when no more args.
     std::vector<std::pair<enum newtGridElement, void*>> pairs;
     while (a->next) {
@@ -1107,22 +5140,31 @@ static newtGrid grid_stacked_helper(
     // We call the function with up to 8 pairs to keep it simple.
 #define PAIR(i) pairs[i].first, pairs[i].second
     // Fall through a size-based dispatch; max 8 additional pairs.
-    size_t n = pairs.size();
+    size_t n = std::min<size_t>(pairs.size(), 8);
+    newtGrid g;
     switch (n) {
-    case 1: return fn_one(PAIR(0), NEWT_GRID_EMPTY, nullptr);
-    case 2: return fn_one(PAIR(0), PAIR(1), NEWT_GRID_EMPTY, nullptr);
-    case 3: return fn_one(PAIR(0), PAIR(1), PAIR(2), NEWT_GRID_EMPTY, nullptr);
-    case 4: return fn_one(PAIR(0), PAIR(1), PAIR(2), PAIR(3), NEWT_GRID_EMPTY, nullptr);
-    case 5: return fn_one(PAIR(0), PAIR(1), PAIR(2), PAIR(3), PAIR(4), NEWT_GRID_EMPTY, nullptr);
-    case 6: return fn_one(PAIR(0), PAIR(1), PAIR(2), PAIR(3), PAIR(4), PAIR(5), NEWT_GRID_EMPTY, nullptr);
-    case 7: return fn_one(PAIR(0), PAIR(1), PAIR(2), PAIR(3), PAIR(4), PAIR(5), PAIR(6), NEWT_GRID_EMPTY, nullptr);
-    default:return fn_one(PAIR(0), PAIR(1), PAIR(2), PAIR(3), PAIR(4), PAIR(5), PAIR(6), PAIR(7), NEWT_GRID_EMPTY, nullptr);
+    case 1: g = fn_one(PAIR(0), NEWT_GRID_EMPTY, nullptr); break;
+    case 2: g = fn_one(PAIR(0), PAIR(1), NEWT_GRID_EMPTY, nullptr); break;
+    case 3: g = fn_one(PAIR(0), PAIR(1), PAIR(2), NEWT_GRID_EMPTY, nullptr); break;
+    case 4: g = fn_one(PAIR(0), PAIR(1), PAIR(2), PAIR(3), NEWT_GRID_EMPTY, nullptr); break;
+    case 5: g = fn_one(PAIR(0), PAIR(1), PAIR(2), PAIR(3), PAIR(4), NEWT_GRID_EMPTY, nullptr); break;
+    case 6: g = fn_one(PAIR(0), PAIR(1), PAIR(2), PAIR(3), PAIR(4), PAIR(5), NEWT_GRID_EMPTY, nullptr); break;
+    case 7: g = fn_one(PAIR(0), PAIR(1), PAIR(2), PAIR(3), PAIR(4), PAIR(5), PAIR(6), NEWT_GRID_EMPTY, nullptr); break;
+    default:g = fn_one(PAIR(0), PAIR(1), PAIR(2), PAIR(3), PAIR(4), PAIR(5), PAIR(6), PAIR(7), NEWT_GRID_EMPTY, nullptr); break;
     }
 #undef PAIR
+    if (g) {
+        GridFields& fields = g_grid_fields[g];
+        for (size_t i = 0; i < n; ++i) {
+            int k = static_cast<int>(i);
+            fields[horizontal ? std::make_pair(k, 0) : std::make_pair(0, k)] = pairs[i];
+        }
+    }
+    return g;
 }
 
 static int wrap_GridVStacked(char* v, WORD_LIST* a) {
-    newtGrid g = grid_stacked_helper(newtGridVStacked, a);
+    newtGrid g = grid_stacked_helper(newtGridVStacked, a, false);
     if (!g) {
         std::fprintf(stderr,
             "newt: usage: newt GridVStacked type1 val1 [type2 val2 ...]\n");
@@ -1136,7 +5178,7 @@ static int wrap_GridVStacked(char* v, WORD_LIST* a) {
 }
 
 static int wrap_GridVCloseStacked(char* v, WORD_LIST* a) {
-    newtGrid g = grid_stacked_helper(newtGridVCloseStacked, a);
+    newtGrid g = grid_stacked_helper(newtGridVCloseStacked, a, false);
     if (!g) {
         std::fprintf(stderr,
             "newt: usage: newt GridVCloseStacked type1 val1 [type2 val2 ...]\n");
@@ -1150,7 +5192,7 @@ static int wrap_GridVCloseStacked(char* v, WORD_LIST* a) {
 }
 
 static int wrap_GridHStacked(char* v, WORD_LIST* a) {
-    newtGrid g = grid_stacked_helper(newtGridHStacked, a);
+    newtGrid g = grid_stacked_helper(newtGridHStacked, a, true);
     if (!g) {
         std::fprintf(stderr,
             "newt: usage: newt GridHStacked type1 val1 [type2 val2 ...]\n");
@@ -1164,7 +5206,7 @@ static int wrap_GridHStacked(char* v, WORD_LIST* a) {
 }
 
 static int wrap_GridHCloseStacked(char* v, WORD_LIST* a) {
-    newtGrid g = grid_stacked_helper(newtGridHCloseStacked, a);
+    newtGrid g = grid_stacked_helper(newtGridHCloseStacked, a, true);
     if (!g) {
         std::fprintf(stderr,
             "newt: usage: newt GridHCloseStacked type1 val1 [type2 val2 ...]\n");
@@ -1479,6 +5521,7 @@ static const DispatchEntry dispatch_table[] = {
     { "FormWatchFd",             wrap_FormWatchFd       },
     { "RunForm",                wrap_RunForm           },
     { "FormRun",                wrap_FormRun           },
+    { "FormPoll",               wrap_FormPoll          },
     { "DrawForm",               wrap_DrawForm          },
     { "FormAddHotKey",          wrap_FormAddHotKey     },
     { "FormGetScrollPosition",  wrap_FormGetScrollPosition },
@@ -1500,8 +5543,11 @@ static const DispatchEntry dispatch_table[] = {
     { "EntrySetCursorPosition", wrap_EntrySetCursorPosition },
     { "ScaleSet",               wrap_ScaleSet          },
     { "ScaleSetColors",         wrap_ScaleSetColors    },    { "GetScreenSize",           wrap_GetScreenSize     },
+    { "ScaleBindShm",           wrap_ScaleBindShm      },
     { "ComponentAddDestroyCallback", wrap_ComponentAddDestroyCallback },    { "SetColors",              wrap_SetColors         },
     { "SetSuspendCallback",     wrap_SetSuspendCallback},
+    { "EventsSetQueued",        wrap_EventsSetQueued   },
+    { "EventsDrain",            wrap_EventsDrain       },
     // ── constructors ──────────────────────────────────────────────────────────
     { "Entry",                  wrap_Entry             },
     { "Form",                   wrap_Form              },
@@ -1512,8 +5558,16 @@ static const DispatchEntry dispatch_table[] = {
     // ── entry helpers ─────────────────────────────────────────────────────────
     { "EntrySet",               wrap_EntrySet          },
     { "EntrySetFilter",         wrap_EntrySetFilter    },
+    { "EntrySetNativeFilter",   wrap_EntrySetNativeFilter },
+    { "EntrySetValidator",      wrap_EntrySetValidator },
     // ── form helpers ──────────────────────────────────────────────────────────
     { "FormAddComponents",      wrap_FormAddComponents },
+    { "FormCollect",            wrap_FormCollect       },
+    { "ComponentSetId",         wrap_ComponentSetId    },
+    { "FormSnapshot",           wrap_FormSnapshot      },
+    { "FormRestore",            wrap_FormRestore       },
+    { "FormGetChanged",         wrap_FormGetChanged    },
+    { "FormValidate",           wrap_FormValidate      },
     // ── CheckboxTree ──────────────────────────────────────────────────────────
     { "CheckboxTree",               wrap_CheckboxTree              },
     { "CheckboxTreeMulti",          wrap_CheckboxTreeMulti         },
@@ -1527,11 +5581,54 @@ static const DispatchEntry dispatch_table[] = {
     { "CheckboxTreeGetMultiSelection", wrap_CheckboxTreeGetMultiSelection },
     { "CheckboxTreeAddItem",        wrap_CheckboxTreeAddItem       },
     { "CheckboxTreeFindItem",       wrap_CheckboxTreeFindItem      },
+    { "CheckboxTreeLoad",           wrap_CheckboxTreeLoad          },
+    { "CheckboxTreeSetEntryValues", wrap_CheckboxTreeSetEntryValues },
+    { "CheckboxTreeGetEntryValues", wrap_CheckboxTreeGetEntryValues },
     // ── Listbox selection ─────────────────────────────────────────────────────
     { "ListboxGetSelection",        wrap_ListboxGetSelection       },
+    { "ListboxSort",                wrap_ListboxSort               },
+    // ── VirtualListbox ────────────────────────────────────────────────────────
+    { "VirtualListbox",             wrap_VirtualListbox            },
+    { "VirtualListboxSetRows",      wrap_VirtualListboxSetRows     },
+    { "VirtualListboxLoadFile",     wrap_VirtualListboxLoadFile    },
+    { "VirtualListboxGetCurrent",   wrap_VirtualListboxGetCurrent  },
+    { "VirtualListboxSetCurrent",   wrap_VirtualListboxSetCurrent  },
+    { "VirtualListboxGetRow",       wrap_VirtualListboxGetRow      },
+    { "VirtualListboxItemCount",    wrap_VirtualListboxItemCount   },
+    // ── ListboxFilter ─────────────────────────────────────────────────────────
+    { "ListboxFilterBind",          wrap_ListboxFilterBind         },
+    { "ListboxFilterUnbind",        wrap_ListboxFilterUnbind       },
+    // ── FuzzyPicker ───────────────────────────────────────────────────────────
+    { "FuzzyPicker",                wrap_FuzzyPicker               },
+    { "FuzzyPickerSetRows",         wrap_FuzzyPickerSetRows        },
+    { "FuzzyPickerLoadFile",        wrap_FuzzyPickerLoadFile       },
+    { "FuzzyPickerGetCurrent",      wrap_FuzzyPickerGetCurrent     },
+    { "FuzzyPickerGetRow",          wrap_FuzzyPickerGetRow         },
+    { "FuzzyPickerMatchCount",      wrap_FuzzyPickerMatchCount     },
+    { "FuzzyPickerGetQuery",        wrap_FuzzyPickerGetQuery       },
+    // ── FilePicker ────────────────────────────────────────────────────────────
+    { "FilePicker",                 wrap_FilePicker                },
+    { "FilePickerGetSelection",     wrap_FilePickerGetSelection    },
+    { "FilePickerGetCurrent",       wrap_FilePickerGetCurrent      },
     // ── Textbox ───────────────────────────────────────────────────────────────
     { "TextboxReflowed",            wrap_TextboxReflowed           },
+    { "TextboxLoadFile",            wrap_TextboxLoadFile           },
+    { "TextboxFileScroll",          wrap_TextboxFileScroll         },
+    { "TextboxFileSetTop",          wrap_TextboxFileSetTop         },
+    { "TextboxFileGetTop",          wrap_TextboxFileGetTop         },
+    { "TextboxFileLineCount",       wrap_TextboxFileLineCount      },
+    { "TextboxRunCommand",          wrap_TextboxRunCommand         },
+    { "TextboxRunCommandWait",      wrap_TextboxRunCommandWait     },
+    { "TextboxSetScrollback",       wrap_TextboxSetScrollback      },
     { "ReflowText",                 wrap_ReflowText                },
+    // ── Background loads ──────────────────────────────────────────────────────
+    { "AsyncLoad",                  wrap_AsyncLoad                 },
+    { "AsyncLoadWait",              wrap_AsyncLoadWait             },
+    // ── Progress panels ───────────────────────────────────────────────────────
+    { "ProgressPanel",              wrap_ProgressPanel             },
+    { "ProgressPanelWatch",         wrap_ProgressPanelWatch        },
+    { "ProgressPanelUpdate",        wrap_ProgressPanelUpdate       },
+    { "ProgressPanelSetFrameBudget", wrap_ProgressPanelSetFrameBudget },
     // ── Grid ──────────────────────────────────────────────────────────────────
     { "CreateGrid",                 wrap_CreateGrid                },
     { "GridSetField",               wrap_GridSetField              },
@@ -1544,6 +5641,17 @@ static const DispatchEntry dispatch_table[] = {
     { "GridHStacked",               wrap_GridHStacked              },
     { "GridHCloseStacked",          wrap_GridHCloseStacked         },
     { "GridDestroy",                wrap_GridFree                  },   // alias
+    // ── Screen capture ────────────────────────────────────────────────────────
+    { "ScreenDump",                 wrap_ScreenDump                },
+    // ── Output accounting ─────────────────────────────────────────────────────
+    { "OutputStatsStart",           wrap_OutputStatsStart          },
+    { "OutputStatsStop",            wrap_OutputStatsStop           },
+    { "OutputStatsReset",           wrap_OutputStatsReset          },
+    { "OutputStats",                wrap_OutputStats               },
+    // ── Palettes ──────────────────────────────────────────────────────────────
+    { "PaletteDefine",              wrap_PaletteDefine             },
+    { "PaletteLoad",                wrap_PaletteLoad               },
+    { "PaletteApply",               wrap_PaletteApply              },
     // ── Win* convenience dialogs ──────────────────────────────────────────────
     { "WinMessage",                 wrap_WinMessage                },
     { "WinChoice",                  wrap_WinChoice                 },
@@ -0,0 +1,47 @@
+/**
+ * fixtures.hpp
+ *
+ * Shared helpers for unit tests that need real files or file descriptors:
+ * a scratch directory removed with everything in it when the test ends, and
+ * a poll() wrapper for the notify pipes and timers of the native helpers.
+ *
+ * Usage:
+ *   TempDir d;
+ *   std::string p = d.file("rows.txt", "one\ntwo\n");   // write a file
+ *   std::string q = d.path + "/counter";                 // a path to create
+ *   REQUIRE(poll_readable(loader.fd(), 5000));
+ */
+#pragma once
+
+#include <cstdlib>
+#include <fstream>
+#include <poll.h>
+#include <string>
+
+struct TempDir {
+    std::string path;
+
+    TempDir() {
+        char tmpl[] = "/tmp/newt_test_XXXXXX";
+        const char* p = ::mkdtemp(tmpl);
+        path = p ? p : "";
+    }
+    ~TempDir() {
+        if (!path.empty()) std::system(("rm -rf '" + path + "'").c_str());
+    }
+    TempDir(const TempDir&) = delete;
+    TempDir& operator=(const TempDir&) = delete;
+
+    // Writes 'content' to 'name' inside the directory and returns its path.
+    std::string file(const std::string& name, const std::string& content = "") const {
+        std::string p = path + "/" + name;
+        std::ofstream(p, std::ios::binary) << content;
+        return p;
+    }
+};
+
+// True if 'fd' becomes readable within 'timeout_ms' (0: just check).
+inline bool poll_readable(int fd, int timeout_ms) {
+    struct pollfd pfd = { fd, POLLIN, 0 };
+    return ::poll(&pfd, 1, timeout_ms) == 1;
+}
@@ -27,6 +27,90 @@ using newtEntryFilter     = char (*)(newtComponent, void*, int, int);
 static constexpr int NEWT_ARG_LAST   = -100000;
 static constexpr int NEWT_ARG_APPEND = -1;
 
+// Values as in newt.h; newt_symbols.hpp builds its table from these.
+static constexpr int NEWT_COLORSET_ROOT              = 2;
+static constexpr int NEWT_COLORSET_BORDER            = 3;
+static constexpr int NEWT_COLORSET_WINDOW            = 4;
+static constexpr int NEWT_COLORSET_SHADOW            = 5;
+static constexpr int NEWT_COLORSET_TITLE             = 6;
+static constexpr int NEWT_COLORSET_BUTTON            = 7;
+static constexpr int NEWT_COLORSET_ACTBUTTON         = 8;
+static constexpr int NEWT_COLORSET_CHECKBOX          = 9;
+static constexpr int NEWT_COLORSET_ACTCHECKBOX       = 10;
+static constexpr int NEWT_COLORSET_ENTRY             = 11;
+static constexpr int NEWT_COLORSET_LABEL             = 12;
+static constexpr int NEWT_COLORSET_LISTBOX           = 13;
+static constexpr int NEWT_COLORSET_ACTLISTBOX        = 14;
+static constexpr int NEWT_COLORSET_TEXTBOX           = 15;
+static constexpr int NEWT_COLORSET_ACTTEXTBOX        = 16;
+static constexpr int NEWT_COLORSET_HELPLINE          = 17;
+static constexpr int NEWT_COLORSET_ROOTTEXT          = 18;
+static constexpr int NEWT_COLORSET_EMPTYSCALE        = 19;
+static constexpr int NEWT_COLORSET_FULLSCALE         = 20;
+static constexpr int NEWT_COLORSET_DISENTRY          = 21;
+static constexpr int NEWT_COLORSET_COMPACTBUTTON     = 22;
+static constexpr int NEWT_COLORSET_ACTSELLISTBOX     = 23;
+static constexpr int NEWT_COLORSET_SELLISTBOX        = 24;
+static constexpr int NEWT_FLAG_RETURNEXIT            = (1 << 0);
+static constexpr int NEWT_FLAG_HIDDEN                = (1 << 1);
+static constexpr int NEWT_FLAG_SCROLL                = (1 << 2);
+static constexpr int NEWT_FLAG_DISABLED              = (1 << 3);
+static constexpr int NEWT_FLAG_BORDER                = (1 << 5);
+static constexpr int NEWT_FLAG_WRAP                  = (1 << 6);
+static constexpr int NEWT_FLAG_NOF12                 = (1 << 7);
+static constexpr int NEWT_FLAG_MULTIPLE              = (1 << 8);
+static constexpr int NEWT_FLAG_SELECTED              = (1 << 9);
+static constexpr int NEWT_FLAG_CHECKBOX              = (1 << 10);
+static constexpr int NEWT_FLAG_PASSWORD              = (1 << 11);
+static constexpr int NEWT_FLAG_SHOWCURSOR            = (1 << 12);
+static constexpr int NEWT_FD_READ                    = (1 << 0);
+static constexpr int NEWT_FD_WRITE                   = (1 << 1);
+static constexpr int NEWT_FD_EXCEPT                  = (1 << 2);
+static constexpr int NEWT_CHECKBOXTREE_UNSELECTABLE  = (1 << 12);
+static constexpr int NEWT_CHECKBOXTREE_HIDE_BOX      = (1 << 13);
+static constexpr char NEWT_CHECKBOXTREE_COLLAPSED     = '\0';
+static constexpr char NEWT_CHECKBOXTREE_EXPANDED      = '\1';
+static constexpr char NEWT_CHECKBOXTREE_UNSELECTED    = ' ';
+static constexpr char NEWT_CHECKBOXTREE_SELECTED      = '*';
+static constexpr char NEWT_KEY_TAB                    = '\t';
+static constexpr char NEWT_KEY_ENTER                  = '\r';
+static constexpr char NEWT_KEY_SUSPEND                = '\032';
+static constexpr char NEWT_KEY_ESCAPE                 = '\033';
+static constexpr char NEWT_KEY_RETURN                 = NEWT_KEY_ENTER;
+static constexpr int NEWT_KEY_EXTRA_BASE             = 0x8000;
+static constexpr int NEWT_KEY_UP                     = NEWT_KEY_EXTRA_BASE + 1;
+static constexpr int NEWT_KEY_DOWN                   = NEWT_KEY_EXTRA_BASE + 2;
+static constexpr int NEWT_KEY_LEFT                   = NEWT_KEY_EXTRA_BASE + 4;
+static constexpr int NEWT_KEY_RIGHT                  = NEWT_KEY_EXTRA_BASE + 5;
+static constexpr int NEWT_KEY_BKSPC                  = NEWT_KEY_EXTRA_BASE + 6;
+static constexpr int NEWT_KEY_DELETE                 = NEWT_KEY_EXTRA_BASE + 7;
+static constexpr int NEWT_KEY_HOME                   = NEWT_KEY_EXTRA_BASE + 8;
+static constexpr int NEWT_KEY_END                    = NEWT_KEY_EXTRA_BASE + 9;
+static constexpr int NEWT_KEY_UNTAB                  = NEWT_KEY_EXTRA_BASE + 10;
+static constexpr int NEWT_KEY_PGUP                   = NEWT_KEY_EXTRA_BASE + 11;
+static constexpr int NEWT_KEY_PGDN                   = NEWT_KEY_EXTRA_BASE + 12;
+static constexpr int NEWT_KEY_INSERT                 = NEWT_KEY_EXTRA_BASE + 13;
+static constexpr int NEWT_KEY_F1                     = NEWT_KEY_EXTRA_BASE + 101;
+static constexpr int NEWT_KEY_F2                     = NEWT_KEY_EXTRA_BASE + 102;
+static constexpr int NEWT_KEY_F3                     = NEWT_KEY_EXTRA_BASE + 103;
+static constexpr int NEWT_KEY_F4                     = NEWT_KEY_EXTRA_BASE + 104;
+static constexpr int NEWT_KEY_F5                     = NEWT_KEY_EXTRA_BASE + 105;
+static constexpr int NEWT_KEY_F6                     = NEWT_KEY_EXTRA_BASE + 106;
+static constexpr int NEWT_KEY_F7                     = NEWT_KEY_EXTRA_BASE + 107;
+static constexpr int NEWT_KEY_F8                     = NEWT_KEY_EXTRA_BASE + 108;
+static constexpr int NEWT_KEY_F9                     = NEWT_KEY_EXTRA_BASE + 109;
+static constexpr int NEWT_KEY_F10                    = NEWT_KEY_EXTRA_BASE + 110;
+static constexpr int NEWT_KEY_F11                    = NEWT_KEY_EXTRA_BASE + 111;
+static constexpr int NEWT_KEY_F12                    = NEWT_KEY_EXTRA_BASE + 112;
+static constexpr int NEWT_KEY_RESIZE                 = NEWT_KEY_EXTRA_BASE + 113;
+static constexpr int NEWT_KEY_ERROR                  = NEWT_KEY_EXTRA_BASE + 114;
+static constexpr int NEWT_ANCHOR_LEFT                = (1 << 0);
+static constexpr int NEWT_ANCHOR_RIGHT               = (1 << 1);
+static constexpr int NEWT_ANCHOR_TOP                 = (1 << 2);
+static constexpr int NEWT_ANCHOR_BOTTOM              = (1 << 3);
+static constexpr int NEWT_GRID_FLAG_GROWX            = (1 << 0);
+static constexpr int NEWT_GRID_FLAG_GROWY            = (1 << 1);
+
 // ── enums ─────────────────────────────────────────────────────────────────────
 
 enum newtFlagsSense {
@@ -0,0 +1,119 @@
+/**
+ * test_async_load.cpp
+ *
+ * Unit tests for newt_async_load.hpp — reading files and directories off the
+ * main thread, the notify pipe and superseded loads.
+ */
+
+#include "stubs/fixtures.hpp"
+#include "newt_async_load.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cerrno>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace newt_async_load;
+
+TEST_CASE("async load: read_path reads files and lists directories", "[async_load]") {
+    TempDir d;
+    std::string big(200000, 'x');
+    std::string p = d.file("b.txt", big);
+    d.file("a.txt", "");
+    ::mkdir((d.path + "/sub").c_str(), 0700);
+
+    std::string out;
+    REQUIRE(read_path(p, out));
+    CHECK(out == big);
+
+    REQUIRE(read_path(d.path, out));
+    CHECK(out == "a.txt\nb.txt\nsub/\n");
+
+    CHECK_FALSE(read_path(d.path + "/missing", out));
+    CHECK(errno == ENOENT);
+}
+
+TEST_CASE("async load: results arrive through the notify pipe", "[async_load]") {
+    TempDir d;
+    std::string p = d.file("rows.txt", "one\ntwo\nthree\n");
+    ThreadPool pool(2);
+    Loader loader;
+    CHECK(loader.fd() < 0);
+
+    int list = 0, text = 0, bad = 0;
+    REQUIRE(loader.start(&list, p, true, pool));
+    REQUIRE(loader.start(&text, p, false, pool));
+    REQUIRE(loader.start(&bad, d.path + "/missing", false, pool));
+    REQUIRE(loader.fd() >= 0);
+    CHECK(loader.pending(&list));
+
+    std::vector<Result> got;
+    while (got.size() < 3) {
+        REQUIRE(poll_readable(loader.fd(), 5000));
+        for (Result& r : loader.take()) got.push_back(std::move(r));
+    }
+    CHECK_FALSE(loader.pending());
+    CHECK_FALSE(poll_readable(loader.fd(), 0));            // pipe drained
+
+    for (const Result& r : got) {
+        if (r.target == &list) {
+            REQUIRE(r.rows.size() == 3);
+            CHECK(std::string(r.rows[2]) == "three");
+            CHECK(r.error == 0);
+        } else if (r.target == &text) {
+            CHECK(r.text == "one\ntwo\nthree\n");
+            CHECK(r.rows.empty());
+        } else {
+            CHECK(r.target == &bad);
+            CHECK(r.error == ENOENT);
+            CHECK(r.path == d.path + "/missing");
+        }
+    }
+}
+
+TEST_CASE("async load: a newer load or cancel supersedes the old one", "[async_load]") {
+    TempDir d;
+    std::string a = d.file("a", "old\n"), b = d.file("b", "new\n");
+    ThreadPool pool(1);
+    Loader loader;
+    int target = 0, other = 0;
+
+    REQUIRE(loader.start(&target, a, true, pool));
+    REQUIRE(loader.start(&target, b, true, pool));
+    REQUIRE(loader.start(&other, a, true, pool));
+
+    Result r;
+    REQUIRE(loader.wait(&target, r));
+    CHECK(std::string(r.rows[0]) == "new");
+    CHECK_FALSE(loader.wait(&target, r));             // already taken
+
+    loader.cancel(&other);
+    pool.wait_idle();
+    CHECK(loader.take().empty());                      // stale and cancelled
+    CHECK_FALSE(loader.pending());
+}
+
+TEST_CASE("async load: take with a filter leaves other targets queued", "[async_load]") {
+    TempDir d;
+    std::string p = d.file("rows.txt", "one\n");
+    ThreadPool pool(1);
+    Loader loader;
+    int mine = 0, other = 0;
+
+    REQUIRE(loader.start(&mine, p, true, pool));
+    REQUIRE(loader.start(&other, p, true, pool));
+    pool.wait_idle();
+
+    auto only_mine = [&mine](const void* t) { return t == &mine; };
+    std::vector<Result> got = loader.take(only_mine);
+    REQUIRE(got.size() == 1);
+    CHECK(got[0].target == &mine);
+    CHECK(loader.pending(&other));
+    CHECK(loader.take(only_mine).empty());
+
+    got = loader.take();
+    REQUIRE(got.size() == 1);
+    CHECK(got[0].target == &other);
+    CHECK_FALSE(loader.pending());
+}
@@ -0,0 +1,69 @@
+/**
+ * test_child_command.cpp
+ *
+ * Unit tests for newt_child_command.hpp — running a command with its output
+ * on a pipe and getting its exit status back through the supervisor.
+ */
+
+#include "stubs/fixtures.hpp"
+#include "newt_child_command.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+
+// Reads until the output ends.
+static std::string drain(ChildCommand& c) {
+    std::string out;
+    for (;;) {
+        REQUIRE(poll_readable(c.fd(), 5000));
+        if (!c.read(out)) return out;
+    }
+}
+
+TEST_CASE("child command: argv runs without a shell", "[child_command]") {
+    ChildCommand c;
+    REQUIRE(c.start({ "printf", "%s|", "a b", "$HOME" }));
+    CHECK(drain(c) == "a b|$HOME|");
+    CHECK(c.fd() < 0);
+    CHECK(c.status() == 0);
+    CHECK(c.status() == 0);                            // cached
+}
+
+TEST_CASE("child command: one word is a shell command line", "[child_command]") {
+    ChildCommand c;
+    REQUIRE(c.start({ "echo out; echo err >&2; read x; echo \"[$x]\"; exit 3" }));
+    CHECK(drain(c) == "out\nerr\n[]\n");               // stdin is /dev/null
+    CHECK(c.status() == 3);
+}
+
+TEST_CASE("child command: exec failure and signals", "[child_command]") {
+    ChildCommand missing;
+    REQUIRE(missing.start({ "/nonexistent/newt-test", "x" }));
+    CHECK(drain(missing) == "/nonexistent/newt-test: cannot execute\n");
+    CHECK(missing.status() == 127);
+
+    ChildCommand killed;
+    REQUIRE(killed.start({ "kill -9 $$" }));
+    drain(killed);
+    CHECK(killed.status() == 128 + 9);
+}
+
+TEST_CASE("child command: terminate stops a running command", "[child_command]") {
+    ChildCommand c;
+    REQUIRE(c.start({ "sleep", "30" }));
+    c.terminate();
+    CHECK(c.fd() < 0);
+}
+
+TEST_CASE("child command: a fast writer does not keep read() busy", "[child_command]") {
+    ChildCommand c;
+    REQUIRE(c.start({ "yes" }));
+    std::string out;
+    REQUIRE(poll_readable(c.fd(), 5000));
+    for (int i = 0; i < 4; ++i) {
+        out.clear();
+        CHECK(c.read(out));
+        CHECK(out.size() <= ChildCommand::kReadLimit);
+    }
+    c.terminate();
+}
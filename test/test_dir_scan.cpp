@@ -0,0 +1,97 @@
+/**
+ * test_dir_scan.cpp
+ *
+ * Unit tests for newt_dir_scan.hpp — directory listings, prefetching of the
+ * next level and the listing cache behind FilePicker.
+ */
+
+#include "stubs/fixtures.hpp"
+#include "newt_dir_scan.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cerrno>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace newt_dir_scan;
+
+namespace {
+
+// A small source tree in a TempDir.
+struct TempTree {
+    TempDir     dir;
+    std::string root = dir.path;
+    TempTree() {
+        ::mkdir((root + "/src").c_str(), 0700);
+        ::mkdir((root + "/src/lib").c_str(), 0700);
+        ::mkdir((root + "/docs").c_str(), 0700);
+        dir.file("README");
+        dir.file("Makefile");
+        dir.file("src/main.c");
+        ::symlink("..", (root + "/src/up").c_str());
+    }
+};
+
+} // namespace
+
+TEST_CASE("dir scan: directories first, then files, no dot entries", "[dir_scan]") {
+    TempTree t;
+    Listing l = scan_directory(t.root);
+    REQUIRE(l.error == 0);
+    REQUIRE(l.entries.size() == 4);
+    CHECK(l.entries[0].name == "docs");
+    CHECK(l.entries[0].dir);
+    CHECK(l.entries[1].name == "src");
+    CHECK(l.entries[2].name == "Makefile");
+    CHECK_FALSE(l.entries[2].dir);
+    CHECK(l.entries[3].name == "README");
+
+    Listing src = scan_directory(t.root + "/src");
+    REQUIRE(src.entries.size() == 3);
+    CHECK(src.entries[0].name == "lib");
+    CHECK(src.entries[2].name == "up");                // symlink: not followed
+    CHECK_FALSE(src.entries[2].dir);
+
+    CHECK(scan_directory(t.root + "/README").error == ENOTDIR);
+    CHECK(scan_directory(t.root + "/missing").error == ENOENT);
+}
+
+TEST_CASE("dir scan: join", "[dir_scan]") {
+    CHECK(join("/", "etc") == "/etc");
+    CHECK(join("/usr", "lib") == "/usr/lib");
+    CHECK(join("a/", "b") == "a/b");
+}
+
+TEST_CASE("dir scan: scanner prefetches the next level and caches", "[dir_scan]") {
+    TempTree t;
+    ThreadPool pool(2);
+    DirScanner scanner(pool);
+    REQUIRE(scanner.open());
+
+    CHECK(scanner.find(t.root) == nullptr);
+    auto root = scanner.wait(t.root, true);
+    REQUIRE(root);
+    CHECK(root->entries.size() == 4);
+
+    pool.wait_idle();
+    auto src = scanner.find(t.root + "/src");        // prefetched
+    REQUIRE(src);
+    CHECK(src->entries.size() == 3);
+    CHECK(scanner.find(t.root + "/docs"));
+    CHECK(scanner.find(t.root + "/src/lib") == nullptr);   // one level only
+
+    CHECK(poll_readable(scanner.fd(), 0));
+    scanner.drain();
+    CHECK_FALSE(poll_readable(scanner.fd(), 0));
+
+    scanner.request(t.root + "/docs", false);         // cached: no new scan
+    pool.wait_idle();
+    CHECK_FALSE(poll_readable(scanner.fd(), 0));
+
+    scanner.request(t.root + "/src", true);           // cached, prefetches lib
+    pool.wait_idle();
+    CHECK(poll_readable(scanner.fd(), 0));
+    CHECK(scanner.find(t.root + "/src") == src);
+    CHECK(scanner.find(t.root + "/src/lib"));
+}
@@ -0,0 +1,95 @@
+/**
+ * test_entry_filter.cpp
+ *
+ * Unit tests for newt_entry_filter.hpp — the filter specs of
+ * EntrySetNativeFilter and how keys are accepted, folded or rejected.
+ */
+
+#include "newt_entry_filter.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+
+using newt_entry_filter::NativeFilter;
+
+static NativeFilter compile(const std::string& spec) {
+    NativeFilter f;
+    std::string error;
+    REQUIRE(f.parse(spec, error));
+    return f;
+}
+
+TEST_CASE("entry filter: character classes", "[entry_filter]") {
+    NativeFilter digits = compile("digits");
+    CHECK(digits.apply('7', "") == '7');
+    CHECK(digits.apply('a', "") == 0);
+    CHECK(digits.apply(' ', "") == 0);
+
+    NativeFilter host = compile("hostname");
+    for (char c : std::string("aZ09-."))
+        CHECK(host.apply(c, "") == c);
+    CHECK(host.apply('_', "") == 0);
+    CHECK(host.apply(0xC3, "") == 0);                  // no utf8 class
+
+    NativeFilter both = compile("digits,space");
+    CHECK(both.apply(' ', "") == ' ');
+    CHECK(both.apply('5', "") == '5');
+
+    NativeFilter hex = compile("hex");
+    CHECK(hex.apply('F', "") == 'F');
+    CHECK(hex.apply('g', "") == 0);
+}
+
+TEST_CASE("entry filter: chars takes the rest of the spec", "[entry_filter]") {
+    NativeFilter f = compile("max:3,chars:a-c,_");
+    CHECK(f.apply('b', "") == 'b');
+    CHECK(f.apply(',', "") == ',');
+    CHECK(f.apply('_', "") == '_');
+    CHECK(f.apply('d', "") == 0);
+    CHECK(f.apply('a', "abc") == 0);                   // max still applies
+}
+
+TEST_CASE("entry filter: length, folding and non-insert keys", "[entry_filter]") {
+    NativeFilter f = compile("max:2");
+    CHECK(f.apply('x', "a") == 'x');
+    CHECK(f.apply('x', "ab") == 0);
+    CHECK(f.apply(0xC3, "\xC3\xA9") == 0xC3);          // one character so far
+    CHECK(f.apply(0xA9, "ab") == 0xA9);                // continuation of a started char
+    CHECK(NativeFilter::length("h\xC3\xA9") == 2);
+
+    NativeFilter up = compile("hex,upper");
+    CHECK(up.apply('a', "") == 'A');
+    CHECK(up.apply('g', "") == 0);
+    NativeFilter low = compile("alpha,lower");
+    CHECK(low.apply('Q', "") == 'q');
+
+    NativeFilter d = compile("digits,max:1");
+    CHECK(d.apply('\t', "1") == '\t');
+    CHECK(d.apply('\b', "1") == '\b');
+    CHECK(d.apply(0x7f, "1") == 0x7f);
+    CHECK(d.apply(0x8000 + 6, "1") == 0x8000 + 6);     // NEWT_KEY_BKSPC
+}
+
+TEST_CASE("entry filter: bad specs", "[entry_filter]") {
+    NativeFilter f;
+    std::string error;
+    CHECK_FALSE(f.parse("digits,bogus", error));
+    CHECK(error == "bogus");
+    CHECK_FALSE(f.parse("max:", error));
+    CHECK_FALSE(f.parse("max:x1", error));
+    CHECK(error == "max:x1");
+    CHECK(f.parse("", error));                         // allows everything
+    CHECK(f.apply('%', "") == '%');
+}
+
+TEST_CASE("entry filter: pasted text is filtered as a whole", "[entry_filter]") {
+    NativeFilter f = compile("digits,max:6");
+    CHECK(f.filter_text("12", "3a4-5 6789") == "3456");
+    CHECK(f.filter_text("123456", "7") == "");
+
+    NativeFilter host = compile("hostname,lower");
+    CHECK(host.filter_text("", "My_Host.Example\t") == "myhost.example");
+
+    NativeFilter u = compile("utf8,alpha,max:2");
+    CHECK(u.filter_text("", "\xC3\xA9t\xC3\xA9") == "\xC3\xA9t");
+}
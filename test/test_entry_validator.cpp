@@ -0,0 +1,50 @@
+/**
+ * test_entry_validator.cpp
+ *
+ * Unit tests for newt_entry_validator.hpp — the compiled rules checked by
+ * FormValidate.
+ */
+
+#include "newt_entry_validator.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+
+TEST_CASE("entry validator: anchored and unanchored patterns", "[entry_validator]") {
+    EntryValidator port;
+    std::string error;
+    REQUIRE(port.compile("^[0-9]{1,5}$", "port must be a number", error));
+    CHECK(port.check("8080"));
+    CHECK_FALSE(port.check("80a"));
+    CHECK_FALSE(port.check(""));
+    CHECK_FALSE(port.check("123456"));
+    CHECK(port.message() == "port must be a number");
+
+    EntryValidator at;
+    REQUIRE(at.compile("@", "", error));
+    CHECK(at.check("user@example.org"));                // like [[ =~ ]]: anywhere
+    CHECK_FALSE(at.check("user"));
+    CHECK(at.message() == "does not match @");
+    CHECK(at.pattern() == "@");
+}
+
+TEST_CASE("entry validator: POSIX extended syntax", "[entry_validator]") {
+    EntryValidator v;
+    std::string error;
+    REQUIRE(v.compile("^(yes|no)$", "", error));
+    CHECK(v.check("no"));
+    CHECK_FALSE(v.check("maybe"));
+    REQUIRE(v.compile("^[[:alpha:]]+$", "", error));
+    CHECK(v.check("abc"));
+    CHECK_FALSE(v.check("ab1"));
+}
+
+TEST_CASE("entry validator: a bad pattern keeps the old rule", "[entry_validator]") {
+    EntryValidator v;
+    std::string error;
+    REQUIRE(v.compile("^a$", "", error));
+    CHECK_FALSE(v.compile("(", "", error));
+    CHECK_FALSE(error.empty());
+    CHECK(v.pattern() == "^a$");
+    CHECK(v.check("a"));
+}
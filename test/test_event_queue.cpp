@@ -0,0 +1,62 @@
+/**
+ * test_event_queue.cpp
+ *
+ * Unit tests for newt_event_queue.hpp — the ring of callback events handed
+ * to bash in batches by EventsDrain.
+ */
+
+#include "stubs/fixtures.hpp"
+#include "newt_event_queue.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+
+TEST_CASE("event queue: events come back in order and the pipe follows", "[event_queue]") {
+    EventQueue q(8);
+    REQUIRE(q.open());
+    CHECK_FALSE(poll_readable(q.fd(), 0));
+
+    int a = 0, b = 0;
+    q.push(EventQueue::Type::Callback, &a, "first");
+    CHECK(poll_readable(q.fd(), 0));
+    q.push(EventQueue::Type::Destroy, &b, "");
+    CHECK(q.size() == 2);
+
+    auto ev = q.take();
+    REQUIRE(ev.size() == 2);
+    CHECK(ev[0].type == EventQueue::Type::Callback);
+    CHECK(ev[0].co == &a);
+    CHECK(ev[0].data == "first");
+    CHECK(ev[1].type == EventQueue::Type::Destroy);
+    CHECK(ev[1].co == &b);
+    CHECK(q.size() == 0);
+    CHECK_FALSE(poll_readable(q.fd(), 0));
+    CHECK(q.take().empty());
+}
+
+TEST_CASE("event queue: a full ring drops the oldest events", "[event_queue]") {
+    EventQueue q(3);
+    for (int i = 0; i < 5; ++i)
+        q.push(EventQueue::Type::Callback, nullptr, std::to_string(i));
+    CHECK(q.size() == 3);
+    CHECK(q.take_dropped() == 2);
+    CHECK(q.take_dropped() == 0);
+
+    auto ev = q.take();
+    REQUIRE(ev.size() == 3);
+    CHECK(ev[0].data == "2");
+    CHECK(ev[2].data == "4");
+
+    q.push(EventQueue::Type::Callback, nullptr, "again");      // wraps around
+    ev = q.take();
+    REQUIRE(ev.size() == 1);
+    CHECK(ev[0].data == "again");
+}
+
+TEST_CASE("event queue: works without a pipe", "[event_queue]") {
+    EventQueue q;
+    CHECK(q.fd() < 0);
+    CHECK(q.capacity() == 4096);
+    q.push(EventQueue::Type::Callback, nullptr, "x");
+    CHECK(q.take().size() == 1);
+}
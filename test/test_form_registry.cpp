@@ -0,0 +1,124 @@
+/**
+ * test_form_registry.cpp
+ *
+ * Unit tests for FormRegistry (newt_form_registry.hpp) — component kinds,
+ * form membership and change tracking behind FormCollect and FormGetChanged.
+ */
+
+#include "newt_form_registry.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <map>
+#include <string>
+#include <vector>
+
+using Kind = FormRegistry::Kind;
+
+// Distinct fake handles; the registry never dereferences them.
+static int h[8];
+static const void* F  = &h[0];
+static const void* E  = &h[1];
+static const void* R1 = &h[2];
+static const void* R2 = &h[3];
+static const void* R3 = &h[4];
+static const void* L  = &h[5];
+static const void* X  = &h[6];
+
+static std::vector<const void*> field_handles(const FormRegistry& r, const void* form) {
+    std::vector<const void*> v;
+    for (const auto& f : r.fields(form)) v.push_back(f.co);
+    return v;
+}
+
+TEST_CASE("FormRegistry: members keep add order and skip unknown components", "[FormRegistry]") {
+    FormRegistry r;
+    r.created(E, Kind::Entry);
+    r.created(L, Kind::Listbox);
+    r.added(F, L);
+    r.added(F, X);   // not created through the builtin
+    r.added(F, E);
+    r.added(F, L);   // repeated add
+    CHECK(r.members(F) == std::vector<const void*>{ L, E });
+    CHECK(r.find(E)->form == F);
+    CHECK(r.members(X).empty());
+}
+
+TEST_CASE("FormRegistry: a radio group is one field keyed by its first button", "[FormRegistry]") {
+    FormRegistry r;
+    r.created(E, Kind::Entry);
+    r.created(R1, Kind::Radio, nullptr);
+    r.created(R2, Kind::Radio, R1);
+    r.created(R3, Kind::Radio, R2);
+    CHECK(r.find(R3)->group == R1);
+
+    r.added(F, R2);
+    r.added(F, E);
+    r.added(F, R1);
+    r.added(F, R3);
+    CHECK(field_handles(r, F) == std::vector<const void*>{ R1, E });
+    CHECK(r.fields(F)[0].info->kind == Kind::Radio);
+}
+
+TEST_CASE("FormRegistry: destroying components and forms", "[FormRegistry]") {
+    FormRegistry r;
+    r.created(E, Kind::Entry);
+    r.created(L, Kind::Listbox);
+    r.added(F, E);
+    r.added(F, L);
+    r.find(E)->id = "name";
+
+    r.destroyed(E);
+    CHECK(r.find(E) == nullptr);
+    CHECK(r.members(F) == std::vector<const void*>{ L });
+
+    r.destroyed(F);
+    CHECK(r.members(F).empty());
+    REQUIRE(r.find(L));
+    CHECK(r.find(L)->form == nullptr);
+}
+
+TEST_CASE("FormRegistry: moving a component to another form", "[FormRegistry]") {
+    FormRegistry r;
+    r.created(E, Kind::Entry);
+    r.added(F, E);
+    r.added(X, E);
+    CHECK(r.members(F).empty());
+    CHECK(r.members(X) == std::vector<const void*>{ E });
+}
+
+TEST_CASE("FormRegistry: only touched fields whose value moved are changed", "[FormRegistry]") {
+    FormRegistry r;
+    r.created(E, Kind::Entry);
+    r.created(L, Kind::Listbox);
+    r.created(R1, Kind::Radio, nullptr);
+    r.created(R2, Kind::Radio, R1);
+    for (const void* co : { E, L, R1, R2 }) r.added(F, co);
+
+    std::map<const void*, std::string> values = { { E, "a" }, { L, "1" }, { R1, "x" } };
+    int reads = 0;
+    auto value = [&](const void* co, const FormRegistry::Component&) {
+        ++reads;
+        return values[co];
+    };
+
+    r.run_started(F, value);
+    CHECK(reads == 3);                         // E, L and the radio group
+    values[E] = "ab";
+    values[L] = "2";
+    r.touch(L);
+    reads = 0;
+    CHECK(r.run_finished(F, E, value) == std::vector<const void*>{ E, L });
+    CHECK(reads == 2);                         // untouched radio group not read
+
+    // Second run: baseline is the end of the first; touching without a
+    // change reports nothing, a radio button reports its group.
+    r.run_started(F, value);
+    r.touch(L);
+    values[R1] = "y";
+    r.touch(R2);
+    CHECK(r.run_finished(F, nullptr, value) == std::vector<const void*>{ R1 });
+    CHECK(r.changed(F) == std::vector<const void*>{ R1 });
+
+    r.destroyed(R1);
+    CHECK(r.changed(F).empty());
+}
@@ -0,0 +1,57 @@
+/**
+ * test_form_snapshot.cpp
+ *
+ * Unit tests for the FormSnapshot text encoding (newt_form_snapshot.hpp).
+ */
+
+#include "newt_form_snapshot.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using newt_form_snapshot::Record;
+using newt_form_snapshot::decode;
+using newt_form_snapshot::encode;
+
+TEST_CASE("form snapshot: records round-trip", "[FormSnapshot]") {
+    std::vector<Record> in = {
+        { 'F', { "2", "3" } },
+        { 'E', { "tab\there, 100%\nnext line\r", "7" } },
+        { 'C', { "*" } },
+        { 'L', { "42", "" } },
+        { 'T', { "5", "1=a 3=b" } },
+        { 'S', {} },
+    };
+    std::string s = encode(in);
+    CHECK(s.find('\t') != std::string::npos);
+    CHECK(std::count(s.begin(), s.end(), '\n') == 6);
+
+    std::vector<Record> out;
+    REQUIRE(decode(s, out));
+    REQUIRE(out.size() == in.size());
+    for (std::size_t i = 0; i < in.size(); ++i) {
+        CHECK(out[i].tag == in[i].tag);
+        CHECK(out[i].values == in[i].values);
+    }
+}
+
+TEST_CASE("form snapshot: empty form", "[FormSnapshot]") {
+    std::vector<Record> out = { { 'X', {} } };
+    REQUIRE(decode(encode({}), out));
+    CHECK(out.empty());
+}
+
+TEST_CASE("form snapshot: rejects foreign or damaged strings", "[FormSnapshot]") {
+    std::vector<Record> out;
+    CHECK_FALSE(decode("", out));
+    CHECK_FALSE(decode("hello", out));
+    CHECK_FALSE(decode("newt-snapshot 2\nC\t*", out));
+    CHECK_FALSE(decode("newt-snapshot 1\n\nC\t*", out));
+    CHECK_FALSE(decode("newt-snapshot 1\nE\tbad%2", out));
+    CHECK_FALSE(decode("newt-snapshot 1\nE\tbad%zz\t1", out));
+    CHECK_FALSE(decode("newt-snapshot 1\nEx\t1", out));
+    CHECK(decode("newt-snapshot 1\nE\t%25%09\t1", out));
+    CHECK(out[0].values[0] == "%\t");
+}
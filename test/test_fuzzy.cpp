@@ -0,0 +1,149 @@
+/**
+ * test_fuzzy.cpp
+ *
+ * Unit tests for the header-only pieces behind FuzzyPicker:
+ *   • ThreadPool (newt_thread_pool.hpp).
+ *   • newt_fuzzy scoring and FuzzyMatcher (newt_fuzzy.hpp).
+ */
+
+#include "stubs/fixtures.hpp"
+#include "newt_fuzzy.hpp"
+#include "newt_thread_pool.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <fcntl.h>
+#include <signal.h>
+#include <string>
+#include <unistd.h>
+
+namespace fz = newt_fuzzy;
+
+static int sc(const std::string& s, const std::string& q) {
+    return fz::score(s.data(), s.size(), fz::prepare_query(q));
+}
+
+// Blocks until a byte arrives on 'fd' (or 5 s pass).
+static bool wait_readable(int fd) {
+    if (!poll_readable(fd, 5000)) return false;
+    char buf[64];
+    while (::read(fd, buf, sizeof(buf)) > 0) {}
+    return true;
+}
+
+// ─── ThreadPool ───────────────────────────────────────────────────────────────
+
+TEST_CASE("ThreadPool: runs every posted task", "[ThreadPool]") {
+    ThreadPool pool(4);
+    std::atomic<int> n{0};
+    for (int i = 0; i < 1000; ++i) pool.post([&n] { ++n; });
+    pool.wait_idle();
+    CHECK(n == 1000);
+}
+
+TEST_CASE("ThreadPool: workers block signals, the creator's mask is kept", "[ThreadPool]") {
+    sigset_t before, after;
+    pthread_sigmask(SIG_SETMASK, nullptr, &before);
+    ThreadPool pool(2);
+    pthread_sigmask(SIG_SETMASK, nullptr, &after);
+    CHECK(sigismember(&after, SIGCHLD) == sigismember(&before, SIGCHLD));
+    CHECK(sigismember(&after, SIGINT)  == sigismember(&before, SIGINT));
+
+    std::atomic<int> blocked{0};
+    pool.post([&blocked] {
+        sigset_t m;
+        pthread_sigmask(SIG_SETMASK, nullptr, &m);
+        blocked = sigismember(&m, SIGCHLD) && sigismember(&m, SIGINT) &&
+                  sigismember(&m, SIGWINCH);
+    });
+    pool.wait_idle();
+    CHECK(blocked == 1);
+}
+
+TEST_CASE("ThreadPool: zero workers is clamped to one", "[ThreadPool]") {
+    ThreadPool pool(0);
+    CHECK(pool.size() == 1);
+}
+
+// ─── score ────────────────────────────────────────────────────────────────────
+
+TEST_CASE("score: subsequence match, case-insensitive", "[Fuzzy]") {
+    CHECK(sc("FooBar", "fb") > 0);
+    CHECK(sc("foobar", "FOO") > 0);
+    CHECK(sc("foobar", "bf") < 0);
+    CHECK(sc("fo", "foo") < 0);
+}
+
+TEST_CASE("score: contiguous and word-start matches rank higher", "[Fuzzy]") {
+    CHECK(sc("xxabxx", "ab") > sc("xaxxbx", "ab"));
+    CHECK(sc("src/main.cpp", "main") > sc("xmainx", "main"));
+    CHECK(sc("FooBar", "fb") > sc("foobar", "fb"));
+}
+
+TEST_CASE("score: the tightest occurrence is scored", "[Fuzzy]") {
+    CHECK(sc("a_xxxxxx_ab", "ab") == sc("ab", "ab"));
+}
+
+// ─── FuzzyMatcher ─────────────────────────────────────────────────────────────
+
+TEST_CASE("FuzzyMatcher: run ranks best first and honours the limit", "[Fuzzy]") {
+    RowStore rows;
+    rows.assign_lines("libfoo-dev\nfoo\nbar\nxfxoxo\nfoobar\n");
+    fz::FuzzyMatcher m(rows, 3);
+
+    fz::Result r = m.run("foo");
+    CHECK(r.matches == 4);
+    REQUIRE(r.top.size() == 3);
+    CHECK(r.top[0] == 1);          // "foo": exact, shortest
+    CHECK(r.top[1] == 4);          // "foobar"
+}
+
+TEST_CASE("FuzzyMatcher: empty query keeps the original order", "[Fuzzy]") {
+    RowStore rows;
+    rows.assign_lines("c\nbb\na\n");
+    fz::FuzzyMatcher m(rows, 10);
+    fz::Result r = m.run("");
+    CHECK(r.matches == 3);
+    CHECK(r.top == std::vector<std::uint32_t>{0, 1, 2});
+}
+
+TEST_CASE("FuzzyMatcher: threaded run agrees with the synchronous one", "[Fuzzy]") {
+    RowStore rows;
+    for (int i = 0; i < 50000; ++i)
+        rows.push_back(("pkg-" + std::to_string(i) + (i % 7 ? "-lib" : "-tool")).c_str());
+    fz::FuzzyMatcher m(rows, 50);
+    ThreadPool pool(4);
+
+    int fds[2];
+    REQUIRE(::pipe2(fds, O_NONBLOCK) == 0);
+
+    std::uint64_t gen = m.start(pool, "ptool", fds[1]);
+    REQUIRE(wait_readable(fds[0]));
+    fz::Result async;
+    REQUIRE(m.take(async));
+    CHECK(async.generation == gen);
+
+    fz::Result sync = m.run("ptool");
+    CHECK(async.matches == sync.matches);
+    CHECK(async.top == sync.top);
+
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
+
+TEST_CASE("FuzzyMatcher: a newer run supersedes an older one", "[Fuzzy]") {
+    RowStore rows;
+    for (int i = 0; i < 100000; ++i) rows.push_back(("row " + std::to_string(i)).c_str());
+    fz::FuzzyMatcher m(rows, 10);
+    ThreadPool pool(2);
+
+    m.start(pool, "r1", -1);
+    std::uint64_t gen = m.start(pool, "99999", -1);
+    m.wait();
+
+    fz::Result r;
+    REQUIRE(m.take(r));
+    CHECK(r.generation == gen);
+    REQUIRE_FALSE(r.top.empty());
+    CHECK(std::string(rows[r.top[0]]) == "row 99999");
+}
@@ -0,0 +1,106 @@
+/**
+ * test_line_index.cpp
+ *
+ * Unit tests for the header-only pieces behind TextboxLoadFile:
+ *   • LineIndex (newt_line_index.hpp) — lazy sparse line index.
+ *   • MappedFile (newt_mapped_file.hpp) — RAII read-only mmap.
+ */
+
+#include "stubs/fixtures.hpp"
+#include "newt_line_index.hpp"
+#include "newt_mapped_file.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <unistd.h>
+
+// Text of line n as seen through the index.
+static std::string line_at(LineIndex& idx, const std::string& buf, std::size_t n) {
+    std::size_t s = idx.line_start(n);
+    if (s == LineIndex::npos) return "<none>";
+    return buf.substr(s, idx.line_end(s) - s);
+}
+
+// ─── LineIndex ────────────────────────────────────────────────────────────────
+
+TEST_CASE("LineIndex: empty buffer has no lines", "[LineIndex]") {
+    LineIndex idx;
+    idx.reset("", 0);
+    CHECK(idx.complete());
+    CHECK(idx.line_count() == 0);
+    CHECK(idx.line_start(0) == LineIndex::npos);
+}
+
+TEST_CASE("LineIndex: trailing newline does not add a line", "[LineIndex]") {
+    std::string buf = "a\nbb\n\nd\n";
+    LineIndex idx;
+    idx.reset(buf.data(), buf.size());
+    CHECK(idx.line_count() == 4);
+    CHECK(line_at(idx, buf, 0) == "a");
+    CHECK(line_at(idx, buf, 1) == "bb");
+    CHECK(line_at(idx, buf, 2) == "");
+    CHECK(line_at(idx, buf, 3) == "d");
+    CHECK(line_at(idx, buf, 4) == "<none>");
+}
+
+TEST_CASE("LineIndex: unterminated last line is counted", "[LineIndex]") {
+    std::string buf = "x\ny";
+    LineIndex idx;
+    idx.reset(buf.data(), buf.size());
+    CHECK(line_at(idx, buf, 1) == "y");
+    CHECK(idx.line_count() == 2);
+}
+
+TEST_CASE("LineIndex: scans lazily and resolves lines across checkpoints", "[LineIndex]") {
+    std::string buf;
+    for (int i = 0; i < 1000; ++i) buf += "line " + std::to_string(i) + "\n";
+    LineIndex idx;
+    idx.reset(buf.data(), buf.size());
+
+    CHECK(line_at(idx, buf, 3) == "line 3");
+    CHECK_FALSE(idx.complete());
+
+    CHECK(line_at(idx, buf, LineIndex::STRIDE)     == "line 64");
+    CHECK(line_at(idx, buf, LineIndex::STRIDE + 5) == "line 69");
+    CHECK(line_at(idx, buf, 999) == "line 999");
+    CHECK(line_at(idx, buf, 10)  == "line 10");   // going back is fine
+    CHECK(idx.line_count() == 1000);
+}
+
+// ─── MappedFile ───────────────────────────────────────────────────────────────
+
+TEST_CASE("MappedFile: maps file contents", "[MappedFile]") {
+    TempDir d;
+    const char text[] = "hello\nworld\n";
+    std::string path = d.file("f", text);
+
+    MappedFile mf;
+    REQUIRE(mf.open(path.c_str()));
+    CHECK(mf.size() == sizeof(text) - 1);
+    CHECK(std::string(mf.data(), mf.size()) == text);
+    mf.close();
+    CHECK(mf.data() == nullptr);
+}
+
+TEST_CASE("MappedFile: a truncated file is noticed and remapped", "[MappedFile]") {
+    TempDir d;
+    std::string path = d.file("f", "hello\nworld\n");
+
+    MappedFile mf;
+    REQUIRE(mf.open(path.c_str()));
+    CHECK_FALSE(mf.shrunk());
+    REQUIRE(::truncate(path.c_str(), 6) == 0);
+    CHECK(mf.shrunk());
+    REQUIRE(mf.remap());
+    CHECK_FALSE(mf.shrunk());
+    CHECK(std::string(mf.data(), mf.size()) == "hello\n");
+    REQUIRE(::truncate(path.c_str(), 0) == 0);
+    REQUIRE(mf.remap());
+    CHECK(mf.size() == 0);
+    CHECK(mf.data() == nullptr);
+}
+
+TEST_CASE("MappedFile: missing file → false", "[MappedFile]") {
+    MappedFile mf;
+    CHECK_FALSE(mf.open("/nonexistent/newt/file"));
+}
@@ -0,0 +1,91 @@
+/**
+ * test_listbox_filter.cpp
+ *
+ * Unit tests for newt_listbox_filter.hpp — the substring matcher and entry
+ * edit prediction behind ListboxFilterBind.
+ */
+
+#include "newt_listbox_filter.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+
+namespace lf = newt_listbox_filter;
+
+static bool has(const std::string& hay, const std::string& q, bool fold) {
+    return lf::contains(hay.data(), hay.size(), lf::prepare_query(q, fold), fold);
+}
+
+// ─── contains ─────────────────────────────────────────────────────────────────
+
+TEST_CASE("contains: case-sensitive substring search", "[ListboxFilter]") {
+    CHECK(has("web-01.example.com", "", false));
+    CHECK(has("web-01.example.com", "web", false));
+    CHECK(has("web-01.example.com", "com", false));
+    CHECK(has("web-01.example.com", "01.ex", false));
+    CHECK_FALSE(has("web-01.example.com", "WEB", false));
+    CHECK_FALSE(has("web", "web-01", false));
+    CHECK_FALSE(has("", "a", false));
+}
+
+TEST_CASE("contains: repeated first byte is retried", "[ListboxFilter]") {
+    CHECK(has("aaab", "aab", false));
+    CHECK(has("xxaxaxab", "ab", false));
+    CHECK_FALSE(has("aaaa", "ab", false));
+}
+
+TEST_CASE("contains: ASCII case folding", "[ListboxFilter]") {
+    CHECK(has("Web-01.Example.COM", "example.com", true));
+    CHECK(has("Web-01.Example.COM", "EXAMPLE", true));
+    CHECK(has("wEb", "WeB", true));
+    CHECK(has("AxaB", "ab", true));          // upper-case candidate after a miss
+    CHECK(has("12-34", "2-3", true));        // non-letter first byte
+    CHECK_FALSE(has("Example", "examplex", true));
+}
+
+TEST_CASE("contains: non-ASCII bytes compare exactly", "[ListboxFilter]") {
+    CHECK(has("caf\xc3\xa9 bar", "\xc3\xa9", true));
+    CHECK_FALSE(has("CAF\xc3\x89", "caf\xc3\xa9", true));
+}
+
+// ─── match_all / match_subset ─────────────────────────────────────────────────
+
+TEST_CASE("match_all and match_subset select ascending row indices", "[ListboxFilter]") {
+    RowStore rows;
+    rows.assign_lines("alpha\nbeta\ngamma\ndelta\nepsilon\n");
+
+    std::vector<std::uint32_t> all, sub;
+    lf::match_all(rows, "a", false, all);
+    CHECK(all == std::vector<std::uint32_t>{0, 1, 2, 3});
+
+    lf::match_subset(rows, "ta", false, all, sub);
+    CHECK(sub == std::vector<std::uint32_t>{1, 3});
+
+    lf::match_all(rows, "", false, all);
+    CHECK(all.size() == 5);
+}
+
+// ─── predict_edit ─────────────────────────────────────────────────────────────
+
+TEST_CASE("predict_edit: insertion and deletion at the cursor", "[ListboxFilter]") {
+    using lf::EditOp;
+    CHECK(lf::predict_edit("wb", 1, EditOp::Insert, 'e') == "web");
+    CHECK(lf::predict_edit("web", 3, EditOp::Backspace) == "we");
+    CHECK(lf::predict_edit("web", 0, EditOp::Backspace) == "web");
+    CHECK(lf::predict_edit("web", 0, EditOp::Delete) == "eb");
+    CHECK(lf::predict_edit("web", 3, EditOp::Delete) == "web");
+    CHECK(lf::predict_edit("web", 1, EditOp::KillToEnd) == "w");
+    CHECK(lf::predict_edit("web", 1, EditOp::KillToStart) == "eb");
+    CHECK(lf::predict_edit("web", 2, EditOp::None) == "web");
+}
+
+TEST_CASE("predict_edit: multi-byte characters are deleted whole", "[ListboxFilter]") {
+    using lf::EditOp;
+    CHECK(lf::predict_edit("caf\xc3\xa9", 5, EditOp::Backspace) == "caf");
+    CHECK(lf::predict_edit("\xc3\xa9t\xc3\xa9", 0, EditOp::Delete) == "t\xc3\xa9");
+}
+
+TEST_CASE("predict_edit: out-of-range cursor is clamped", "[ListboxFilter]") {
+    CHECK(lf::predict_edit("ab", 99, lf::EditOp::Insert, 'c') == "abc");
+    CHECK(lf::predict_edit("ab", -1, lf::EditOp::Insert, 'c') == "cab");
+}
@@ -0,0 +1,86 @@
+/**
+ * test_listbox_sort.cpp
+ *
+ * Unit tests for newt_listbox_sort.hpp and parallel_stable_sort
+ * (newt_thread_pool.hpp) — the ordering behind ListboxSort.
+ */
+
+#include "newt_listbox_sort.hpp"
+#include "newt_thread_pool.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ls = newt_listbox_sort;
+
+static std::vector<std::string> sort_texts(std::vector<const char*> texts, ls::Key key,
+                                           bool desc = false) {
+    ThreadPool pool(2);
+    std::vector<void*> data(texts.size(), nullptr);
+    std::vector<std::string> out;
+    for (std::uint32_t i : ls::sorted_order(texts, data, key, desc, pool))
+        out.push_back(texts[i]);
+    return out;
+}
+
+// ─── natural_compare ──────────────────────────────────────────────────────────
+
+TEST_CASE("natural_compare: digit runs compare by value", "[ListboxSort]") {
+    CHECK(ls::natural_compare("file9", "file10") < 0);
+    CHECK(ls::natural_compare("file10", "file9") > 0);
+    CHECK(ls::natural_compare("a2b10", "a2b9") > 0);
+    CHECK(ls::natural_compare("abc", "abc") == 0);
+    CHECK(ls::natural_compare("abc", "abcd") < 0);
+    CHECK(ls::natural_compare("x", "1") > 0);          // byte order outside numbers
+}
+
+TEST_CASE("natural_compare: leading zeros only break ties", "[ListboxSort]") {
+    CHECK(ls::natural_compare("v007", "v8") < 0);
+    CHECK(ls::natural_compare("7", "07") < 0);
+    CHECK(ls::natural_compare("07", "7") > 0);
+}
+
+// ─── sorted_order ─────────────────────────────────────────────────────────────
+
+TEST_CASE("sorted_order: text and natural orders", "[ListboxSort]") {
+    std::vector<const char*> t = { "host10", "host2", "Host1", "host1" };
+    CHECK(sort_texts(t, ls::Key::Text) ==
+          std::vector<std::string>{ "Host1", "host1", "host10", "host2" });
+    CHECK(sort_texts(t, ls::Key::TextNumeric) ==
+          std::vector<std::string>{ "Host1", "host1", "host2", "host10" });
+    CHECK(sort_texts(t, ls::Key::TextNumeric, true) ==
+          std::vector<std::string>{ "host10", "host2", "host1", "Host1" });
+}
+
+TEST_CASE("sorted_order: data keys, stable in both directions", "[ListboxSort]") {
+    ThreadPool pool(2);
+    std::vector<const char*> t = { "a", "b", "c", "d" };
+    std::vector<void*> d = { reinterpret_cast<void*>(2), reinterpret_cast<void*>(1),
+                             reinterpret_cast<void*>(2), reinterpret_cast<void*>(1) };
+    CHECK(ls::sorted_order(t, d, ls::Key::Data, false, pool) ==
+          std::vector<std::uint32_t>{ 1, 3, 0, 2 });
+    CHECK(ls::sorted_order(t, d, ls::Key::Data, true, pool) ==
+          std::vector<std::uint32_t>{ 0, 2, 1, 3 });
+}
+
+// ─── parallel_stable_sort ─────────────────────────────────────────────────────
+
+TEST_CASE("parallel_stable_sort: matches std::stable_sort", "[ListboxSort]") {
+    ThreadPool pool(4);
+    std::vector<std::pair<int, int>> v;
+    std::uint32_t x = 12345;
+    for (int i = 0; i < 200000; ++i) {
+        x = x * 1103515245u + 12345u;
+        v.emplace_back(static_cast<int>((x >> 16) % 1000), i);
+    }
+    auto by_first = [](const std::pair<int, int>& a, const std::pair<int, int>& b) {
+        return a.first < b.first;
+    };
+    auto expect = v;
+    std::stable_sort(expect.begin(), expect.end(), by_first);
+    parallel_stable_sort(pool, v.begin(), v.end(), by_first, 1024);
+    CHECK(v == expect);
+}
@@ -0,0 +1,117 @@
+/**
+ * test_output_stats.cpp
+ *
+ * Unit tests for newt_output_stats.hpp — the counting pipe interposed on
+ * S-Lang's output fd and the per-frame figures behind OutputStats.
+ */
+
+#include "newt_output_stats.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <fcntl.h>
+#include <chrono>
+#include <csignal>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static std::string read_all_nonblocking(int fd) {
+    std::string out;
+    char buf[4096];
+    ssize_t n;
+    while ((n = ::read(fd, buf, sizeof(buf))) > 0) out.append(buf, static_cast<std::size_t>(n));
+    return out;
+}
+
+TEST_CASE("CountingPipe forwards and counts everything written", "[output_stats]") {
+    int term[2];
+    REQUIRE(::pipe(term) == 0);
+    ::fcntl(term[0], F_SETFL, O_NONBLOCK);
+
+    CountingPipe cp;
+    REQUIRE(cp.start(term[1]));
+    REQUIRE(cp.active());
+
+    std::string a(5000, 'x'), b = "\x1b[H\x1b[2Jhello";
+    REQUIRE(::write(cp.fd(), a.data(), a.size()) == static_cast<ssize_t>(a.size()));
+    CHECK(cp.total() == a.size());                 // exact before forwarding
+    REQUIRE(::write(cp.fd(), b.data(), b.size()) == static_cast<ssize_t>(b.size()));
+    cp.drain();
+    CHECK(cp.total() == a.size() + b.size());
+    CHECK(read_all_nonblocking(term[0]) == a + b);
+
+    std::string c = "tail";
+    REQUIRE(::write(cp.fd(), c.data(), c.size()) == 4);
+    cp.stop();                                     // forwards what is left
+    CHECK_FALSE(cp.active());
+    CHECK(read_all_nonblocking(term[0]) == c);
+
+    ::close(term[0]);
+    ::close(term[1]);
+}
+
+TEST_CASE("CountingPipe stops while a forked child holds the write end", "[output_stats]") {
+    int term[2];
+    REQUIRE(::pipe(term) == 0);
+    ::fcntl(term[0], F_SETFL, O_NONBLOCK);
+
+    CountingPipe cp;
+    REQUIRE(cp.start(term[1]));
+    pid_t child = ::fork();                        // like a coproc: no exec
+    REQUIRE(child >= 0);
+    if (child == 0) {
+        ::pause();
+        ::_exit(0);
+    }
+    REQUIRE(::write(cp.fd(), "bye", 3) == 3);
+    auto t0 = std::chrono::steady_clock::now();
+    cp.stop();
+    auto waited = std::chrono::steady_clock::now() - t0;
+    ::kill(child, SIGKILL);
+    ::waitpid(child, nullptr, 0);
+
+    CHECK(waited < std::chrono::seconds(1));
+    CHECK(read_all_nonblocking(term[0]) == "bye");
+    ::close(term[0]);
+    ::close(term[1]);
+}
+
+TEST_CASE("FrameStats: frames, maxima and idle bytes", "[output_stats]") {
+    FrameStats fs;
+    fs.reset(100);                                 // counter already at 100
+
+    fs.begin("Refresh", 150);                      // 50 idle bytes before
+    fs.end(190);
+    fs.begin("FormRun 0x1", 190);
+    fs.end(490);
+    fs.begin("DrawForm 0x2", 500);
+    fs.end(520);
+
+    CHECK(fs.bytes(520) == 420);
+    CHECK(fs.frames() == 3);
+    CHECK(fs.idle(520) == 60);
+    CHECK(fs.last() == 20);
+    CHECK(fs.last_label() == "DrawForm 0x2");
+    CHECK(fs.max() == 300);
+    CHECK(fs.max_label() == "FormRun 0x1");
+}
+
+TEST_CASE("FrameStats: nested frames belong to the outer one", "[output_stats]") {
+    FrameStats fs;
+    fs.reset(0);
+    fs.begin("FormRun 0x1", 0);
+    fs.begin("Refresh", 10);                       // from a callback
+    fs.end(30);
+    fs.end(80);
+    CHECK(fs.frames() == 1);
+    CHECK(fs.last() == 80);
+    CHECK(fs.last_label() == "FormRun 0x1");
+
+    fs.end(90);                                    // unbalanced end is ignored
+    CHECK(fs.frames() == 1);
+
+    fs.reset(90);
+    CHECK(fs.frames() == 0);
+    CHECK(fs.bytes(95) == 5);
+    CHECK(fs.max_label().empty());
+}
@@ -0,0 +1,69 @@
+/**
+ * test_palette.cpp
+ *
+ * Unit tests for newt_palette.hpp — colorset names, "fg,bg" values and the
+ * NEWT_COLORS file format read by PaletteLoad.
+ */
+
+#include "newt_palette.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+
+using namespace newt_palette;
+
+static const std::string& fg(const Palette& p, const char* name) { return p.fields[find_colorset(name)->fg]; }
+static const std::string& bg(const Palette& p, const char* name) { return p.fields[find_colorset(name)->bg]; }
+
+TEST_CASE("palette: colorsets cover every newtColors field once", "[palette]") {
+    bool seen[kFields] = {};
+    for (const auto& c : kColorsets) {
+        for (int f : { c.fg, c.bg }) {
+            if (f < 0) continue;
+            REQUIRE(f < kFields);
+            CHECK_FALSE(seen[f]);
+            seen[f] = true;
+        }
+    }
+    for (bool s : seen) CHECK(s);
+    CHECK(sizeof(kColorsets) / sizeof(kColorsets[0]) == 23);
+}
+
+TEST_CASE("palette: set_colorset", "[palette]") {
+    Palette p;
+    CHECK(set_colorset(p, "BUTTON", "black,red"));
+    CHECK(fg(p, "button") == "black");
+    CHECK(bg(p, "button") == "red");
+
+    CHECK(set_colorset(p, "actButton", ",blue"));         // bg only
+    CHECK(fg(p, "actbutton").empty());
+    CHECK(bg(p, "actbutton") == "blue");
+
+    CHECK(set_colorset(p, "emptyscale", "cyan"));
+    CHECK(bg(p, "emptyscale") == "cyan");
+    CHECK(set_colorset(p, "fullscale", ",green"));
+    CHECK(bg(p, "fullscale") == "green");
+
+    CHECK_FALSE(set_colorset(p, "buton", "black,red"));
+    CHECK_FALSE(set_colorset(p, "button", "black"));      // no bg half
+    CHECK_FALSE(set_colorset(p, "button", "a,b,c"));
+    CHECK_FALSE(set_colorset(p, "fullscale", "red,green"));
+}
+
+TEST_CASE("palette: parse_colors reads NEWT_COLORS syntax", "[palette]") {
+    Palette p;
+    std::string bad;
+    REQUIRE(parse_colors("root=white,blue:window=black,lightgray;\n"
+                         "  title=red,lightgray\tfullscale=,red\n", p, bad));
+    CHECK(fg(p, "root") == "white");
+    CHECK(bg(p, "window") == "lightgray");
+    CHECK(fg(p, "title") == "red");
+    CHECK(bg(p, "fullscale") == "red");
+    CHECK(fg(p, "border").empty());
+
+    CHECK(parse_colors("", p, bad));
+    CHECK_FALSE(parse_colors("root=white,blue border", p, bad));
+    CHECK(bad == "border");
+    CHECK_FALSE(parse_colors("nosuch=white,blue", p, bad));
+    CHECK(bad == "nosuch=white,blue");
+}
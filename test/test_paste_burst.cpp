@@ -0,0 +1,68 @@
+/**
+ * test_paste_burst.cpp
+ *
+ * Unit tests for newt_paste_burst.hpp — collecting a pasted run of keys
+ * and splicing the accepted text into an entry's value.
+ */
+
+#include "newt_paste_burst.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Keys buffered behind the one being filtered.
+struct Input {
+    std::vector<int> keys;
+    std::size_t      pos = 0;
+    std::vector<int> ungot;
+
+    explicit Input(std::vector<int> buffered = {}) : keys(std::move(buffered)) {}
+
+    std::string collect(int first, std::size_t max = 65536) {
+        return newt_paste::collect(
+            first,
+            [&] { return pos < keys.size(); },
+            [&] { return keys[pos++]; },
+            [&](int ch) { ungot.push_back(ch); },
+            max);
+    }
+};
+
+} // namespace
+
+TEST_CASE("paste burst: collects buffered text up to the first other key", "[paste_burst]") {
+    Input in{ { 'b', 'c', 0xC3, 0xA9, '\r', 'x' } };
+    CHECK(in.collect('a') == "abc\xC3\xA9");
+    REQUIRE(in.ungot.size() == 1);
+    CHECK(in.ungot[0] == '\r');
+    CHECK(in.pos == 5);                                // 'x' stays buffered
+}
+
+TEST_CASE("paste burst: a lone key and the size limit", "[paste_burst]") {
+    Input lone;
+    CHECK(lone.collect('q') == "q");
+    CHECK(lone.ungot.empty());
+
+    Input big{ { 'b', 'c', 'd', 'e' } };
+    CHECK(big.collect('a', 3) == "abc");
+    CHECK(big.pos == 2);
+    CHECK(big.ungot.empty());
+}
+
+TEST_CASE("paste burst: text keys and splicing", "[paste_burst]") {
+    using newt_paste::is_text;
+    CHECK(is_text(' '));
+    CHECK(is_text(0xA9));
+    CHECK_FALSE(is_text('\t'));
+    CHECK_FALSE(is_text(0x7f));
+    CHECK_FALSE(is_text(0x8000 + 1));                  // NEWT_KEY_UP
+
+    CHECK(newt_paste::splice("hello", 2, "XY") == "heXYllo");
+    CHECK(newt_paste::splice("hello", 5, "!") == "hello!");
+    CHECK(newt_paste::splice("hi", 99, "!") == "hi!");
+    CHECK(newt_paste::splice("", 0, "abc") == "abc");
+}
@@ -0,0 +1,86 @@
+/**
+ * test_progress_panel.cpp
+ *
+ * Unit tests for newt_progress_panel.hpp — update lines, line reassembly,
+ * change tracking between frames and the panel layout.
+ */
+
+#include "newt_progress_panel.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <vector>
+
+using namespace newt_progress;
+
+TEST_CASE("progress panel: parse_update", "[progress_panel]") {
+    Update u;
+    REQUIRE(parse_update("db 42", u));
+    CHECK(u.job == "db");
+    CHECK(u.permille == 420);
+    CHECK_FALSE(u.has_message);
+
+    REQUIRE(parse_update("  web-1\t12.5%  copying  files \r", u));
+    CHECK(u.job == "web-1");
+    CHECK(u.permille == 125);
+    CHECK(u.has_message);
+    CHECK(u.message == "copying  files");
+
+    REQUIRE(parse_update("x 150", u));
+    CHECK(u.permille == 1000);
+    REQUIRE(parse_update("x -3 ", u));
+    CHECK(u.permille == 0);
+    CHECK_FALSE(u.has_message);
+
+    CHECK_FALSE(parse_update("", u));
+    CHECK_FALSE(parse_update("db", u));
+    CHECK_FALSE(parse_update("db abc", u));
+    CHECK_FALSE(parse_update("db 4x2 msg", u));
+    CHECK_FALSE(parse_update("db % msg", u));
+}
+
+TEST_CASE("progress panel: LineBuffer", "[progress_panel]") {
+    LineBuffer lb(8);
+    std::vector<std::string> lines;
+    auto on = [&](const std::string& l) { lines.push_back(l); };
+    lb.feed("a 1\nb ", 6, on);
+    lb.feed("2\n", 2, on);
+    lb.feed("0123456789\nc 3\n", 15, on);              // over-long line dropped
+    CHECK(lines == std::vector<std::string>{ "a 1", "b 2", "c 3" });
+}
+
+TEST_CASE("progress panel: model coalesces changes between frames", "[progress_panel]") {
+    ProgressModel m({ "a", "b", "c" });
+    Update u;
+    for (const char* l : { "b 10", "b 20 copying", "a 5", "b 30", "zz 50" }) {
+        REQUIRE(parse_update(l, u));
+        m.apply(u);
+    }
+    CHECK(m.take_dirty() == std::vector<std::size_t>{ 1, 0 });
+    CHECK(m[1].permille == 300);
+    CHECK(m[1].message == "copying");
+    CHECK(m.take_dirty().empty());
+
+    REQUIRE(parse_update("a 5", u));                  // no change
+    CHECK(m.apply(u));
+    REQUIRE(parse_update("zz 5", u));
+    CHECK_FALSE(m.apply(u));
+    CHECK(m.take_dirty().empty());
+}
+
+TEST_CASE("progress panel: layout and fit_columns", "[progress_panel]") {
+    Layout l = panel_layout(60, { "db", "webserver" });
+    CHECK(l.id_width == 9);
+    CHECK(l.id_width + 1 + l.scale_width + 1 + l.message_width == 60);
+    CHECK(l.scale_width > l.message_width);
+
+    Layout narrow = panel_layout(20, { "a-very-long-job-name" });
+    CHECK(narrow.id_width == 5);
+    CHECK(narrow.message_width == 0);
+    CHECK(narrow.id_width + 1 + narrow.scale_width == 20);
+
+    CHECK(fit_columns("ok", 4) == "ok  ");
+    CHECK(fit_columns("abcdef", 4) == "abcd");
+    CHECK(fit_columns("\xc3\xa9t\xc3\xa9!", 3) == "\xc3\xa9t\xc3\xa9");
+    CHECK(fit_columns("a\tb", 3) == "a b");
+}
@@ -0,0 +1,62 @@
+/**
+ * test_screen_dump.cpp
+ *
+ * Unit tests for newt_screen_dump.hpp — row text, alternate-character-set
+ * mapping and colour runs returned by ScreenDump.
+ */
+
+#include "newt_screen_dump.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <string>
+
+using newt_screen_dump::RowBuilder;
+
+static void put(RowBuilder& row, const char* text, unsigned color, bool acs = false) {
+    for (const char* p = text; *p; ++p) {
+        std::uint32_t c = static_cast<unsigned char>(*p);
+        row.cell(&c, 1, color, acs);
+    }
+}
+
+TEST_CASE("screen dump: text drops trailing blanks only", "[screen_dump]") {
+    RowBuilder row;
+    put(row, "  ok  go   ", 2);
+    CHECK(row.text() == "  ok  go");
+    row.clear();
+    put(row, "     ", 2);
+    CHECK(row.text().empty());
+    CHECK(row.runs() == "2:5");
+}
+
+TEST_CASE("screen dump: colour runs cover every column", "[screen_dump]") {
+    RowBuilder row;
+    put(row, "  ", 2);
+    put(row, "<Ok>", 7);
+    put(row, " ", 4);
+    put(row, "   ", 2);
+    CHECK(row.runs() == "2:2 7:4 4:1 2:3");
+    CHECK(row.text() == "  <Ok>");
+}
+
+TEST_CASE("screen dump: alternate character set becomes box drawing", "[screen_dump]") {
+    RowBuilder row;
+    put(row, "lqk", 3, true);
+    put(row, "x", 3, true);
+    put(row, "q", 3);                                  // not ACS: stays 'q'
+    CHECK(row.text() == "┌─┐│q");
+}
+
+TEST_CASE("screen dump: UTF-8, combining marks and wide characters", "[screen_dump]") {
+    RowBuilder row;
+    std::uint32_t e_acute[] = { 'e', 0x0301 };
+    row.cell(e_acute, 2, 2, false);
+    std::uint32_t wide = 0x4E2D;                       // 中, two columns
+    row.cell(&wide, 1, 2, false);
+    row.cell(nullptr, 0, 2, false);
+    std::uint32_t emoji = 0x1F600;
+    row.cell(&emoji, 1, 5, false);
+    CHECK(row.text() == "e\u0301\u4E2D\U0001F600");
+    CHECK(row.runs() == "2:3 5:1");
+}
@@ -0,0 +1,60 @@
+/**
+ * test_shm_counter.cpp
+ *
+ * Unit tests for newt_shm_counter.hpp — the shared done/total pair behind
+ * ScaleBindShm and the timer it is sampled on.
+ */
+
+#include "stubs/fixtures.hpp"
+#include "newt_shm_counter.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+TEST_CASE("shm counter: file is created and shared between mappings", "[shm_counter]") {
+    TempDir d;
+    std::string path = d.path + "/counter";
+    ShmCounter consumer, producer;
+    REQUIRE(consumer.open(path));
+    struct stat sb;
+    REQUIRE(::stat(path.c_str(), &sb) == 0);
+    CHECK(sb.st_size == static_cast<off_t>(ShmCounter::kSize));
+    CHECK(consumer.sample().done == 0);
+    CHECK(consumer.sample().total == 0);
+
+    REQUIRE(producer.open(path));
+    producer.store(250, 1000);
+    ShmCounter::Sample s = consumer.sample();
+    CHECK(s.done == 250);
+    CHECK(s.total == 1000);
+
+    CHECK_FALSE(consumer.open("/nonexistent/dir/counter"));
+    CHECK_FALSE(consumer.is_open());
+    CHECK(consumer.sample().total == 0);
+}
+
+TEST_CASE("shm counter: amount scales and clamps", "[shm_counter]") {
+    ShmCounter::Sample s;
+    CHECK(s.amount(100) == 0);                         // total unknown
+    s.total = 1000;
+    s.done  = 250;
+    CHECK(s.amount(100) == 25);
+    CHECK(s.amount(1000) == 250);
+    s.done = 5000;
+    CHECK(s.amount(100) == 100);                       // done past total
+    s.total = ~0ULL;
+    s.done  = ~0ULL / 2;
+    CHECK(s.amount(1000000) == 499999);                // no overflow
+}
+
+TEST_CASE("shm counter: sample timer fires periodically", "[shm_counter]") {
+    SampleTimer timer;
+    CHECK(timer.fd() < 0);
+    REQUIRE(timer.start(10));
+    REQUIRE(poll_readable(timer.fd(), 1000));
+    CHECK(timer.drain() >= 1);
+    CHECK(timer.drain() == 0);                         // nothing new yet
+    REQUIRE(poll_readable(timer.fd(), 1000));          // and again
+}
@@ -0,0 +1,92 @@
+/**
+ * test_symbols.cpp
+ *
+ * Unit tests for newt_symbols.hpp — the constant table, its perfect hash and
+ * the '|' expressions accepted by integer arguments.
+ */
+
+#include "stubs/bash_stubs.hpp"
+#include "stubs/newt_stubs.hpp"
+
+#include "newt_arg_parser.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+
+using newt_symbols::evaluate;
+using newt_symbols::find;
+
+static long long eval(const char* s) {
+    long long v = -12345;
+    REQUIRE(evaluate(s, v));
+    return v;
+}
+
+TEST_CASE("symbols: every table entry is found under its own spelling", "[symbols]") {
+    for (const auto& s : newt_symbols::kSymbols) {
+        const int* p = find(s.group, s.name);
+        REQUIRE(p);
+        CHECK(*p == s.value);
+    }
+}
+
+TEST_CASE("symbols: unknown names miss", "[symbols]") {
+    CHECK(find("FLAG", "SCROL") == nullptr);
+    CHECK(find("KEY", "SCROLL") == nullptr);
+    CHECK(find("", "") == nullptr);
+    CHECK(find("flag", "SCROLL") == nullptr);
+}
+
+TEST_CASE("symbols: bare names", "[symbols]") {
+    CHECK(eval("SCROLL") == NEWT_FLAG_SCROLL);
+    CHECK(eval("BORDER") == NEWT_FLAG_BORDER);     // FLAG wins over COLORSET
+    CHECK(eval("F12") == NEWT_KEY_F12);
+    CHECK(eval("APPEND") == NEWT_ARG_APPEND);
+    CHECK(eval("TOGGLE") == NEWT_FLAGS_TOGGLE);
+    long long v;
+    CHECK_FALSE(evaluate("LEFT", v));               // KEY and ANCHOR
+    CHECK(eval("SELECTED") == NEWT_FLAG_SELECTED);  // FLAG wins over CHECKBOXTREE
+    CHECK(eval("BUTTON") == NEWT_COLORSET_BUTTON);  // unique outside FLAG
+}
+
+TEST_CASE("symbols: grouped names", "[symbols]") {
+    CHECK(eval("KEY:F12") == NEWT_KEY_F12);
+    CHECK(eval("KEY:LEFT") == NEWT_KEY_LEFT);
+    CHECK(eval("ANCHOR:LEFT") == NEWT_ANCHOR_LEFT);
+    CHECK(eval("COLORSET:BORDER") == NEWT_COLORSET_BORDER);
+    CHECK(eval("CHECKBOXTREE:SELECTED") == '*');
+    CHECK(eval("GRID:SUBGRID") == NEWT_GRID_SUBGRID);
+}
+
+TEST_CASE("symbols: expressions", "[symbols]") {
+    CHECK(eval("SCROLL|WRAP") == (NEWT_FLAG_SCROLL | NEWT_FLAG_WRAP));
+    CHECK(eval(" 4 | RETURNEXIT ") == (4 | NEWT_FLAG_RETURNEXIT));
+    CHECK(eval("ANCHOR:LEFT|ANCHOR:TOP") == (NEWT_ANCHOR_LEFT | NEWT_ANCHOR_TOP));
+    CHECK(eval("-1") == -1);
+    CHECK(eval("0") == 0);
+
+    long long v = 7;
+    for (const char* bad : { "", " ", "SCROL", "A||B", "SCROLL|", "|SCROLL", "KEY:",
+                             ":F12", "KEY:F12:X", "1a", "scroll", "KEY :F12" })
+        CHECK_FALSE(evaluate(bad, v));
+    CHECK(v == 7);
+}
+
+TEST_CASE("symbols: from_string accepts symbols for ints and enums", "[symbols][from_string]") {
+    int i = 0;
+    REQUIRE(from_string("SCROLL|RETURNEXIT", i));
+    CHECK(i == (NEWT_FLAG_SCROLL | NEWT_FLAG_RETURNEXIT));
+    CHECK_FALSE(from_string("SCROL", i));
+
+    unsigned int u = 0;
+    REQUIRE(from_string("FD:READ|FD:WRITE", u));
+    CHECK(u == static_cast<unsigned int>(NEWT_FD_READ | NEWT_FD_WRITE));
+
+    enum newtFlagsSense sense = NEWT_FLAGS_SET;
+    REQUIRE(from_string("SENSE:TOGGLE", sense));
+    CHECK(sense == NEWT_FLAGS_TOGGLE);
+
+    enum newtGridElement el = NEWT_GRID_EMPTY;
+    REQUIRE(from_string("COMPONENT", el));
+    CHECK(el == NEWT_GRID_COMPONENT);
+}
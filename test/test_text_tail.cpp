@@ -0,0 +1,66 @@
+/**
+ * test_text_tail.cpp
+ *
+ * Unit tests for newt_text_tail.hpp — the bounded tail of command output
+ * shown by TextboxRunCommand.
+ */
+
+#include "newt_text_tail.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+
+static void feed(TextTail& t, const std::string& s) { t.append(s.data(), s.size()); }
+
+TEST_CASE("text tail: keeps the last lines, chunk boundaries do not matter", "[text_tail]") {
+    TextTail t(3, 80);
+    feed(t, "one\ntw");
+    feed(t, "o\nthree\n");
+    CHECK(t.text() == "one\ntwo\nthree");
+    feed(t, "fo");
+    CHECK(t.text() == "two\nthree\nfo");           // partial line counts
+    feed(t, "ur\nfive\n");
+    CHECK(t.text() == "three\nfour\nfive");
+
+    TextTail one(1, 80);
+    feed(one, "a\nb\nc");
+    CHECK(one.text() == "c");
+    feed(one, "\n");
+    CHECK(one.text() == "c");
+}
+
+TEST_CASE("text tail: carriage returns and escape sequences", "[text_tail]") {
+    TextTail t(5, 80);
+    feed(t, " 10%\r 55%\r");
+    feed(t, "100%\r\ndone\n");
+    CHECK(t.text() == "100%\ndone");
+
+    TextTail c(5, 80);
+    feed(c, "\x1b[1;31mred\x1b");
+    feed(c, "[0m plain\x1b]0;title\a\x1b(B ok\a\n");
+    CHECK(c.text() == "red plain ok");
+}
+
+TEST_CASE("text tail: long lines are clipped by characters", "[text_tail]") {
+    TextTail t(2, 4);
+    feed(t, "abcdefgh\n");
+    feed(t, "\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9\n");   // é × 5
+    CHECK(t.text() == "abcd\n\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9");
+}
+
+TEST_CASE("text tail: pages of the scrollback", "[text_tail]") {
+    TextTail t(100, 80);
+    feed(t, "1\n2\n3\n4\n5\n6");
+    CHECK(t.line_count() == 6);
+    CHECK(t.completed() == 5);
+    CHECK(t.lines(2) == "5\n6");                   // the bottom page
+    CHECK(t.lines(2, 1) == "4\n5");
+    CHECK(t.lines(2, 4) == "1\n2");
+    CHECK(t.lines(2, 99) == "1\n2");               // clamped to the top
+    CHECK(t.lines(10, 3) == t.text());              // everything fits
+
+    TextTail full(3, 80);
+    feed(full, "a\nb\nc\nd");
+    CHECK(full.line_count() == 3);
+    CHECK(full.lines(2, 1) == "b\nc");
+}
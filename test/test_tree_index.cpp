@@ -0,0 +1,92 @@
+/**
+ * test_tree_index.cpp
+ *
+ * Unit tests for TreeIndex (newt_tree_index.hpp) — the path / data-key index
+ * behind CheckboxTreeLoad.
+ */
+
+#include "newt_tree_index.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <vector>
+
+static std::vector<std::string> added_paths(const std::vector<TreeIndex::Added>& added) {
+    std::vector<std::string> p;
+    for (const auto& a : added) p.push_back(a.node->path);
+    return p;
+}
+
+TEST_CASE("TreeIndex: paths create missing ancestors once", "[TreeIndex]") {
+    TreeIndex t;
+    std::vector<TreeIndex::Added> added;
+    t.load_lines({ "usr/lib/a", "usr/lib/b", "usr/bin", "/etc//x/" }, "/", added);
+
+    CHECK(added_paths(added) == std::vector<std::string>{
+        "usr", "usr/lib", "usr/lib/a", "usr/lib/b", "usr/bin", "etc", "etc/x" });
+    CHECK(t.size() == 7);
+
+    const TreeIndex::Node* b = t.find(t.find_path("usr/lib/b"));
+    REQUIRE(b);
+    CHECK(b->text == "b");
+    CHECK(b->indexes == std::vector<int>{ 0, 0, 1 });
+    CHECK(t.find(t.find_path("usr/bin"))->indexes == std::vector<int>{ 0, 1 });
+    CHECK(t.find(t.find_path("etc/x"))->indexes == std::vector<int>{ 1, 0 });
+}
+
+TEST_CASE("TreeIndex: data keys are assigned in creation order", "[TreeIndex]") {
+    TreeIndex t;
+    std::vector<TreeIndex::Added> added;
+    t.load_lines({ "a/b", "c" }, "/", added);
+    CHECK(t.find_path("a")   == 1);
+    CHECK(t.find_path("a/b") == 2);
+    CHECK(t.find_path("c")   == 3);
+    CHECK(t.find_path("zzz") == 0);
+    CHECK(t.keys() == std::vector<std::uintptr_t>{ 1, 2, 3 });
+}
+
+TEST_CASE("TreeIndex: custom multi-character separator", "[TreeIndex]") {
+    TreeIndex t;
+    std::vector<TreeIndex::Added> added;
+    t.load_lines({ "net::http::client" }, "::", added);
+    CHECK(added_paths(added) == std::vector<std::string>{
+        "net", "net::http", "net::http::client" });
+}
+
+TEST_CASE("TreeIndex: indented outline", "[TreeIndex]") {
+    TreeIndex t;
+    std::vector<TreeIndex::Added> added;
+    t.load_lines({ "Colors", "  Red", "  Blue", "", "Numbers", "\t1", "\t\t1a  ", "  2" },
+                 "/", added);
+
+    CHECK(added_paths(added) == std::vector<std::string>{
+        "Colors", "Colors/Red", "Colors/Blue", "Numbers", "Numbers/1", "Numbers/1/1a",
+        "Numbers/2" });
+    CHECK(t.find(t.find_path("Numbers/1/1a"))->indexes == std::vector<int>{ 1, 0, 0 });
+    CHECK(t.find(t.find_path("Numbers/2"))->indexes == std::vector<int>{ 1, 1 });
+}
+
+TEST_CASE("TreeIndex: loading again merges into existing nodes", "[TreeIndex]") {
+    TreeIndex t;
+    std::vector<TreeIndex::Added> added;
+    t.load_lines({ "a/b" }, "/", added);
+    added.clear();
+    t.load_lines({ "a/b", "a/c" }, "/", added);
+    CHECK(added_paths(added) == std::vector<std::string>{ "a/c" });
+    CHECK(t.find(t.find_path("a/c"))->indexes == std::vector<int>{ 0, 1 });
+}
+
+TEST_CASE("TreeIndex: caller-chosen keys and index-path lookup", "[TreeIndex]") {
+    TreeIndex t;
+    std::uintptr_t colors = t.add(0, "Colors", "/", 100);
+    std::uintptr_t red    = t.add(colors, "Red", "/", 7);
+    std::uintptr_t next   = t.add(0, "Numbers", "/");
+
+    CHECK(red == 7);
+    CHECK(next == 101);                       // continues after the largest key
+    CHECK(t.find_indexes({ 0, 0 }) == 7);
+    CHECK(t.find_indexes({ 1 }) == 101);
+    CHECK(t.find_indexes({ 2 }) == 0);
+    CHECK(t.find(7)->path == "Colors/Red");
+    CHECK(t.keys() == std::vector<std::uintptr_t>{ 100, 7, 101 });
+}
@@ -0,0 +1,97 @@
+/**
+ * test_virtual_listbox.cpp
+ *
+ * Unit tests for the header-only pieces behind VirtualListbox:
+ *   • RowStore (newt_row_store.hpp) — arena + offset row storage.
+ *   • newt_virtual_listbox window arithmetic (newt_virtual_listbox.hpp).
+ *
+ * The libnewt glue in newt_wrappers.cpp is exercised by the functional tests.
+ */
+
+#include "newt_row_store.hpp"
+#include "newt_virtual_listbox.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+
+namespace vl = newt_virtual_listbox;
+
+// ─── RowStore ─────────────────────────────────────────────────────────────────
+
+TEST_CASE("RowStore: push_back stores NUL-terminated rows", "[RowStore]") {
+    RowStore rs;
+    rs.push_back("alpha");
+    rs.push_back("");
+    rs.push_back("gamma", 3);
+
+    REQUIRE(rs.size() == 3);
+    CHECK(std::string(rs[0]) == "alpha");
+    CHECK(std::string(rs[1]) == "");
+    CHECK(std::string(rs[2]) == "gam");
+    CHECK(rs.length(0) == 5);
+    CHECK(rs.length(1) == 0);
+    CHECK(rs.length(2) == 3);
+}
+
+TEST_CASE("RowStore: assign_lines splits on newlines", "[RowStore]") {
+    RowStore rs;
+    rs.assign_lines("one\ntwo\n\nfour\n");
+
+    REQUIRE(rs.size() == 4);
+    CHECK(std::string(rs[0]) == "one");
+    CHECK(std::string(rs[1]) == "two");
+    CHECK(std::string(rs[2]) == "");
+    CHECK(std::string(rs[3]) == "four");
+    CHECK(rs.length(3) == 4);
+}
+
+TEST_CASE("RowStore: assign_lines without trailing newline", "[RowStore]") {
+    RowStore rs;
+    rs.assign_lines("a\nbc");
+    REQUIRE(rs.size() == 2);
+    CHECK(std::string(rs[1]) == "bc");
+}
+
+TEST_CASE("RowStore: assign_lines on empty text → no rows", "[RowStore]") {
+    RowStore rs;
+    rs.push_back("stale");
+    rs.assign_lines("");
+    CHECK(rs.empty());
+}
+
+// ─── window arithmetic ────────────────────────────────────────────────────────
+
+TEST_CASE("window_size: at least 64 rows, otherwise four pages", "[VirtualListbox]") {
+    CHECK(vl::window_size(5)  == 64);
+    CHECK(vl::window_size(20) == 80);
+    CHECK(vl::window_size(0)  == 64);
+}
+
+TEST_CASE("centre_on: small data set fits entirely", "[VirtualListbox]") {
+    vl::Window w = vl::centre_on(3, 10, 64);
+    CHECK(w.base == 0);
+    CHECK(w.count == 10);
+}
+
+TEST_CASE("centre_on: cursor is centred and clamped to the ends", "[VirtualListbox]") {
+    CHECK(vl::centre_on(0,      1000000, 64).base == 0);
+    CHECK(vl::centre_on(500000, 1000000, 64).base == 500000 - 32);
+    vl::Window end = vl::centre_on(999999, 1000000, 64);
+    CHECK(end.base == 1000000 - 64);
+    CHECK(end.count == 64);
+}
+
+TEST_CASE("needs_refill: only near an edge with more data beyond", "[VirtualListbox]") {
+    vl::Window w{100, 64};   // rows [100, 164)
+    const std::size_t total = 1000, margin = 10;
+
+    CHECK_FALSE(vl::needs_refill(w, 132, total, margin));
+    CHECK(vl::needs_refill(w, 105, total, margin));
+    CHECK(vl::needs_refill(w, 160, total, margin));
+
+    vl::Window head{0, 64};
+    CHECK_FALSE(vl::needs_refill(head, 2, total, margin));   // nothing above
+
+    vl::Window tail{936, 64};
+    CHECK_FALSE(vl::needs_refill(tail, 998, total, margin)); // nothing below
+}
@@ -0,0 +1,83 @@
+#!/usr/bin/env python3
+"""
+Measure how long a fresh bash takes from `enable -f newt.so newt` to the end
+of its first `newt Init` — the fixed cost every short-lived dialog script
+(whiptail.sh, examples/whiptail_*.sh) pays before drawing anything.
+
+Each run is a new `bash --norc` in a pty, timed from inside with
+$EPOCHREALTIME so process start-up is not counted.  The script touches no
+NEWT_* array, like most dialogs; pass --constants to also reference one
+entry of each array after Init and see what populating them costs.
+
+Usage (from the repo root, after `cmake --build build`):
+    cd functional_test && uv run python ../utils/bench_startup.py [-n 200]
+                                                                   [--so PATH]
+                                                                   [--constants]
+"""
+
+import argparse
+import pathlib
+import statistics
+import sys
+
+import pexpect
+
+ARRAYS = ["COLORSET", "FLAG", "FD", "ARG", "CHECKBOXTREE", "KEY", "ANCHOR", "GRID_FLAG"]
+
+
+def script(so: str, constants: bool) -> str:
+    touch = ""
+    if constants:
+        touch = "; : " + " ".join(f'"${{NEWT_{a}[X]}}"' for a in ARRAYS)
+    return (
+        "t0=$EPOCHREALTIME; "
+        f"enable -f '{so}' newt; t1=$EPOCHREALTIME; "
+        "newt Init; t2=$EPOCHREALTIME"
+        f"{touch}; t3=$EPOCHREALTIME; "
+        "newt Finished; "
+        'echo "BENCH $t0 $t1 $t2 $t3"'
+    )
+
+
+def run_once(so: str, constants: bool) -> tuple[float, float, float]:
+    """Return (enable, Init, constants) durations in microseconds."""
+    child = pexpect.spawn(
+        "bash", ["--norc", "--noprofile", "-c", script(so, constants)],
+        dimensions=(24, 80),
+    )
+    child.expect(rb"BENCH ([\d.,]+) ([\d.,]+) ([\d.,]+) ([\d.,]+)", timeout=10)
+    t = [float(x.replace(b",", b".")) for x in child.match.groups()]
+    child.close()
+    return ((t[1] - t[0]) * 1e6, (t[2] - t[1]) * 1e6, (t[3] - t[2]) * 1e6)
+
+
+def main() -> int:
+    root = pathlib.Path(__file__).resolve().parent.parent
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[1])
+    ap.add_argument("-n", type=int, default=100, help="number of runs")
+    ap.add_argument("--so", default=str(root / "build" / "src" / "newt.so"))
+    ap.add_argument("--constants", action="store_true",
+                    help="also reference every NEWT_* array after Init")
+    args = ap.parse_args()
+
+    if not pathlib.Path(args.so).exists():
+        print(f"{args.so}: not found (build first)", file=sys.stderr)
+        return 1
+
+    runs = [run_once(args.so, args.constants) for _ in range(args.n)]
+    columns = ["enable", "Init", "enable+Init"]
+    samples = [[r[0] for r in runs], [r[1] for r in runs], [r[0] + r[1] for r in runs]]
+    if args.constants:
+        columns.append("arrays")
+        samples.append([r[2] for r in runs])
+
+    print(f"{args.n} runs, microseconds")
+    print(f"{'':>12} {'median':>10} {'mean':>10} {'min':>10} {'max':>10}")
+    for name, xs in zip(columns, samples):
+        print(f"{name:>12} {statistics.median(xs):10.0f} {statistics.fmean(xs):10.0f}"
+              f" {min(xs):10.0f} {max(xs):10.0f}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -409,8 +409,11 @@ _whiptail_textbox() {
         echo >&2 "whiptail.sh: cannot read file: $file"
         return 255
     fi
+    # Only the first screenful is needed for autosizing; the file itself is
+    # mmap'd by TextboxLoadFile and never passes through bash.
+    newt GetScreenSize _wt_scr_cols _wt_scr_rows
     local text
-    text=$(<"$file")
+    text=$(head -n "$_wt_scr_rows" -- "$file")
 
     _whiptail_autosize "$text" height width
 
@@ -425,7 +428,6 @@ _whiptail_textbox() {
     (( text_h < 1 )) && text_h=1
     local tflags=$(( FLAG_WRAP | FLAG_SCROLL ))
     newt -v _wt_tb Textbox 1 1 $(( iw - 2 )) "$text_h" "$tflags"
-    newt TextboxSetText "$_wt_tb" "$text"
 
     local ok_text="${_whiptail_ok_button:-Ok}"
     local ok_left=$(( (iw - ${#ok_text} - 4) / 2 ))
@@ -434,6 +436,7 @@ _whiptail_textbox() {
 
     newt -v _wt_form Form "" "" 0
     newt FormAddComponents "$_wt_form" "$_wt_tb" "$_wt_ok"
+    newt TextboxLoadFile "$_wt_tb" "$file" "$_wt_form"
 
     newt -v _wt_answer RunForm "$_wt_form"
     local rc=0